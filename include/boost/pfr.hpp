@@ -8,6 +8,9 @@
 
 /// \file boost/pfr.hpp
 /// Includes all the Boost.PFR headers, except \xmlonly<link linkend='header.boost.pfr.flat.global_ops_hpp'>boost/pfr/flat/global_ops.hpp</link>\endxmlonly and \xmlonly<link linkend='header.boost.pfr.precise.global_ops_hpp'>boost/pfr/precise/global_ops.hpp</link>\endxmlonly
+///
+/// Containers, algorithms, file formats and profiling reports (for example `boost/pfr/field_profile.hpp`) are not included
+/// to keep the compile times low, include their headers directly.
 
 #include <boost/pfr/precise.hpp>
 #include <boost/pfr/flat.hpp>
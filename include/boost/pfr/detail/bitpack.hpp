@@ -0,0 +1,198 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_BITPACK_HPP
+#define BOOST_PFR_DETAIL_BITPACK_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#endif
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Bit packing of blocks of 256 unsigned values
+//
+// Values of a block are split into 4 lanes, value `i` goes to the lane `i % 4` at the position `i / 4`. Each lane is a
+// sequence of `bits` bit values packed into words `lane, lane + 4, lane + 8...`, so a block of `bits` bit values takes
+// exactly `4 * bits` words and one 256 bit vector register holds the same bits of all the 4 lanes. Unpacking of the
+// position `j` of all the lanes is a couple of vector shifts, results come out in the original order of the values.
+constexpr std::size_t bitpack_block_size = 256;
+constexpr std::size_t bitpack_lanes = 4;
+
+inline std::uint64_t bitpack_mask(unsigned bits) noexcept {
+    return bits >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+}
+
+/// \return count of bits required to store `x`.
+inline unsigned bit_width(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return x ? 64u - static_cast<unsigned>(__builtin_clzll(x)) : 0u;
+#else
+    unsigned result = 0;
+    for (; x; x >>= 1) {
+        ++result;
+    }
+    return result;
+#endif
+}
+
+inline unsigned popcount(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+    unsigned result = 0;
+    for (; x; x &= x - 1) {
+        ++result;
+    }
+    return result;
+#endif
+}
+
+/// Packs 256 `values` that fit into `bits` bits into `4 * bits` words of `out`.
+inline void bitpack_block(const std::uint64_t* values, unsigned bits, std::uint64_t* out) noexcept {
+    if (bits == 0) {
+        return;
+    }
+    std::memset(out, 0, bitpack_lanes * bits * sizeof(std::uint64_t));
+
+    for (unsigned j = 0; j < bitpack_block_size / bitpack_lanes; ++j) {
+        const unsigned bit = j * bits;
+        const unsigned k = bit / 64;
+        const unsigned shift = bit % 64;
+#if defined(__AVX2__)
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + bitpack_lanes * j));
+        __m256i* const low = reinterpret_cast<__m256i*>(out + bitpack_lanes * k);
+        _mm256_storeu_si256(low, _mm256_or_si256(_mm256_loadu_si256(low), _mm256_sll_epi64(v, _mm_cvtsi32_si128(static_cast<int>(shift)))));
+        if (shift + bits > 64) {
+            __m256i* const high = low + 1;
+            _mm256_storeu_si256(high, _mm256_srl_epi64(v, _mm_cvtsi32_si128(static_cast<int>(64 - shift))));
+        }
+#else
+        for (unsigned lane = 0; lane < bitpack_lanes; ++lane) {
+            const std::uint64_t v = values[bitpack_lanes * j + lane];
+            out[bitpack_lanes * k + lane] |= v << shift;
+            if (shift + bits > 64) {
+                out[bitpack_lanes * (k + 1) + lane] = v >> (64 - shift);
+            }
+        }
+#endif
+    }
+}
+
+/// Unpacks 256 `bits` bit values from `4 * bits` words of `in`.
+inline void bitunpack_block(const std::uint64_t* in, unsigned bits, std::uint64_t* values) noexcept {
+    if (bits == 0) {
+        std::memset(values, 0, bitpack_block_size * sizeof(std::uint64_t));
+        return;
+    }
+
+#if defined(__AVX2__)
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(detail::bitpack_mask(bits)));
+#else
+    const std::uint64_t mask = detail::bitpack_mask(bits);
+#endif
+    for (unsigned j = 0; j < bitpack_block_size / bitpack_lanes; ++j) {
+        const unsigned bit = j * bits;
+        const unsigned k = bit / 64;
+        const unsigned shift = bit % 64;
+#if defined(__AVX2__)
+        const __m256i* const low = reinterpret_cast<const __m256i*>(in + bitpack_lanes * k);
+        __m256i v = _mm256_srl_epi64(_mm256_loadu_si256(low), _mm_cvtsi32_si128(static_cast<int>(shift)));
+        if (shift + bits > 64) {
+            v = _mm256_or_si256(v, _mm256_sll_epi64(_mm256_loadu_si256(low + 1), _mm_cvtsi32_si128(static_cast<int>(64 - shift))));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + bitpack_lanes * j), _mm256_and_si256(v, mask));
+#else
+        for (unsigned lane = 0; lane < bitpack_lanes; ++lane) {
+            std::uint64_t v = in[bitpack_lanes * k + lane] >> shift;
+            if (shift + bits > 64) {
+                v |= in[bitpack_lanes * (k + 1) + lane] << (64 - shift);
+            }
+            values[bitpack_lanes * j + lane] = v & mask;
+        }
+#endif
+    }
+}
+
+/// \return value with index `i` from the `bits` bit block `in`.
+inline std::uint64_t bitunpack_one(const std::uint64_t* in, unsigned bits, std::size_t i) noexcept {
+    if (bits == 0) {
+        return 0;
+    }
+
+    const std::size_t lane = i % bitpack_lanes;
+    const std::size_t bit = (i / bitpack_lanes) * bits;
+    const std::size_t k = bit / 64;
+    const unsigned shift = static_cast<unsigned>(bit % 64);
+    std::uint64_t v = in[bitpack_lanes * k + lane] >> shift;
+    if (shift + bits > 64) {
+        v |= in[bitpack_lanes * (k + 1) + lane] << (64 - shift);
+    }
+    return v & detail::bitpack_mask(bits);
+}
+
+/// Sets the bit `i` of `matches` if `low <= value_i <= high` for the values of the `bits` bit block `in`. Values are
+/// compared without unpacking the block into memory.
+inline void bitpacked_match_block(const std::uint64_t* in, unsigned bits, std::uint64_t low, std::uint64_t high, std::uint64_t (&matches)[4]) noexcept {
+#if defined(__AVX2__)
+    if (bits > 0 && bits < 64) {
+        // Values are less than 2^63, signed comparisons are correct if `low` and `high` are clamped to the same range
+        const std::uint64_t max = detail::bitpack_mask(bits);
+        const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(max));
+        const __m256i lo = _mm256_set1_epi64x(static_cast<long long>(low < max ? low : max));
+        const __m256i hi = _mm256_set1_epi64x(static_cast<long long>(high < max ? high : max));
+        const bool low_above = low > max;
+
+        matches[0] = matches[1] = matches[2] = matches[3] = 0;
+        if (low_above) {
+            return;
+        }
+        for (unsigned j = 0; j < bitpack_block_size / bitpack_lanes; ++j) {
+            const unsigned bit = j * bits;
+            const unsigned k = bit / 64;
+            const unsigned shift = bit % 64;
+            const __m256i* const words = reinterpret_cast<const __m256i*>(in + bitpack_lanes * k);
+            __m256i v = _mm256_srl_epi64(_mm256_loadu_si256(words), _mm_cvtsi32_si128(static_cast<int>(shift)));
+            if (shift + bits > 64) {
+                v = _mm256_or_si256(v, _mm256_sll_epi64(_mm256_loadu_si256(words + 1), _mm_cvtsi32_si128(static_cast<int>(64 - shift))));
+            }
+            v = _mm256_and_si256(v, mask);
+
+            const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(lo, v), _mm256_cmpgt_epi64(v, hi));
+            const std::uint64_t inside = static_cast<unsigned>(~_mm256_movemask_pd(_mm256_castsi256_pd(outside))) & 0xFu;
+            matches[j / 16] |= inside << ((j % 16) * bitpack_lanes);
+        }
+        return;
+    }
+#endif
+
+    std::uint64_t values[bitpack_block_size];
+    detail::bitunpack_block(in, bits, values);
+    if (low > high) {
+        matches[0] = matches[1] = matches[2] = matches[3] = 0;
+        return;
+    }
+
+    // Single unsigned comparison per value: values below `low` wrap around to huge differences
+    const std::uint64_t range = high - low;
+    for (std::size_t w = 0; w < 4; ++w) {
+        std::uint64_t m = 0;
+        for (std::size_t i = 0; i < 64; ++i) {
+            m |= static_cast<std::uint64_t>(values[w * 64 + i] - low <= range) << i;
+        }
+        matches[w] = m;
+    }
+}
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_BITPACK_HPP
@@ -31,4 +31,16 @@
 #   endif
 #endif
 
+#ifndef BOOST_PFR_USE_CONCEPTS
+#   if defined(__cpp_concepts) && __cpp_concepts >= 201907L && defined(__cpp_if_constexpr)
+#       define BOOST_PFR_USE_CONCEPTS 1
+#   else
+#       define BOOST_PFR_USE_CONCEPTS 0
+#   endif
+#endif
+
+#ifndef BOOST_PFR_FIELD_PROFILE
+#   define BOOST_PFR_FIELD_PROFILE 0
+#endif
+
 #endif // BOOST_PFR_DETAIL_CONFIG_HPP
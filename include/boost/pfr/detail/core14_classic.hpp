@@ -15,6 +15,7 @@
 #include <boost/pfr/detail/sequence_tuple.hpp>
 #include <boost/pfr/detail/offset_based_getter.hpp>
 #include <boost/pfr/detail/fields_count.hpp>
+#include <boost/pfr/detail/reflection_info.hpp>
 #include <boost/pfr/detail/make_flat_tuple_of_references.hpp>
 #include <boost/pfr/detail/size_array.hpp>
 
@@ -30,10 +31,6 @@ namespace boost { namespace pfr { namespace detail {
 
 ///////////////////// General utility stuff
 
-template <class T> struct identity{
-    typedef T type;
-};
-
 template <class T>
 constexpr T construct_helper() noexcept { // adding const here allows to deal with copyable only types
     return {};
@@ -42,6 +39,9 @@ constexpr T construct_helper() noexcept { // adding const here allows to deal wi
 template <class T> constexpr size_array<sizeof(T) * 3> fields_count_and_type_ids_with_zeros() noexcept;
 template <class T> constexpr auto flat_array_of_type_ids() noexcept;
 
+///////////////////// Memoized result of `flat_array_of_type_ids<T>()`, so that the array is built only once per T
+template <class T> constexpr auto flat_array_of_type_ids_v = flat_array_of_type_ids<T>();
+
 ///////////////////// All the stuff for representing Type as integer and converting integer back to type
 namespace typeid_conversions {
 
@@ -105,6 +105,13 @@ template <class Type> constexpr std::size_t type_to_id(identity<const Type*>) no
 template <class Type> constexpr std::size_t type_to_id(identity<const volatile Type*>) noexcept;
 template <class Type> constexpr std::size_t type_to_id(identity<volatile Type*>) noexcept;
 template <class Type> constexpr std::size_t type_to_id(identity<Type&>) noexcept;
+template <class Type> constexpr size_array<sizeof(Type) * 3> type_to_id_of_aggregate() noexcept;
+
+#if BOOST_PFR_USE_CONCEPTS
+template <class Type> constexpr auto type_to_id(identity<Type>) noexcept;
+
+template <std::size_t Index> constexpr auto id_to_type(size_t_<Index >) noexcept;
+#else
 template <class Type> constexpr std::size_t type_to_id(identity<Type>, std::enable_if_t<std::is_enum<Type>::value>* = 0) noexcept;
 template <class Type> constexpr std::size_t type_to_id(identity<Type>, std::enable_if_t<std::is_empty<Type>::value>* = 0) noexcept;
 template <class Type> constexpr size_array<sizeof(Type) * 3> type_to_id(identity<Type>, std::enable_if_t<!std::is_enum<Type>::value && !std::is_empty<Type>::value>* = 0) noexcept;
@@ -114,6 +121,7 @@ template <std::size_t Index> constexpr auto id_to_type(size_t_<Index >, if_exten
 template <std::size_t Index> constexpr auto id_to_type(size_t_<Index >, if_extension<Index, native_const_volatile_ptr_type> = 0) noexcept;
 template <std::size_t Index> constexpr auto id_to_type(size_t_<Index >, if_extension<Index, native_volatile_ptr_type> = 0) noexcept;
 template <std::size_t Index> constexpr auto id_to_type(size_t_<Index >, if_extension<Index, native_ref_type> = 0) noexcept;
+#endif
 
 
 ///////////////////// Definitions of type_to_id and id_to_type for fundamental types
@@ -210,19 +218,8 @@ constexpr std::size_t type_to_id(identity<Type&>) noexcept {
 }
 
 template <class Type>
-constexpr std::size_t type_to_id(identity<Type>, std::enable_if_t<std::is_enum<Type>::value>*) noexcept {
-    return type_to_id(identity<typename std::underlying_type<Type>::type >{});
-}
-
-template <class Type>
-constexpr std::size_t type_to_id(identity<Type>, std::enable_if_t<std::is_empty<Type>::value>*) noexcept {
-    static_assert(!std::is_empty<Type>::value, "Empty classes/structures as members are not supported.");
-    return 0;
-}
-
-template <class Type>
-constexpr size_array<sizeof(Type) * 3> type_to_id(identity<Type>, std::enable_if_t<!std::is_enum<Type>::value && !std::is_empty<Type>::value>*) noexcept {
-    constexpr auto t = flat_array_of_type_ids<Type>();
+constexpr size_array<sizeof(Type) * 3> type_to_id_of_aggregate() noexcept {
+    constexpr auto t = flat_array_of_type_ids_v<Type>;
     size_array<sizeof(Type) * 3> result {{tuple_begin_tag}};
     constexpr bool requires_tuplening = (
         (t.count_nonzeros() != 1)  || (t.count_nonzeros() == t.count_from_opening_till_matching_parenthis_seq(0, tuple_begin_tag, tuple_end_tag))
@@ -239,7 +236,59 @@ constexpr size_array<sizeof(Type) * 3> type_to_id(identity<Type>, std::enable_if
     return result;
 }
 
+#if BOOST_PFR_USE_CONCEPTS
+
+// Single function with `if constexpr` instead of the SFINAE overloads, to make overload resolution cheaper
+template <class Type>
+constexpr auto type_to_id(identity<Type>) noexcept {
+    if constexpr (std::is_enum<Type>::value) {
+        return type_to_id(identity<typename std::underlying_type<Type>::type >{});
+    } else if constexpr (std::is_empty<Type>::value) {
+        static_assert(!std::is_empty<Type>::value, "Empty classes/structures as members are not supported.");
+        return std::size_t{0};
+    } else {
+        return typeid_conversions::type_to_id_of_aggregate<Type>();
+    }
+}
+
+template <std::size_t Index>
+constexpr auto id_to_type(size_t_<Index >) noexcept {
+    constexpr std::size_t extension = (Index & extension_maks);
+    if constexpr (extension == native_ptr_type) {
+        typedef decltype( id_to_type(remove_1_ext<Index>()) )* res_t;
+        return construct_helper<res_t>();
+    } else if constexpr (extension == native_const_ptr_type) {
+        typedef const decltype( id_to_type(remove_1_ext<Index>()) )* res_t;
+        return construct_helper<res_t>();
+    } else if constexpr (extension == native_const_volatile_ptr_type) {
+        typedef const volatile decltype( id_to_type(remove_1_ext<Index>()) )* res_t;
+        return construct_helper<res_t>();
+    } else if constexpr (extension == native_volatile_ptr_type) {
+        typedef volatile decltype( id_to_type(remove_1_ext<Index>()) )* res_t;
+        return construct_helper<res_t>();
+    } else {
+        static_assert(!Index, "References are not supported");
+        return nullptr;
+    }
+}
+
+#else
 
+template <class Type>
+constexpr std::size_t type_to_id(identity<Type>, std::enable_if_t<std::is_enum<Type>::value>*) noexcept {
+    return type_to_id(identity<typename std::underlying_type<Type>::type >{});
+}
+
+template <class Type>
+constexpr std::size_t type_to_id(identity<Type>, std::enable_if_t<std::is_empty<Type>::value>*) noexcept {
+    static_assert(!std::is_empty<Type>::value, "Empty classes/structures as members are not supported.");
+    return 0;
+}
+
+template <class Type>
+constexpr size_array<sizeof(Type) * 3> type_to_id(identity<Type>, std::enable_if_t<!std::is_enum<Type>::value && !std::is_empty<Type>::value>*) noexcept {
+    return typeid_conversions::type_to_id_of_aggregate<Type>();
+}
 
 template <std::size_t Index>
 constexpr auto id_to_type(size_t_<Index >, if_extension<Index, native_ptr_type>) noexcept {
@@ -273,6 +322,8 @@ constexpr auto id_to_type(size_t_<Index >, if_extension<Index, native_ref_type>)
     return nullptr;
 }
 
+#endif // #if BOOST_PFR_USE_CONCEPTS
+
 } // namespace typeid_conversions
 
 ///////////////////// Structure that remembers types as integers on a `constexpr operator Type()` call
@@ -345,7 +396,7 @@ constexpr auto flat_type_to_array_of_type_ids(std::size_t* types, std::index_seq
 template <class T>
 constexpr size_array<sizeof(T) * 3> fields_count_and_type_ids_with_zeros() noexcept {
     size_array<sizeof(T) * 3> types{};
-    constexpr std::size_t N = fields_count<T>();
+    constexpr std::size_t N = reflection_info<T>.fields_count;
     flat_type_to_array_of_type_ids<T, N>(types.data, std::make_index_sequence<N>());
     return types;
 }
@@ -432,7 +483,7 @@ constexpr size_array<N> resize_dropping_zeros_and_decrementing(size_t_<N>, const
 
 template <class T, std::size_t First, std::size_t... I, std::size_t... INew>
 constexpr auto as_flat_tuple_impl_drop_helpers(std::index_sequence<First, I...>, std::index_sequence<INew...>) noexcept {
-    constexpr auto a = flat_array_of_type_ids<T>();
+    constexpr auto a = flat_array_of_type_ids_v<T>;
 
     constexpr size_array<sizeof...(I) + 1> subtuples_length {{
         a.count_from_opening_till_matching_parenthis_seq(First, typeid_conversions::tuple_begin_tag, typeid_conversions::tuple_end_tag),
@@ -471,7 +522,7 @@ constexpr std::size_t count_skips_in_array(std::size_t begin_index, std::size_t
 
 template <class T, std::size_t First, std::size_t... I>
 constexpr auto as_flat_tuple_impl(std::index_sequence<First, I...>) noexcept {
-    constexpr auto a = flat_array_of_type_ids<T>();
+    constexpr auto a = flat_array_of_type_ids_v<T>;
     constexpr std::size_t count_of_I = sizeof...(I);
 
     return as_flat_tuple_impl_drop_helpers<T>(
@@ -487,7 +538,7 @@ constexpr auto internal_tuple_with_same_alignment() noexcept {
     static_assert(std::is_pod<type>::value, "Type can not be used is flat_ functions, because it's not POD");
     static_assert(!std::is_reference<type>::value, "Not applyable");
     constexpr auto res = as_flat_tuple_impl<type>(
-        std::make_index_sequence< decltype(flat_array_of_type_ids<type>())::size() >()
+        std::make_index_sequence< decltype(flat_array_of_type_ids_v<type>)::size() >()
     );
 
     return res;
@@ -539,13 +590,22 @@ auto tie_as_flat_tuple(T&& t) noexcept {
     return boost::pfr::detail::make_flat_tuple_of_references(val, getter, size_t_<0>{}, size_t_<tuple_type::size_v>{});
 }
 
+///////////////////// Hooks for reflection_info<T>
+template <class T>
+auto reflect_flat_tuple(identity<T>) noexcept -> decltype( boost::pfr::detail::tie_as_flat_tuple(std::declval<T&>()) );
+
+template <class T>
+constexpr bool reflect_is_flat_reflectable(identity<T>) noexcept {
+    return boost::pfr::detail::is_flat_refelectable<T>( std::make_index_sequence<reflection_info<T>.fields_count>{} );
+}
+
 #if !BOOST_PFR_USE_CPP17
 
 template <class T>
 auto tie_as_tuple(T& val) noexcept {
     typedef T type;
     static_assert(
-        boost::pfr::detail::is_flat_refelectable<type>( std::make_index_sequence<fields_count<type>()>{} ),
+        reflection_info<type>.is_flat_reflectable,
         "Not possible in C++14 to represent that type without loosing information. Use boost::pfr::flat_ version, or change type definition, or enable C++17"
     );
     return boost::pfr::detail::tie_as_flat_tuple(val);
@@ -556,12 +616,15 @@ template <class T>
 auto tie_as_tuple(const T& val) noexcept {
     typedef T type;
     static_assert(
-        boost::pfr::detail::is_flat_refelectable<type>( std::make_index_sequence<fields_count<type>()>{} ),
+        reflection_info<type>.is_flat_reflectable,
         "Not possible in C++14 to represent that type without loosing information. Use boost::pfr::flat_ version, or change type definition, or enable C++17"
     );
     return boost::pfr::detail::tie_as_flat_tuple(val);
 }
 
+template <class T>
+auto reflect_tuple(identity<T>) noexcept -> decltype( boost::pfr::detail::tie_as_tuple(std::declval<T&>()) );
+
 #endif // #if !BOOST_PFR_USE_CPP17
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -675,12 +738,11 @@ void for_each_field_dispatcher(T&& t, F&& f, std::index_sequence<I...>) {
 
     //static_assert(is_constexpr_aggregate_initializable<type, I...>::value, "T must be a constexpr initializable type");
 
-    constexpr bool is_flat_refelectable_val = is_flat_refelectable<type>( std::index_sequence<I...>{} );
     for_each_field_dispatcher_1(
         std::forward<T>(t),
         std::forward<F>(f),
         std::index_sequence<I...>{},
-        std::integral_constant<bool, is_flat_refelectable_val>{}
+        std::integral_constant<bool, reflection_info<std::remove_cv_t<type>>.is_flat_reflectable>{}
     );
 }
 
@@ -28,6 +28,7 @@
 #include <boost/pfr/detail/cast_to_layout_compatible.hpp> // still needed for enums
 #include <boost/pfr/detail/offset_based_getter.hpp>
 #include <boost/pfr/detail/fields_count.hpp>
+#include <boost/pfr/detail/reflection_info.hpp>
 #include <boost/pfr/detail/make_flat_tuple_of_references.hpp>
 #include <boost/pfr/detail/sequence_tuple.hpp>
 
@@ -96,7 +97,7 @@ struct loophole_type_list< T, std::index_sequence<I...> >
 template <class T>
 auto tie_as_tuple_loophole_impl(T&& val) noexcept {
     using type = std::remove_cv_t<std::remove_reference_t<T>>;
-    using indexes = std::make_index_sequence<fields_count<type>()>;
+    using indexes = std::make_index_sequence<reflection_info<type>.fields_count>;
     using tuple_type = typename loophole_type_list<type, indexes>::type;
 
     return boost::pfr::detail::make_flat_tuple_of_references(
@@ -174,6 +175,10 @@ auto tie_as_flat_tuple(T&& t) {
     );
 }
 
+///////////////////// Hooks for reflection_info<T>
+template <class T>
+auto reflect_flat_tuple(identity<T>) noexcept -> decltype( boost::pfr::detail::tie_as_flat_tuple(std::declval<T&>()) );
+
 
 #if !BOOST_PFR_USE_CPP17
 template <class T>
@@ -183,6 +188,9 @@ auto tie_as_tuple(T&& val) noexcept {
     );
 }
 
+template <class T>
+auto reflect_tuple(identity<T>) noexcept -> decltype( boost::pfr::detail::tie_as_tuple(std::declval<T&>()) );
+
 template <class T, class F, std::size_t... I>
 void for_each_field_dispatcher(T&& t, F&& f, std::index_sequence<I...>) {
     std::forward<F>(f)(
@@ -20,6 +20,7 @@
 
 #include <boost/pfr/detail/sequence_tuple.hpp>
 #include <boost/pfr/detail/fields_count.hpp>
+#include <boost/pfr/detail/reflection_info.hpp>
 
 namespace boost { namespace pfr { namespace detail {
 
@@ -1028,16 +1029,20 @@ constexpr auto tie_as_tuple(T&& val, size_t_<100>) noexcept {
 
 template <class T>
 constexpr auto tie_as_tuple(const T& val) noexcept {
-  typedef size_t_<fields_count<T>()> fields_count_tag;
+  typedef size_t_<reflection_info<T>.fields_count> fields_count_tag;
   return boost::pfr::detail::tie_as_tuple(val, fields_count_tag{});
 }
 
 template <class T>
 constexpr auto tie_as_tuple(T& val) noexcept {
-  typedef size_t_<fields_count<T>()> fields_count_tag;
+  typedef size_t_<reflection_info<T>.fields_count> fields_count_tag;
   return boost::pfr::detail::tie_as_tuple(val, fields_count_tag{});
 }
 
+///////////////////// Hook for reflection_info<T>
+template <class T>
+auto reflect_tuple(identity<T>) noexcept -> decltype( boost::pfr::detail::tie_as_tuple(std::declval<T&>()) );
+
 }}} // namespace boost::pfr::detail
 
 #endif // BOOST_PFR_DETAIL_CORE17_GENERATED_HPP
@@ -11,6 +11,12 @@
 
 namespace boost { namespace pfr { namespace detail {
 ///////////////////// `value` is true if Detector<Tleft, Tright> does not compile (SFINAE)
+#if BOOST_PFR_USE_CONCEPTS
+    template <template <class, class> class Detector, class Tleft, class Tright>
+    struct not_appliable {
+        static constexpr bool value = !requires { typename Detector<Tleft, Tright>; };
+    };
+#else
     template <template <class, class> class Detector, class Tleft, class Tright>
     struct not_appliable {
         struct success{};
@@ -22,6 +28,7 @@ namespace boost { namespace pfr { namespace detail {
             success
         >::value;
     };
+#endif
 
 ///////////////////// Detectors for different operators
     template <class T1, class T2> using comp_eq_detector = decltype(std::declval<T1>() == std::declval<T2>());
@@ -0,0 +1,229 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_EPOCH_HPP
+#define BOOST_PFR_DETAIL_EPOCH_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/prefetch.hpp>
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Epoch based memory reclamation
+//
+// Readers pin the current global epoch for the duration of a lock-free traversal. Writers unlink objects and retire them
+// with the epoch that was current after the unlink. The global epoch advances only when every pinned reader has seen
+// the current epoch, so when it is two epochs ahead of the retirement no reader could still reference the object.
+//
+// Retired objects are kept in the slot of the retiring thread, so writers do not synchronize with each other on
+// retirement. Slots of the finished threads are reused with their retired objects by the new threads.
+
+struct epoch_retired_ptr {
+    void*           ptr;
+    void            (*deleter)(void*);
+    std::uint64_t   epoch;
+};
+
+/// Per thread record of a pinned epoch, 0 means that the thread is not inside a traversal.
+struct epoch_slot {
+    std::atomic<std::uint64_t>      epoch{0};
+    std::atomic<bool>               used{true};
+    epoch_slot*                     next = nullptr;
+    std::size_t                     depth = 0;      // nesting of pins, accessed only by the owning thread
+    std::vector<epoch_retired_ptr>  retired;        // accessed only by the owning thread
+    char padding[cache_line_size];                  // slots of different threads must not share a cache line
+
+    ~epoch_slot() {
+        for (const epoch_retired_ptr& r : retired) {
+            r.deleter(r.ptr);
+        }
+    }
+
+    /// Frees the retired objects that no reader could reference in epoch `current`.
+    void collect(std::uint64_t current) {
+        auto it = retired.begin();
+        for (auto& r : retired) {
+            if (r.epoch + 2 <= current) {
+                r.deleter(r.ptr);
+            } else {
+                *it++ = r;
+            }
+        }
+        retired.erase(it, retired.end());
+    }
+};
+
+struct epoch_state {
+    std::atomic<std::uint64_t>  global{1};
+    std::atomic<epoch_slot*>    slots{nullptr};
+    const std::uint64_t         id;
+
+    explicit epoch_state(std::uint64_t state_id) noexcept : id(state_id) {}
+
+    ~epoch_state() {
+        epoch_slot* s = slots.load(std::memory_order_relaxed);
+        while (s) {
+            epoch_slot* const next = s->next;
+            delete s;
+            s = next;
+        }
+    }
+
+    epoch_slot* acquire_slot() {
+        for (epoch_slot* s = slots.load(std::memory_order_acquire); s; s = s->next) {
+            bool expected = false;
+            if (!s->used.load(std::memory_order_relaxed) && s->used.compare_exchange_strong(expected, true)) {
+                return s;
+            }
+        }
+
+        epoch_slot* const s = new epoch_slot;
+        s->next = slots.load(std::memory_order_relaxed);
+        while (!slots.compare_exchange_weak(s->next, s)) {}
+        return s;
+    }
+
+    /// Advances the global epoch if all the pinned threads have seen it. Could be called concurrently: only one of the
+    /// threads that saw the same epoch advances it.
+    /// \return the global epoch after the attempt.
+    std::uint64_t try_advance() noexcept {
+        std::uint64_t current = global.load();
+        for (epoch_slot* s = slots.load(std::memory_order_acquire); s; s = s->next) {
+            const std::uint64_t pinned = s->epoch.load();
+            if (pinned != 0 && pinned != current) {
+                return current;
+            }
+        }
+        if (global.compare_exchange_strong(current, current + 1)) {
+            return current + 1;
+        }
+        return current;     // updated by the failed exchange
+    }
+};
+
+/// Slots of the current thread in each of the live epoch_domain.
+struct epoch_thread_slots {
+    struct entry {
+        std::uint64_t               id;
+        epoch_slot*                 slot;
+        std::weak_ptr<epoch_state>  state;
+    };
+    std::vector<entry> entries;
+
+    ~epoch_thread_slots() {
+        for (entry& e : entries) {
+            if (const std::shared_ptr<epoch_state> state = e.state.lock()) {
+                e.slot->used.store(false, std::memory_order_release);
+            }
+        }
+    }
+
+    epoch_slot* find(const std::shared_ptr<epoch_state>& state) {
+        for (const entry& e : entries) {
+            if (e.id == state->id) {
+                return e.slot;
+            }
+        }
+
+        // Forgetting the domains that were destroyed
+        auto it = entries.begin();
+        for (entry& e : entries) {
+            if (!e.state.expired()) {
+                *it++ = std::move(e);
+            }
+        }
+        entries.erase(it, entries.end());
+
+        epoch_slot* const slot = state->acquire_slot();
+        entries.push_back(entry{state->id, slot, state});
+        return slot;
+    }
+
+    static epoch_thread_slots& instance() {
+        static thread_local epoch_thread_slots slots;
+        return slots;
+    }
+};
+
+inline std::uint64_t next_epoch_domain_id() noexcept {
+    static std::atomic<std::uint64_t> id{0};
+    return ++id;
+}
+
+/// Domain of epoch based reclamation, usually one per container.
+class epoch_domain {
+public:
+    /// Readers hold the guard while traversing the shared structures.
+    class guard {
+    public:
+        explicit guard(epoch_slot* slot) noexcept : slot_(slot) {}
+        guard(guard&& other) noexcept : slot_(other.slot_) { other.slot_ = nullptr; }
+        guard& operator=(const guard&) = delete;
+
+        ~guard() {
+            if (slot_ && --slot_->depth == 0) {
+                slot_->epoch.store(0, std::memory_order_release);
+            }
+        }
+
+    private:
+        epoch_slot* slot_;
+    };
+
+    epoch_domain()
+        : state_(std::make_shared<epoch_state>(detail::next_epoch_domain_id()))
+    {}
+
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+
+    /// Pins the current epoch for the calling thread. Pins may be nested.
+    guard pin() const {
+        epoch_slot* const slot = epoch_thread_slots::instance().find(state_);
+        if (slot->depth++ == 0) {
+            // Re-checking the global epoch after publishing the pin: if it changed in between, the thread that advanced it
+            // could have missed the pin.
+            std::uint64_t current = state_->global.load();
+            for (;;) {
+                slot->epoch.store(current);
+                const std::uint64_t after = state_->global.load();
+                if (after == current) {
+                    break;
+                }
+                current = after;
+            }
+        }
+        return guard{slot};
+    }
+
+    /// Frees `ptr` with `deleter` when no reader could reference it any more. `ptr` must be already unreachable for new readers.
+    void retire(void* ptr, void (*deleter)(void*)) {
+        epoch_slot* const slot = epoch_thread_slots::instance().find(state_);
+        slot->retired.push_back(epoch_retired_ptr{ptr, deleter, state_->global.load()});
+        if (slot->retired.size() % 64 == 0) {
+            slot->collect(state_->try_advance());
+        }
+    }
+
+    template <class T>
+    void retire(T* ptr) {
+        retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+    }
+
+private:
+    std::shared_ptr<epoch_state> state_;
+};
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_EPOCH_HPP
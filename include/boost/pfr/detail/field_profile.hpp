@@ -0,0 +1,244 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_FIELD_PROFILE_HPP
+#define BOOST_PFR_DETAIL_FIELD_PROFILE_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+// Compilers provide the builtin for std::is_constant_evaluated() in all the language modes, so profiled get() stays
+// constexpr in C++17 too
+#if defined(__cpp_lib_is_constant_evaluated)
+#   define BOOST_PFR_DETAIL_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif defined(__clang__)
+#   if defined(__has_builtin)
+#       if __has_builtin(__builtin_is_constant_evaluated)
+#           define BOOST_PFR_DETAIL_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#       endif
+#   endif
+#elif defined(__GNUC__) && __GNUC__ >= 9
+#   define BOOST_PFR_DETAIL_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#elif defined(_MSC_VER) && _MSC_VER >= 1925
+#   define BOOST_PFR_DETAIL_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+
+#if defined(BOOST_PFR_DETAIL_IS_CONSTANT_EVALUATED)
+#   define BOOST_PFR_DETAIL_PROFILE_CONSTEXPR constexpr
+#else
+#   define BOOST_PFR_DETAIL_PROFILE_CONSTEXPR
+#endif
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Counters of field accesses for BOOST_PFR_FIELD_PROFILE
+//
+// Each thread has its own table per reflected type, so counting is a couple of plain loads and stores. Counters are
+// atomics with relaxed ordering only to allow reading them from the thread that makes a report. A table of a finished
+// thread keeps its counters and is given to the next thread that profiles the same type, so the count of the tables is
+// bounded by the count of the simultaneously running threads.
+//
+// A visit is a sequence of accesses to the same object. Fields accessed during the same visit are co-accessed, each pair
+// is counted once per visit. The diagonal of the co-access matrix is the count of visits that accessed the field. Only the
+// first 64 fields participate in co-access.
+
+enum class field_profile_kind { precise, flat };
+
+class field_profile_table {
+public:
+    field_profile_table(const std::type_info& type, field_profile_kind kind, std::size_t fields)
+        : type_(&type)
+        , kind_(kind)
+        , fields_(fields)
+        , accesses_(new std::atomic<std::uint64_t>[fields ? fields : 1])
+        , co_accesses_(new std::atomic<std::uint64_t>[fields ? fields * fields : 1])
+    {
+        reset();
+    }
+
+    void access(const void* object, std::size_t field) noexcept {
+        if (object != object_) {
+            object_ = object;
+            mask_ = 0;
+            increment(visits_);
+        }
+        increment(accesses_[field]);
+
+        const std::uint64_t bit = (field < 64 ? std::uint64_t(1) << field : 0);
+        if (bit && !(mask_ & bit)) {
+            for (std::uint64_t m = mask_; m; m &= m - 1) {
+                std::size_t other = 0;
+                while (!((m >> other) & 1)) {
+                    ++other;
+                }
+                increment(co_accesses_[other < field ? other * fields_ + field : field * fields_ + other]);
+            }
+            increment(co_accesses_[field * fields_ + field]);
+            mask_ |= bit;
+        }
+    }
+
+    /// Counts access to all the fields of `object` in a single visit.
+    void access_all(const void* object) noexcept {
+        object_ = nullptr;
+        for (std::size_t i = 0; i < fields_; ++i) {
+            access(object, i);
+        }
+    }
+
+    /// May be called from any thread, concurrent accesses may be lost.
+    void reset() noexcept {
+        visits_.store(0, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < fields_; ++i) {
+            accesses_[i].store(0, std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < fields_ * fields_; ++i) {
+            co_accesses_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /// Ends the visit of the previous owner. Called when the table is given to another thread.
+    void start_owner() noexcept {
+        object_ = nullptr;
+        mask_ = 0;
+    }
+
+    const std::type_info& type() const noexcept { return *type_; }
+    field_profile_kind kind() const noexcept { return kind_; }
+    std::size_t fields() const noexcept { return fields_; }
+    std::uint64_t visits() const noexcept { return visits_.load(std::memory_order_relaxed); }
+    std::uint64_t accesses(std::size_t i) const noexcept { return accesses_[i].load(std::memory_order_relaxed); }
+
+    /// \pre i <= j
+    std::uint64_t co_accesses(std::size_t i, std::size_t j) const noexcept {
+        return co_accesses_[i * fields_ + j].load(std::memory_order_relaxed);
+    }
+
+private:
+    static void increment(std::atomic<std::uint64_t>& counter) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    const std::type_info*                           type_;
+    field_profile_kind                              kind_;
+    std::size_t                                     fields_;
+    std::atomic<std::uint64_t>                      visits_{0};
+    std::unique_ptr<std::atomic<std::uint64_t>[]>   accesses_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]>   co_accesses_;
+
+    // Accessed only by the owning thread
+    const void*                                     object_ = nullptr;
+    std::uint64_t                                   mask_ = 0;
+
+public:
+    bool                                            in_use = true;  // guarded by the mutex of the registry
+};
+
+/// Tables of all the threads. Tables outlive their threads, so the report includes the threads that have finished.
+struct field_profile_registry {
+    std::mutex                                          mutex;
+    std::vector<std::unique_ptr<field_profile_table>>   tables;
+
+    static field_profile_registry& instance() {
+        static field_profile_registry registry;
+        return registry;
+    }
+
+    /// \return table of a finished thread for the type or a new table.
+    field_profile_table* acquire_table(const std::type_info& type, field_profile_kind kind, std::size_t fields) noexcept {
+        try {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& table : tables) {
+                if (!table->in_use && table->kind() == kind && table->type() == type) {
+                    table->in_use = true;
+                    table->start_owner();
+                    return table.get();
+                }
+            }
+
+            std::unique_ptr<field_profile_table> table(new field_profile_table(type, kind, fields));
+            tables.push_back(std::move(table));
+            return tables.back().get();
+        } catch (...) {
+            return nullptr;     // accesses are not counted if there's no memory for the counters
+        }
+    }
+
+    void release_table(field_profile_table& table) noexcept {
+        std::lock_guard<std::mutex> lock(mutex);
+        table.in_use = false;
+    }
+};
+
+/// Returns the table to the registry when the thread finishes.
+class field_profile_table_owner {
+public:
+    explicit field_profile_table_owner(field_profile_table* table) noexcept
+        : table_(table)
+    {}
+
+    field_profile_table_owner(const field_profile_table_owner&) = delete;
+    field_profile_table_owner& operator=(const field_profile_table_owner&) = delete;
+
+    ~field_profile_table_owner() {
+        if (table_) {
+            field_profile_registry::instance().release_table(*table_);
+        }
+    }
+
+    field_profile_table* get() const noexcept {
+        return table_;
+    }
+
+private:
+    field_profile_table* const table_;
+};
+
+template <class T, field_profile_kind Kind, std::size_t Fields>
+field_profile_table* field_profile_table_of() noexcept {
+    static thread_local const field_profile_table_owner table(
+        field_profile_registry::instance().acquire_table(typeid(T), Kind, Fields)
+    );
+    return table.get();
+}
+
+/// Functions that count accesses are constexpr if the constant evaluation could be detected, accesses during the constant
+/// evaluation are not counted. Otherwise get() is not usable in constant expressions in the profiling mode.
+template <class T, field_profile_kind Kind, std::size_t Fields>
+BOOST_PFR_DETAIL_PROFILE_CONSTEXPR void profile_field_access(const void* object, std::size_t field) noexcept {
+#if defined(BOOST_PFR_DETAIL_IS_CONSTANT_EVALUATED)
+    if (BOOST_PFR_DETAIL_IS_CONSTANT_EVALUATED()) {
+        return;
+    }
+#endif
+    if (field_profile_table* const table = detail::field_profile_table_of<T, Kind, Fields>()) {
+        table->access(object, field);
+    }
+}
+
+template <class T, field_profile_kind Kind, std::size_t Fields>
+BOOST_PFR_DETAIL_PROFILE_CONSTEXPR void profile_fields_access(const void* object) noexcept {
+#if defined(BOOST_PFR_DETAIL_IS_CONSTANT_EVALUATED)
+    if (BOOST_PFR_DETAIL_IS_CONSTANT_EVALUATED()) {
+        return;
+    }
+#endif
+    if (field_profile_table* const table = detail::field_profile_table_of<T, Kind, Fields>()) {
+        table->access_all(object);
+    }
+}
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_FIELD_PROFILE_HPP
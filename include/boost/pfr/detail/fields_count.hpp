@@ -47,6 +47,17 @@ template <class T> struct is_single_field_and_aggregate_initializable<1, T>: std
     bool, !std::is_constructible<T, ubiq_constructor_except<T>>::value
 > {};
 
+#if BOOST_PFR_USE_CONCEPTS
+// Since C++20 aggregates are constructible from parenthesized list of values, so the hand-made trait does not work.
+template <class T, std::size_t N>
+struct is_aggregate_initializable_n {
+    static constexpr bool value =
+           std::is_empty<T>::value
+        || std::is_scalar<T>::value
+        || std::is_aggregate<T>::value
+    ;
+};
+#else
 template <class T, std::size_t N>
 struct is_aggregate_initializable_n {
     template <std::size_t ...I>
@@ -62,9 +73,37 @@ struct is_aggregate_initializable_n {
         || is_not_constructible_n(std::make_index_sequence<N>{})
     ;
 };
+#endif
 
 ///////////////////// Methods for detecting max parameters for construction of T
 
+#if BOOST_PFR_USE_CONCEPTS
+
+template <class T, std::size_t... I>
+constexpr bool is_aggregate_constructible_from(std::index_sequence<I...>) noexcept {
+    return requires { T{ ubiq_constructor{I}... }; };
+}
+
+// Binary search without overload resolution: `if constexpr` chooses the next step.
+template <class T, std::size_t Begin, std::size_t Middle>
+constexpr std::size_t detect_fields_count(size_t_<Begin>, size_t_<Middle>) noexcept {
+    if constexpr (Begin == Middle) {
+        static_assert(
+            is_aggregate_initializable_n<T, Middle>::value,
+            "Types with user specified constructors (non-aggregate initializable types) are not supported."
+        );
+        return Middle;
+    } else if constexpr (detail::is_aggregate_constructible_from<T>(std::make_index_sequence<Middle>())) {
+        constexpr std::size_t next = Middle + (Middle - Begin + 1) / 2;
+        return detail::detect_fields_count<T>(size_t_<Middle>{}, size_t_<next>{});
+    } else {
+        constexpr std::size_t next = (Begin + Middle) / 2;
+        return detail::detect_fields_count<T>(size_t_<Begin>{}, size_t_<next>{});
+    }
+}
+
+#else
+
 template <class T, std::size_t... I>
 constexpr auto enable_if_constructible_helper(std::index_sequence<I...>) noexcept
     -> typename std::add_pointer<decltype(T{ ubiq_constructor{I}... })>::type;
@@ -100,6 +139,8 @@ constexpr void detect_fields_count(std::size_t& count, size_t_<Begin>, size_t_<M
     detect_fields_count<T>(count, size_t_<Begin>{}, size_t_<next>{}, 1L);
 }
 
+#endif // #if BOOST_PFR_USE_CONCEPTS
+
 ///////////////////// Returns non-flattened fields count
 template <class T>
 constexpr std::size_t fields_count() noexcept {
@@ -129,10 +170,14 @@ constexpr std::size_t fields_count() noexcept {
 //    );
 //#endif
 
-    std::size_t res = 0u;
     constexpr std::size_t next = (sizeof(T) * 8) / 2 + 1; // We multiply by 8 because we may have bitfields in T
+#if BOOST_PFR_USE_CONCEPTS
+    return detail::detect_fields_count<T>(size_t_<0>{}, size_t_<next>{});
+#else
+    std::size_t res = 0u;
     detect_fields_count<T>(res, size_t_<0>{}, size_t_<next>{}, 1L);
     return res;
+#endif
 }
 
 }}} // namespace boost::pfr::detail
@@ -18,6 +18,16 @@ namespace boost { namespace pfr { namespace detail {
 template <std::size_t Index>
 using size_t_ = std::integral_constant<std::size_t, Index >;
 
+#if BOOST_PFR_USE_CONCEPTS
+template <class T, class F, class I>
+void for_each_field_impl(T&& v, F&& f, I i, long) {
+    if constexpr (requires { std::forward<F>(f)(std::forward<T>(v), i); }) {
+        std::forward<F>(f)(std::forward<T>(v), i);
+    } else {
+        std::forward<F>(f)(std::forward<T>(v));
+    }
+}
+#else
 template <class T, class F, class I, class = decltype(std::declval<F>()(std::declval<T>(), I{}))>
 void for_each_field_impl(T&& v, F&& f, I i, long) {
     std::forward<F>(f)(std::forward<T>(v), i);
@@ -27,6 +37,7 @@ template <class T, class F, class I>
 void for_each_field_impl(T&& v, F&& f, I /*i*/, int) {
     std::forward<F>(f)(std::forward<T>(v));
 }
+#endif
 
 template <class T, class F, std::size_t... I>
 void for_each_field_impl(T&& t, F&& f, std::index_sequence<I...>) {
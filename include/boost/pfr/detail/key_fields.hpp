@@ -0,0 +1,99 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_KEY_FIELDS_HPP
+#define BOOST_PFR_DETAIL_KEY_FIELDS_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>      // metaprogramming stuff
+
+#include <boost/pfr/detail/functional.hpp>
+#include <boost/pfr/precise/core.hpp>
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Three-way lexicographical comparison of tuples, uses only `operator<` of the elements
+template <class Lhs, class Rhs>
+constexpr int compare_tuples(const Lhs&, const Rhs&, std::index_sequence<>) noexcept {
+    return 0;
+}
+
+template <class Lhs, class Rhs, std::size_t I, std::size_t... Rest>
+constexpr int compare_tuples(const Lhs& lhs, const Rhs& rhs, std::index_sequence<I, Rest...>) {
+    return std::get<I>(lhs) < std::get<I>(rhs) ? -1
+        : (std::get<I>(rhs) < std::get<I>(lhs) ? 1 : detail::compare_tuples(lhs, rhs, std::index_sequence<Rest...>{}));
+}
+
+///////////////////// Hash of a tuple, combines `std::hash` of the elements
+template <class Tuple>
+std::size_t hash_tuple(const Tuple&, std::index_sequence<>) noexcept {
+    return 0;
+}
+
+template <class Tuple, std::size_t I, std::size_t... Rest>
+std::size_t hash_tuple(const Tuple& t, std::index_sequence<I, Rest...>) {
+    std::size_t h = std::hash<std::decay_t<std::tuple_element_t<I, Tuple>>>()(std::get<I>(t));
+    detail::hash_combine(h, detail::hash_tuple(t, std::index_sequence<Rest...>{}));
+    return h;
+}
+
+///////////////////// Projection of an aggregate on some of its fields, used as a key by containers and algorithms
+template <class T, class Indexes>
+struct key_fields_impl;
+
+template <class T, std::size_t... I>
+struct key_fields_impl<T, std::index_sequence<I...>> {
+    typedef std::tuple< std::remove_cv_t<::boost::pfr::tuple_element_t<I, T>>... > type;
+    static constexpr std::size_t size = sizeof...(I);
+
+    /// Copies the key fields of `value`.
+    static type make(const T& value) {
+        return type{ ::boost::pfr::get<I>(value)... };
+    }
+
+    /// Returns `std::tuple` of const references to the key fields of `value`.
+    static auto tie(const T& value) noexcept {
+        return std::tie( ::boost::pfr::get<I>(value)... );
+    }
+
+    /// Returns negative value if the key of `lhs` is less than the key of `rhs`, positive value if it is greater and 0 if keys are equal.
+    static int compare(const T& lhs, const T& rhs) {
+        return detail::compare_tuples(tie(lhs), tie(rhs), std::make_index_sequence<sizeof...(I)>{});
+    }
+
+    /// Returns hash of the key fields of `value`.
+    static std::size_t hash(const T& value) {
+        return detail::hash_tuple(tie(value), std::make_index_sequence<sizeof...(I)>{});
+    }
+};
+
+/// Empty `I...` means "all the fields of T".
+template <class T, std::size_t... I>
+using key_fields = key_fields_impl<
+    T,
+    std::conditional_t<
+        sizeof...(I) == 0,
+        std::make_index_sequence< ::boost::pfr::tuple_size_v<T> >,
+        std::index_sequence<I...>
+    >
+>;
+
+/// Same as key_fields, but takes the indexes as `std::index_sequence`.
+template <class T, class Fields>
+struct key_fields_of;
+
+template <class T, std::size_t... I>
+struct key_fields_of<T, std::index_sequence<I...>> {
+    typedef key_fields<T, I...> type;
+};
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_KEY_FIELDS_HPP
@@ -0,0 +1,225 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_LOSER_TREE_HPP
+#define BOOST_PFR_DETAIL_LOSER_TREE_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/key_fields.hpp>
+#include <boost/pfr/detail/normalized_key.hpp>
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Tournament trees of losers for k-way merging
+//
+// Node `n` has children `2n` and `2n + 1`, source `s` is the leaf `k + s`. Internal nodes [1, k) keep the loser of the
+// match played in them, the overall winner is kept separately. After the winner advances only the matches on the path
+// from its leaf to the root are replayed: log2(k) comparisons.
+//
+// Keys of the current values are copied when the source advances, so the matches compare the copies instead of reading
+// the values through the reflection. Exhausted sources are greater than any other, sources with equal keys are ordered
+// by their indexes to keep the merge stable.
+//
+// Usage: load() or exhaust() each source, build(), then call replace_top() or exhaust_top() after each advance of top().
+
+/// Generic keys: nodes keep the source indexes, copies of the keys are kept per source.
+template <class KeyFields, class Enable = void>
+class merge_tree {
+public:
+    explicit merge_tree(std::size_t k)
+        : keys_(k)
+        , exhausted_(k)
+        , nodes_(k ? k : 1)
+    {}
+
+    template <class T>
+    void load(std::size_t source, const T& value) {
+        keys_[source] = KeyFields::make(value);
+    }
+
+    void exhaust(std::size_t source) noexcept {
+        exhausted_[source] = true;
+    }
+
+    void build() {
+        const std::size_t k = keys_.size();
+        std::vector<std::size_t> winners(k);
+        for (std::size_t n = k; n-- > 1;) {
+            const std::size_t left = (2 * n < k ? winners[2 * n] : 2 * n - k);
+            const std::size_t right = (2 * n + 1 < k ? winners[2 * n + 1] : 2 * n + 1 - k);
+            const bool right_wins = less(right, left);
+            winners[n] = (right_wins ? right : left);
+            nodes_[n] = (right_wins ? left : right);
+        }
+        nodes_[0] = (k > 1 ? winners[1] : 0);
+    }
+
+    /// \return the source with the least current value.
+    std::size_t top() const noexcept {
+        return nodes_[0];
+    }
+
+    template <class T>
+    void replace_top(const T& value) {
+        load(top(), value);
+        replay();
+    }
+
+    void exhaust_top() {
+        exhaust(top());
+        replay();
+    }
+
+private:
+    bool less(std::size_t a, std::size_t b) const {
+        if (exhausted_[a] || exhausted_[b]) {
+            return !exhausted_[a] || (exhausted_[b] && a < b);
+        }
+        const int cmp = detail::compare_tuples(keys_[a], keys_[b], std::make_index_sequence<KeyFields::size>{});
+        return cmp < 0 || (cmp == 0 && a < b);
+    }
+
+    void replay() {
+        const std::size_t k = nodes_.size();
+        std::size_t winner = nodes_[0];
+        for (std::size_t n = (winner + k) / 2; n > 0; n /= 2) {
+            if (less(nodes_[n], winner)) {
+                std::swap(nodes_[n], winner);
+            }
+        }
+        nodes_[0] = winner;
+    }
+
+    std::vector<typename KeyFields::type>   keys_;
+    std::vector<bool>                       exhausted_;
+    std::vector<std::size_t>                nodes_;
+};
+
+/// Keys with only integral fields: nodes keep the normalized words of the keys after the word that is 1 for the exhausted
+/// sources. The winner is kept in registers during the replay and the outcomes of the matches select the words with
+/// masks: the outcomes are unpredictable and compilers turn the conditional selection of structures into branches.
+template <class KeyFields>
+class merge_tree<KeyFields, std::enable_if_t<detail::all_fields_normalizable<typename KeyFields::type>::value>> {
+    static constexpr std::size_t words_count = KeyFields::size + 1;
+
+    struct node {
+        std::uint64_t words[words_count];   // normalized std::int64_t words
+        std::uint64_t source;
+    };
+
+public:
+    explicit merge_tree(std::size_t k)
+        : leaves_(k)
+        , nodes_(k ? k : 1)
+    {}
+
+    template <class T>
+    void load(std::size_t source, const T& value) noexcept {
+        leaves_[source] = make_node(source, value);
+    }
+
+    void exhaust(std::size_t source) noexcept {
+        leaves_[source] = exhausted_node(source);
+    }
+
+    void build() {
+        const std::size_t k = leaves_.size();
+        std::vector<node> winners(k);
+        for (std::size_t n = k; n-- > 1;) {
+            const node& left = (2 * n < k ? winners[2 * n] : leaves_[2 * n - k]);
+            const node& right = (2 * n + 1 < k ? winners[2 * n + 1] : leaves_[2 * n + 1 - k]);
+            const bool right_wins = less(right, left);
+            winners[n] = (right_wins ? right : left);
+            nodes_[n] = (right_wins ? left : right);
+        }
+        if (k) {
+            winner_ = (k > 1 ? winners[1] : leaves_[0]);
+        }
+        leaves_.clear();
+        leaves_.shrink_to_fit();
+    }
+
+    /// \return the source with the least current value.
+    std::size_t top() const noexcept {
+        return static_cast<std::size_t>(winner_.source);
+    }
+
+    template <class T>
+    void replace_top(const T& value) noexcept {
+        replay(make_node(top(), value));
+    }
+
+    void exhaust_top() noexcept {
+        replay(exhausted_node(top()));
+    }
+
+private:
+    template <class T>
+    static node make_node(std::size_t source, const T& value) noexcept {
+        std::int64_t words[KeyFields::size];
+        detail::normalize_tuple(KeyFields::tie(value), words, std::make_index_sequence<KeyFields::size>{});
+
+        node result;
+        result.words[0] = 0;
+        for (std::size_t w = 1; w < words_count; ++w) {
+            result.words[w] = static_cast<std::uint64_t>(words[w - 1]);
+        }
+        result.source = source;
+        return result;
+    }
+
+    static node exhausted_node(std::size_t source) noexcept {
+        node result{};
+        result.words[0] = 1;
+        result.source = source;
+        return result;
+    }
+
+    static bool less(const node& x, const node& y) noexcept {
+        bool less = false;
+        bool equal = true;
+        for (std::size_t w = 0; w < words_count; ++w) {
+            const std::int64_t a = static_cast<std::int64_t>(x.words[w]);
+            const std::int64_t b = static_cast<std::int64_t>(y.words[w]);
+            less = less | (equal & (a < b));
+            equal = equal & (a == b);
+        }
+        return less | (equal & (x.source < y.source));
+    }
+
+    void replay(node winner) noexcept {
+        const std::size_t k = nodes_.size();
+        for (std::size_t n = (static_cast<std::size_t>(winner.source) + k) / 2; n > 0; n /= 2) {
+            node& challenger = nodes_[n];
+            const std::uint64_t mask = std::uint64_t{0} - static_cast<std::uint64_t>(less(challenger, winner));
+            for (std::size_t w = 0; w < words_count; ++w) {
+                const std::uint64_t diff = (challenger.words[w] ^ winner.words[w]) & mask;
+                challenger.words[w] ^= diff;
+                winner.words[w] ^= diff;
+            }
+            const std::uint64_t diff = (challenger.source ^ winner.source) & mask;
+            challenger.source ^= diff;
+            winner.source ^= diff;
+        }
+        winner_ = winner;
+    }
+
+    std::vector<node>   leaves_;    // used only before build()
+    std::vector<node>   nodes_;
+    node                winner_{};
+};
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_LOSER_TREE_HPP
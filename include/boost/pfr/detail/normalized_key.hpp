@@ -0,0 +1,156 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_NORMALIZED_KEY_HPP
+#define BOOST_PFR_DETAIL_NORMALIZED_KEY_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>      // metaprogramming stuff
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#endif
+
+#include <boost/pfr/detail/key_fields.hpp>
+#include <boost/pfr/detail/reflection_info.hpp>
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Normalized keys: integral fields mapped onto std::int64_t words with the same ordering
+//
+// Keys with only integral and enum fields are compared lexicographically word by word, which does not depend on the
+// types of the fields and could be done with SIMD instructions for several keys at once.
+
+template <class F>
+using is_normalizable_field = std::integral_constant<bool,
+    (std::is_integral<F>::value || std::is_enum<F>::value) && sizeof(F) <= sizeof(std::int64_t)
+>;
+
+template <class F>
+constexpr std::int64_t normalize_field_impl(F v, std::true_type /*is_signed*/) noexcept {
+    return static_cast<std::int64_t>(v);
+}
+
+template <class F>
+constexpr std::int64_t normalize_field_impl(F v, std::false_type /*is_signed*/) noexcept {
+    // Flipping the highest bit maps [0, 2^64) onto [-2^63, 2^63) preserving the order.
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(v) ^ (std::uint64_t(1) << 63));
+}
+
+template <class F>
+constexpr std::int64_t normalize_field(F v) noexcept {
+    typedef typename std::conditional_t<std::is_enum<F>::value, std::underlying_type<F>, detail::identity<F>>::type value_t;
+    return detail::normalize_field_impl(static_cast<value_t>(v), std::is_signed<value_t>{});
+}
+
+template <bool... B> struct bool_pack {};
+
+template <class Tuple>
+struct all_fields_normalizable;
+
+template <class... F>
+struct all_fields_normalizable<std::tuple<F...>>
+    : std::is_same<bool_pack<true, is_normalizable_field<F>::value...>, bool_pack<is_normalizable_field<F>::value..., true>>
+{};
+
+template <class Tuple, std::size_t... I>
+void normalize_tuple(const Tuple& t, std::int64_t* out, std::index_sequence<I...>) noexcept {
+    const int ignore[] = {0, (out[I] = detail::normalize_field(std::get<I>(t)), 0)...};
+    (void)ignore;
+}
+
+/// Has `value` equal to true and functions for normalizing the key if all the fields of `Key` are integral or enums.
+template <class Key, class Enable = void>
+struct normalized_key {
+    static constexpr bool value = false;
+};
+
+template <class Key>
+struct normalized_key<Key, std::enable_if_t<is_normalizable_field<Key>::value>> {
+    static constexpr bool value = true;
+    static constexpr std::size_t words = 1;
+
+    static void normalize(const Key& key, std::int64_t* out) noexcept {
+        out[0] = detail::normalize_field(key);
+    }
+};
+
+template <class Key>
+struct normalized_key<Key, std::enable_if_t<
+    std::is_class<Key>::value && all_fields_normalizable<typename detail::key_fields<Key>::type>::value
+>> {
+    static constexpr bool value = true;
+    static constexpr std::size_t words = std::tuple_size<typename detail::key_fields<Key>::type>::value;
+
+    static void normalize(const Key& key, std::int64_t* out) noexcept {
+        detail::normalize_tuple(detail::key_fields<Key>::tie(key), out, std::make_index_sequence<words>{});
+    }
+};
+
+///////////////////// Search in a block of normalized keys
+
+/// Returns count of the first `n` keys in `rows` that are less than `x` (not greater than `x` if `OrEqual`).
+/// Keys are stored column-wise, `rows[w][i]` is the word `w` of the key `i`. Keys must be sorted.
+/// All the `Capacity` words of each row must be initialized, `Capacity` must be a multiple of 4.
+template <bool OrEqual, std::size_t Words, std::size_t Capacity>
+std::size_t normalized_count_less(const std::int64_t (&rows)[Words][Capacity], std::size_t n, const std::int64_t (&x)[Words]) noexcept {
+    static_assert(Capacity % 4 == 0, "====================> Boost.PFR: Internal error while searching normalized keys");
+
+#if defined(__AVX2__)
+    __m256i needle[Words];
+    for (std::size_t w = 0; w < Words; ++w) {
+        needle[w] = _mm256_set1_epi64x(x[w]);
+    }
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; i += 4) {
+        __m256i less = _mm256_setzero_si256();
+        __m256i equal = _mm256_set1_epi64x(-1);
+        for (std::size_t w = 0; w < Words; ++w) {
+            const __m256i keys = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&rows[w][i]));
+            less = _mm256_or_si256(less, _mm256_and_si256(equal, _mm256_cmpgt_epi64(needle[w], keys)));
+            equal = _mm256_and_si256(equal, _mm256_cmpeq_epi64(keys, needle[w]));
+        }
+        if (OrEqual) {
+            less = _mm256_or_si256(less, equal);
+        }
+
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(less)));
+        if (n - i < 4) {
+            mask &= (1u << (n - i)) - 1u;
+        }
+        count += static_cast<std::size_t>((0x4332322132212110ull >> (mask * 4)) & 0xFu);  // popcount of 4 bits
+        if (mask != 0xFu) {
+            break;  // keys are sorted, so the rest of the keys are not less
+        }
+    }
+
+    return count;
+#else
+    // Branchless loop, compilers vectorize it where 64 bit comparisons are available
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        bool less = false;
+        bool equal = true;
+        for (std::size_t w = 0; w < Words; ++w) {
+            less = less | (equal & (rows[w][i] < x[w]));
+            equal = equal & (rows[w][i] == x[w]);
+        }
+        count += static_cast<std::size_t>(less | (OrEqual & equal));
+    }
+
+    return count;
+#endif
+}
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_NORMALIZED_KEY_HPP
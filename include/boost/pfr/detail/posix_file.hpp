@@ -0,0 +1,180 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_POSIX_FILE_HPP
+#define BOOST_PFR_DETAIL_POSIX_FILE_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#if defined(_WIN32)
+#   error POSIX is required for this header.
+#endif
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Files
+class file_descriptor {
+public:
+    file_descriptor(const char* path, int flags) : fd_(::open(path, flags | O_CLOEXEC, 0644)) {
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+    }
+
+    /// Takes ownership of `fd`.
+    explicit file_descriptor(int fd) noexcept : fd_(fd) {}
+
+    file_descriptor(const file_descriptor&) = delete;
+    file_descriptor& operator=(const file_descriptor&) = delete;
+
+    ~file_descriptor() {
+        ::close(fd_);
+    }
+
+    int get() const noexcept { return fd_; }
+
+private:
+    int fd_;
+};
+
+/// Creates a new file without a name in the directory of `path`, so it could not clash with other files and is removed
+/// when closed even if the process crashes.
+/// \return descriptor of the file opened for reading and writing.
+inline int create_temporary_file(const char* path) {
+    const char* const slash = std::strrchr(path, '/');
+    const std::string dir = (slash ? std::string(path, slash == path ? 1 : static_cast<std::size_t>(slash - path)) : std::string("."));
+
+#if defined(O_TMPFILE)
+    const int fd = ::open(dir.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+    if (fd >= 0) {
+        return fd;
+    }
+    // File system or kernel does not support O_TMPFILE, falling back to a unique name
+#endif
+
+    std::string name = dir + "/.boost_pfr_XXXXXX";
+    const int named_fd = ::mkstemp(&name[0]);
+    if (named_fd < 0) {
+        throw std::system_error(errno, std::generic_category(), name);
+    }
+    ::unlink(name.c_str());
+    ::fcntl(named_fd, F_SETFD, FD_CLOEXEC);
+    return named_fd;
+}
+
+/// Writes all the `count` buffers of `iov` at the current position of `fd`, modifies `iov`.
+inline void write_all(int fd, ::iovec* iov, int count) {
+    while (count) {
+        const ::ssize_t res = ::writev(fd, iov, count);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+
+        std::size_t done = static_cast<std::size_t>(res);
+        for (; count && done >= iov->iov_len; ++iov, --count) {
+            done -= iov->iov_len;
+        }
+        if (count) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+            iov->iov_len -= done;
+        }
+    }
+}
+
+/// Reads exactly `size` bytes at `offset` of `fd`.
+inline void read_all(int fd, void* data, std::size_t size, ::off_t offset) {
+    while (size) {
+        const ::ssize_t res = ::pread(fd, data, size, offset);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "pread");
+        }
+        if (res == 0) {
+            throw std::system_error(EIO, std::generic_category(), "pread: unexpected end of file");
+        }
+
+        data = static_cast<char*>(data) + res;
+        size -= static_cast<std::size_t>(res);
+        offset += res;
+    }
+}
+
+/// Read only mapping of a whole file.
+class mapped_file {
+public:
+    mapped_file() = default;
+
+    explicit mapped_file(const char* path)
+        : mapped_file(file_descriptor(path, O_RDONLY).get(), path)
+    {}
+
+    /// Maps the file opened for reading, `fd` could be closed afterwards. `path` is used in the error messages.
+    mapped_file(int fd, const char* path) {
+        struct ::stat st;
+        if (::fstat(fd, &st) != 0) {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (!size_) {
+            return;
+        }
+
+        void* const p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        data_ = static_cast<const unsigned char*>(p);
+    }
+
+    mapped_file(mapped_file&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+    {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        mapped_file tmp(std::move(other));
+        std::swap(data_, tmp.data_);
+        std::swap(size_, tmp.size_);
+        return *this;
+    }
+
+    ~mapped_file() {
+        if (data_) {
+            ::munmap(const_cast<unsigned char*>(data_), size_);
+        }
+    }
+
+    const unsigned char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    const unsigned char*    data_ = nullptr;
+    std::size_t             size_ = 0;
+};
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_POSIX_FILE_HPP
@@ -0,0 +1,43 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_PREFETCH_HPP
+#define BOOST_PFR_DETAIL_PREFETCH_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#   include <xmmintrin.h>
+#endif
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Cache helpers
+constexpr std::size_t cache_line_size = 64;
+
+/// Hints the CPU to load the cache line with `p`. Does nothing on unknown compilers.
+/// Never dereferences `p`, so it may point outside of any object.
+inline void prefetch(const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+/// Prefetches the address `base + offset` bytes without doing pointer arithmetic outside of an array.
+inline void prefetch(const void* base, std::size_t offset) noexcept {
+    detail::prefetch(reinterpret_cast<const void*>(reinterpret_cast<std::uintptr_t>(base) + offset));
+}
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_PREFETCH_HPP
@@ -0,0 +1,78 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_REFLECTION_INFO_HPP
+#define BOOST_PFR_DETAIL_REFLECTION_INFO_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <type_traits>
+#include <utility>      // metaprogramming stuff
+
+#include <boost/pfr/detail/fields_count.hpp>
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Type holder, also used for finding the reflection hooks via ADL
+template <class T> struct identity{
+    typedef T type;
+};
+
+///////////////////// Memoized per-type reflection record
+//
+// Static data members and member classes of a class template are instantiated only when they are used. So each member
+// of `reflection_record<T>` is computed at most once per `T`, and only if some function actually needs it.
+// That allows to keep in the same record the information that is available only for some of the types
+// (for example flattening works only for PODs). Types are kept in member classes, a member typedef would be instantiated
+// with the record.
+//
+// Members that depend on the reflection core are found via ADL on `identity<T>` at the point of instantiation:
+//  * `reflect_tuple(identity<T>)` - declared by the core that defines tie_as_tuple, returns type of the tuple of references;
+//  * `reflect_flat_tuple(identity<T>)` - declared by all the C++14 cores, returns type of the flat tuple of references;
+//  * `reflect_is_flat_reflectable(identity<T>)` - defined by the C++14 core without Loophole.
+template <class T>
+struct reflection_record {
+    typedef T type;
+
+    /// Count of fields in T, nested aggregates are not flattened.
+    static constexpr std::size_t fields_count = detail::fields_count<T>();
+
+    /// `sequence_tuple::tuple` of references to the fields of T, nested aggregates are not flattened.
+    struct fields_tuple {
+        typedef decltype(reflect_tuple(identity<T>{})) type;
+    };
+
+    /// `sequence_tuple::tuple` of references to the fields of \flattening{flattened} T.
+    struct flat_fields_tuple {
+        typedef decltype(reflect_flat_tuple(identity<T>{})) type;
+    };
+
+    /// Count of fields in \flattening{flattened} T.
+    static constexpr std::size_t flat_fields_count = flat_fields_tuple::type::size_v;
+
+    /// True if flat reflection of T does not loose information. Used only by the C++14 core without Loophole.
+    static constexpr bool is_flat_reflectable = reflect_is_flat_reflectable(identity<T>{});
+};
+
+template <class T> constexpr std::size_t reflection_record<T>::fields_count;
+template <class T> constexpr std::size_t reflection_record<T>::flat_fields_count;
+template <class T> constexpr bool reflection_record<T>::is_flat_reflectable;
+
+/// All the functions must read the reflection information from here rather than calling the detectors directly.
+template <class T>
+constexpr reflection_record<T> reflection_info{};
+
+/// Type of detail::tie_as_tuple(std::declval<T&>()).
+template <class T>
+using reflection_tuple_t = typename reflection_record<T>::fields_tuple::type;
+
+/// Type of detail::tie_as_flat_tuple(std::declval<T&>()).
+template <class T>
+using reflection_flat_tuple_t = typename reflection_record<T>::flat_fields_tuple::type;
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_REFLECTION_INFO_HPP
@@ -0,0 +1,387 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_URING_HPP
+#define BOOST_PFR_DETAIL_URING_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#if defined(_WIN32)
+#   error POSIX is required for this header.
+#endif
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#   if __has_include(<linux/io_uring.h>)
+#       include <linux/io_uring.h>
+#       include <sys/mman.h>
+#       include <sys/syscall.h>
+#       define BOOST_PFR_DETAIL_HAS_IO_URING 1
+#   endif
+#endif
+
+#ifndef BOOST_PFR_DETAIL_HAS_IO_URING
+#   define BOOST_PFR_DETAIL_HAS_IO_URING 0
+#endif
+
+#include <boost/pfr/detail/posix_file.hpp>
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Buffers
+struct aligned_free {
+    void operator()(unsigned char* p) const noexcept { std::free(p); }
+};
+
+typedef std::unique_ptr<unsigned char[], aligned_free> aligned_buffer;
+
+/// Page aligned buffers could be used with O_DIRECT and are never split between pages by the kernel.
+inline aligned_buffer make_aligned_buffer(std::size_t size) {
+    constexpr std::size_t page_size = 4096;
+    void* p = nullptr;
+    if (::posix_memalign(&p, page_size, (size + page_size - 1) / page_size * page_size) != 0) {
+        throw std::bad_alloc{};
+    }
+    return aligned_buffer(static_cast<unsigned char*>(p));
+}
+
+///////////////////// Asynchronous positional I/O
+//
+// Fixed set of slots, each slot has at most one request in flight. Requests are executed with io_uring if the kernel
+// supports it, with blocking pread/pwrite at submission otherwise. Short transfers are resubmitted until the whole
+// buffer is transferred or the end of file is reached.
+//
+// Submissions are only queued in the ring, they are passed to the kernel by the next wait() together with the request
+// for the completions: a single system call per wait() submits all the queued requests and the resubmitted short
+// transfers.
+class uring_io {
+    struct request {
+        bool            write = false;
+        bool            pending = false;
+        int             error = 0;
+        unsigned char*  data = nullptr;
+        std::size_t     size = 0;
+        std::size_t     done = 0;
+        std::uint64_t   offset = 0;
+        ::iovec         iov{};
+    };
+
+public:
+    uring_io(int fd, unsigned slots)
+        : fd_(fd)
+        , requests_(slots)
+    {
+#if BOOST_PFR_DETAIL_HAS_IO_URING
+        setup_ring(slots);
+#endif
+    }
+
+    uring_io(const uring_io&) = delete;
+    uring_io& operator=(const uring_io&) = delete;
+
+    /// Waits for all the requests, as the kernel may still access their buffers. If waiting fails the ring and the
+    /// requests are leaked instead of being freed while the kernel may use them.
+    ~uring_io() {
+        if (!quiesce()) {
+            (void)new std::vector<request>(std::move(requests_));   // iovecs of the requests stay at the same addresses
+            return;
+        }
+#if BOOST_PFR_DETAIL_HAS_IO_URING
+        release_ring();
+#endif
+    }
+
+    /// Cancels the queued requests that were not passed to the kernel yet and waits for the requests in flight.
+    /// \return false if waiting failed and the kernel may still access the buffers of the requests, that must not be
+    /// freed then.
+    bool quiesce() noexcept {
+#if BOOST_PFR_DETAIL_HAS_IO_URING
+        if (queued_) {
+            fail_queued(ECANCELED);
+        }
+#endif
+        for (unsigned slot = 0; slot < requests_.size(); ++slot) {
+            while (requests_[slot].pending) {
+                if (!reap()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /// \return true if requests are executed asynchronously by io_uring.
+    bool is_async() const noexcept {
+        return ring_fd_ >= 0;
+    }
+
+    /// Starts reading or writing `size` bytes at `offset` into `data`. `slot` must not have a request in flight.
+    void submit(unsigned slot, bool write, unsigned char* data, std::size_t size, std::uint64_t offset) {
+        request& r = requests_[slot];
+        r.write = write;
+        r.pending = true;
+        r.error = 0;
+        r.data = data;
+        r.size = size;
+        r.done = 0;
+        r.offset = offset;
+
+        if (is_async()) {
+            queue_sqe(slot);
+        } else {
+            transfer_blocking(r);
+        }
+    }
+
+    /// Waits for the request of `slot`.
+    /// \return count of transferred bytes, less than requested only at the end of file.
+    /// \throws std::system_error if the request failed.
+    std::size_t wait(unsigned slot) {
+        request& r = requests_[slot];
+        while (r.pending) {
+            if (!reap()) {
+                throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+            }
+        }
+#if BOOST_PFR_DETAIL_HAS_IO_URING
+        if (queued_ && !enter(0)) {
+            fail_queued(errno);     // requests of the other slots report the error on their wait()
+        }
+#endif
+        if (r.error) {
+            throw std::system_error(r.error, std::generic_category(), r.write ? "pwrite" : "pread");
+        }
+        return r.done;
+    }
+
+    /// \return true if `slot` has a request in flight.
+    bool pending(unsigned slot) const noexcept {
+        return requests_[slot].pending;
+    }
+
+private:
+    void transfer_blocking(request& r) noexcept {
+        while (r.done < r.size) {
+            const ::ssize_t res = r.write
+                ? ::pwrite(fd_, r.data + r.done, r.size - r.done, static_cast<::off_t>(r.offset + r.done))
+                : ::pread(fd_, r.data + r.done, r.size - r.done, static_cast<::off_t>(r.offset + r.done));
+            if (res < 0 && errno == EINTR) {
+                continue;
+            }
+            if (res <= 0) {
+                r.error = (res < 0 ? errno : (r.write ? EIO : 0));
+                break;
+            }
+            r.done += static_cast<std::size_t>(res);
+        }
+        r.pending = false;
+    }
+
+    /// Processes the available completions, submits the queued requests and waits for a completion if there are none.
+    /// Returns false on failure of the system call.
+    bool reap() noexcept {
+#if BOOST_PFR_DETAIL_HAS_IO_URING
+        if (!is_async()) {
+            return true;
+        }
+
+        while (!drain_completions()) {
+            if (!enter(1)) {
+                if (queued_) {
+                    const int error = errno;
+                    fail_queued(error);
+                    errno = error;
+                }
+                return false;
+            }
+        }
+        return true;
+#else
+        return true;
+#endif
+    }
+
+#if BOOST_PFR_DETAIL_HAS_IO_URING
+    /// \return true if there were completions.
+    bool drain_completions() noexcept {
+        unsigned head = *cq_head_;
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            return false;
+        }
+        for (; head != tail; ++head) {
+            const ::io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            complete(static_cast<unsigned>(cqe.user_data), cqe.res);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /// Submits the queued requests and waits for `min_complete` completions in a single system call.
+    bool enter(unsigned min_complete) noexcept {
+        for (;;) {
+            const long res = ::syscall(
+                __NR_io_uring_enter, ring_fd_, queued_, min_complete, min_complete ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0
+            );
+            if (res >= 0) {
+                queued_ -= static_cast<unsigned>(res);
+                if (!queued_ || min_complete) {
+                    return true;
+                }
+            } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                return false;
+            }
+        }
+    }
+
+    /// Takes back the requests that were not passed to the kernel and completes them with `error`.
+    void fail_queued(int error) noexcept {
+        const unsigned tail = *sq_tail_ - queued_;
+        for (unsigned i = 0; i < queued_; ++i) {
+            request& r = requests_[static_cast<unsigned>(sqes_[(tail + i) & *sq_mask_].user_data)];
+            r.error = error;
+            r.pending = false;
+        }
+        __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+        queued_ = 0;
+    }
+
+    void complete(unsigned slot, int res) noexcept {
+        request& r = requests_[slot];
+        if (res < 0) {
+            r.error = -res;
+        } else if (res == 0) {
+            r.error = (r.write ? EIO : 0);
+        } else {
+            r.done += static_cast<std::size_t>(res);
+            if (r.done < r.size) {
+                queue_sqe(slot);
+                return;
+            }
+        }
+        r.pending = false;
+    }
+
+    void queue_sqe(unsigned slot) noexcept {
+        request& r = requests_[slot];
+        r.iov.iov_base = r.data + r.done;
+        r.iov.iov_len = r.size - r.done;
+
+        const unsigned tail = *sq_tail_;
+        const unsigned index = tail & *sq_mask_;
+        ::io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = static_cast<std::uint8_t>(r.write ? IORING_OP_WRITEV : IORING_OP_READV);
+        sqe.fd = fd_;
+        sqe.addr = reinterpret_cast<std::uint64_t>(&r.iov);
+        sqe.len = 1;
+        sqe.off = r.offset + r.done;
+        sqe.user_data = slot;
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        ++queued_;
+    }
+
+    void setup_ring(unsigned entries) noexcept {
+        ::io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        const long fd = ::syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0) {
+            return; // old kernel or forbidden by seccomp, using pread/pwrite
+        }
+        ring_fd_ = static_cast<int>(fd);
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = (sq_ring_size_ > cq_ring_size_ ? sq_ring_size_ : cq_ring_size_);
+        }
+        sqes_size_ = params.sq_entries * sizeof(::io_uring_sqe);
+
+        sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap
+            ? sq_ring_
+            : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        void* const sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+        if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+            if (sqes != MAP_FAILED) {
+                ::munmap(sqes, sqes_size_);
+            }
+            release_ring();
+            return;
+        }
+
+        unsigned char* const sq = static_cast<unsigned char*>(sq_ring_);
+        unsigned char* const cq = static_cast<unsigned char*>(cq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<::io_uring_cqe*>(cq + params.cq_off.cqes);
+        sqes_ = static_cast<::io_uring_sqe*>(sqes);
+    }
+
+    void release_ring() noexcept {
+        if (sqes_) {
+            ::munmap(sqes_, sqes_size_);
+            sqes_ = nullptr;
+        }
+        if (cq_ring_ && cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_ring_size_);
+        }
+        if (sq_ring_ && sq_ring_ != MAP_FAILED) {
+            ::munmap(sq_ring_, sq_ring_size_);
+        }
+        sq_ring_ = cq_ring_ = nullptr;
+        if (ring_fd_ >= 0) {
+            ::close(ring_fd_);
+            ring_fd_ = -1;
+        }
+    }
+
+    void*           sq_ring_ = nullptr;
+    void*           cq_ring_ = nullptr;
+    std::size_t     sq_ring_size_ = 0;
+    std::size_t     cq_ring_size_ = 0;
+    std::size_t     sqes_size_ = 0;
+    unsigned*       sq_tail_ = nullptr;
+    unsigned*       sq_mask_ = nullptr;
+    unsigned*       sq_array_ = nullptr;
+    unsigned*       cq_head_ = nullptr;
+    unsigned*       cq_tail_ = nullptr;
+    unsigned*       cq_mask_ = nullptr;
+    ::io_uring_cqe* cqes_ = nullptr;
+    ::io_uring_sqe* sqes_ = nullptr;
+    unsigned        queued_ = 0;    // requests in the submission ring that were not passed to the kernel yet
+#else
+    void queue_sqe(unsigned) noexcept {}
+#endif
+
+    int                     ring_fd_ = -1;
+    int                     fd_;
+    std::vector<request>    requests_;
+};
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_URING_HPP
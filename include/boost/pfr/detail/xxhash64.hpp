@@ -0,0 +1,129 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_DETAIL_XXHASH64_HPP
+#define BOOST_PFR_DETAIL_XXHASH64_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace boost { namespace pfr { namespace detail {
+
+///////////////////// Streaming XXH64 over a sequence of 64 bit words
+//
+// Result is the XXH64 of the little endian bytes of the words, so it could be checked with any XXH64 implementation.
+// Input of 32 bytes is processed by 4 independent lanes, so the multiplications of the lanes overlap in the pipeline or
+// are done by the vector units. Inputs are always multiples of 8 bytes, so the 4 and 1 byte tails of XXH64 are never
+// used.
+class xxhash64 {
+    static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+    static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr std::uint64_t prime3 = 0x165667B19E3779F9ull;
+    static constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+    static constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+    static std::uint64_t rotl(std::uint64_t x, unsigned r) noexcept {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static std::uint64_t round(std::uint64_t acc, std::uint64_t input) noexcept {
+        return rotl(acc + input * prime2, 31) * prime1;
+    }
+
+    static std::uint64_t merge_round(std::uint64_t acc, std::uint64_t lane) noexcept {
+        return (acc ^ round(0, lane)) * prime1 + prime4;
+    }
+
+public:
+    explicit xxhash64(std::uint64_t seed) noexcept
+        : seed_(seed)
+        , lanes_{seed + prime1 + prime2, seed + prime2, seed, seed - prime1}
+    {}
+
+    void update(std::uint64_t word) noexcept {
+        buffer_[buffered_++] = word;
+        if (buffered_ == 4) {
+            stripe(buffer_);
+            buffered_ = 0;
+        }
+    }
+
+    /// Appends `size` bytes as little endian words, the last word is padded with zeros.
+    void update_bytes(const unsigned char* data, std::size_t size) noexcept {
+        for (; buffered_ && size >= 8; data += 8, size -= 8) {
+            update(load(data));
+        }
+        for (; size >= 32; data += 32, size -= 32) {
+            const std::uint64_t words[4] = {load(data), load(data + 8), load(data + 16), load(data + 24)};
+            stripe(words);
+        }
+        for (; size >= 8; data += 8, size -= 8) {
+            update(load(data));
+        }
+        if (size) {
+            std::uint64_t word = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                word |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+            }
+            update(word);
+        }
+    }
+
+    std::uint64_t finish() const noexcept {
+        std::uint64_t h;
+        if (stripes_) {
+            h = rotl(lanes_[0], 1) + rotl(lanes_[1], 7) + rotl(lanes_[2], 12) + rotl(lanes_[3], 18);
+            for (std::uint64_t lane : lanes_) {
+                h = merge_round(h, lane);
+            }
+        } else {
+            h = seed_ + prime5;
+        }
+
+        h += (stripes_ * 4 + buffered_) * 8;
+        for (std::size_t i = 0; i < buffered_; ++i) {
+            h = rotl(h ^ round(0, buffer_[i]), 27) * prime1 + prime4;
+        }
+
+        h ^= h >> 33;
+        h *= prime2;
+        h ^= h >> 29;
+        h *= prime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+private:
+    static std::uint64_t load(const unsigned char* p) noexcept {
+        std::uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        return word;
+    }
+
+    void stripe(const std::uint64_t* words) noexcept {
+        lanes_[0] = round(lanes_[0], words[0]);
+        lanes_[1] = round(lanes_[1], words[1]);
+        lanes_[2] = round(lanes_[2], words[2]);
+        lanes_[3] = round(lanes_[3], words[3]);
+        ++stripes_;
+    }
+
+    std::uint64_t   seed_;
+    std::uint64_t   lanes_[4];
+    std::uint64_t   buffer_[4] = {0, 0, 0, 0};
+    std::size_t     buffered_ = 0;
+    std::uint64_t   stripes_ = 0;
+};
+
+}}} // namespace boost::pfr::detail
+
+#endif // BOOST_PFR_DETAIL_XXHASH64_HPP
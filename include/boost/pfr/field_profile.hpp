@@ -0,0 +1,197 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_FIELD_PROFILE_HPP
+#define BOOST_PFR_FIELD_PROFILE_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#   include <cxxabi.h>
+#endif
+
+#include <boost/pfr/detail/field_profile.hpp>
+
+/// \file boost/pfr/field_profile.hpp
+/// Contains reports of the field access profile collected if BOOST_PFR_FIELD_PROFILE is defined to `1`.
+///
+/// In the profiling mode boost::pfr::get, boost::pfr::flat_get, boost::pfr::for_each_field and boost::pfr::flat_for_each_field
+/// count accesses to the fields of each type in thread local tables. Containers and algorithms of the library access fields
+/// with them and are profiled too. boost::pfr::for_each_field counts an access to every field.
+///
+/// A visit is a sequence of accesses to the same object. Fields are co-accessed if they are accessed during the same visit.
+/// Fields accessed in most of the visits are hot, fields that are co-accessed are candidates to share a cache line.
+///
+/// BOOST_PFR_FIELD_PROFILE must have the same value in all the translation units of a program.
+namespace boost { namespace pfr {
+
+/// Field access profile of a type merged over all the threads.
+struct field_profile_entry {
+    std::type_index                             type;
+    std::string                                 type_name;
+    bool                                        flat;           ///< Fields are counted in the flattened type.
+    std::uint64_t                               visits;
+    std::vector<std::uint64_t>                  accesses;       ///< Accesses of each field.
+    std::vector<std::vector<std::uint64_t>>     co_accesses;    ///< Visits that accessed both fields `i` and `j`, symmetric. `[i][i]` is the count of visits that accessed `i`.
+
+    std::uint64_t total_accesses() const noexcept {
+        std::uint64_t result = 0;
+        for (std::uint64_t a : accesses) {
+            result += a;
+        }
+        return result;
+    }
+};
+
+namespace detail {
+
+    inline std::string demangled_name(const std::type_info& type) {
+#if defined(__GNUC__) || defined(__clang__)
+        int status = 0;
+        char* const name = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        if (name) {
+            std::string result(name);
+            std::free(name);
+            return result;
+        }
+#endif
+        return type.name();
+    }
+
+} // namespace detail
+
+/// \return access profiles of all the profiled types, most accessed types first. Empty if BOOST_PFR_FIELD_PROFILE is `0`.
+///
+/// Counters of the running threads are read without synchronization, their latest accesses may be missing.
+inline std::vector<field_profile_entry> field_profile() {
+    detail::field_profile_registry& registry = detail::field_profile_registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::vector<field_profile_entry> result;
+    for (const auto& table : registry.tables) {
+        const bool flat = (table->kind() == detail::field_profile_kind::flat);
+        auto it = std::find_if(result.begin(), result.end(), [&](const field_profile_entry& e) {
+            return e.type == std::type_index(table->type()) && e.flat == flat;
+        });
+        if (it == result.end()) {
+            const std::size_t n = table->fields();
+            result.push_back(field_profile_entry{
+                std::type_index(table->type()), detail::demangled_name(table->type()), flat, 0,
+                std::vector<std::uint64_t>(n), std::vector<std::vector<std::uint64_t>>(n, std::vector<std::uint64_t>(n))
+            });
+            it = result.end() - 1;
+        }
+
+        it->visits += table->visits();
+        for (std::size_t i = 0; i < table->fields(); ++i) {
+            it->accesses[i] += table->accesses(i);
+            it->co_accesses[i][i] += table->co_accesses(i, i);
+            for (std::size_t j = i + 1; j < table->fields(); ++j) {
+                const std::uint64_t co = table->co_accesses(i, j);
+                it->co_accesses[i][j] += co;
+                it->co_accesses[j][i] += co;
+            }
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const field_profile_entry& x, const field_profile_entry& y) {
+        return x.total_accesses() > y.total_accesses();
+    });
+    return result;
+}
+
+/// Zeroes all the counters. Accesses from the running threads during the call may be lost.
+inline void field_profile_reset() noexcept {
+    detail::field_profile_registry& registry = detail::field_profile_registry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& table : registry.tables) {
+        table->reset();
+    }
+}
+
+/// \brief Writes a human readable report of boost::pfr::field_profile() to `out`.
+///
+/// For each type fields are ranked by the count of accesses, with their share of the accesses and the share of the visits
+/// that accessed them. Then the `max_pairs` most co-accessed pairs of fields are listed.
+///
+/// \b Example:
+/// \code
+///     // g++ -DBOOST_PFR_FIELD_PROFILE=1 ...
+///     run_workload();
+///     boost::pfr::field_profile_report(std::cerr);
+///
+///     // order (precise): 1000000 visits, 2300000 accesses
+///     //     field   accesses   share  visits
+///     //        #3    1000000   43.5%  100.0%
+///     //        #0     900000   39.1%   90.0%
+///     //        ...
+///     //     co-accessed fields:
+///     //     #0 #3     900000 visits
+/// \endcode
+inline void field_profile_report(std::ostream& out, std::size_t max_pairs = 10) {
+    const std::vector<field_profile_entry> profile = boost::pfr::field_profile();
+    const std::ios_base::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(1);
+
+    for (const field_profile_entry& e : profile) {
+        const std::uint64_t total = e.total_accesses();
+        out << e.type_name << (e.flat ? " (flat)" : " (precise)") << ": " << e.visits << " visits, " << total << " accesses\n";
+
+        std::vector<std::size_t> fields(e.accesses.size());
+        for (std::size_t i = 0; i < fields.size(); ++i) {
+            fields[i] = i;
+        }
+        std::stable_sort(fields.begin(), fields.end(), [&e](std::size_t x, std::size_t y) {
+            return e.accesses[x] > e.accesses[y];
+        });
+
+        out << "    field   accesses   share  visits\n";
+        for (std::size_t i : fields) {
+            out << std::setw(8) << ('#' + std::to_string(i))
+                << std::setw(11) << e.accesses[i]
+                << std::setw(7) << (total ? 100.0 * e.accesses[i] / total : 0.0) << '%'
+                << std::setw(7) << (e.visits ? 100.0 * e.co_accesses[i][i] / e.visits : 0.0) << "%\n";
+        }
+
+        std::vector<std::pair<std::size_t, std::size_t>> pairs;
+        for (std::size_t i = 0; i < fields.size(); ++i) {
+            for (std::size_t j = i + 1; j < fields.size(); ++j) {
+                if (e.co_accesses[i][j]) {
+                    pairs.emplace_back(i, j);
+                }
+            }
+        }
+        std::stable_sort(pairs.begin(), pairs.end(), [&e](const auto& x, const auto& y) {
+            return e.co_accesses[x.first][x.second] > e.co_accesses[y.first][y.second];
+        });
+        if (pairs.size() > max_pairs) {
+            pairs.resize(max_pairs);
+        }
+        if (!pairs.empty()) {
+            out << "    co-accessed fields:\n";
+            for (const auto& p : pairs) {
+                out << "    #" << p.first << " #" << p.second << std::setw(11) << e.co_accesses[p.first][p.second] << " visits\n";
+            }
+        }
+    }
+
+    out.flags(flags);
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_FIELD_PROFILE_HPP
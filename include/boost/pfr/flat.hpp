@@ -8,6 +8,9 @@
 
 /// \file boost/pfr/flat.hpp
 /// Includes all the Boost.PFR headers that define `flat_*` functions, except \xmlonly<link linkend='header.boost.pfr.flat.global_ops_hpp'>boost/pfr/flat/global_ops.hpp</link>\endxmlonly
+///
+/// Containers, algorithms, file formats and profiling reports (for example `boost/pfr/flat/npy.hpp`) are not included
+/// to keep the compile times low, include their headers directly.
 
 #include <boost/pfr/flat/core.hpp>
 #include <boost/pfr/flat/functors.hpp>
@@ -18,6 +18,10 @@
 #include <boost/pfr/detail/for_each_field_impl.hpp>
 #include <boost/pfr/flat/tuple_size.hpp>
 
+#if BOOST_PFR_FIELD_PROFILE
+#   include <boost/pfr/detail/field_profile.hpp>
+#endif
+
 namespace boost { namespace pfr {
 
 /// \brief Returns reference or const reference to a field with index `I` in \flattening{flattened} T.
@@ -33,6 +37,9 @@ namespace boost { namespace pfr {
 /// \endcode
 template <std::size_t I, class T>
 decltype(auto) flat_get(const T& val) noexcept {
+#if BOOST_PFR_FIELD_PROFILE
+    detail::profile_field_access<T, detail::field_profile_kind::flat, flat_tuple_size_v<T>>(&val, I);
+#endif
     return boost::pfr::detail::sequence_tuple::get<I>( boost::pfr::detail::tie_as_flat_tuple(val) );
 }
 
@@ -40,6 +47,9 @@ decltype(auto) flat_get(const T& val) noexcept {
 /// \overload flat_get
 template <std::size_t I, class T>
 decltype(auto) flat_get(T& val /* @cond */, std::enable_if_t< std::is_trivially_assignable<T, T>::value>* = 0/* @endcond */ ) noexcept {
+#if BOOST_PFR_FIELD_PROFILE
+    detail::profile_field_access<T, detail::field_profile_kind::flat, flat_tuple_size_v<T>>(&val, I);
+#endif
     return boost::pfr::detail::sequence_tuple::get<I>( boost::pfr::detail::tie_as_flat_tuple(val) );
 }
 
@@ -52,7 +62,7 @@ decltype(auto) flat_get(T& val /* @cond */, std::enable_if_t< std::is_trivially_
 /// \endcode
 template <std::size_t I, class T>
 using flat_tuple_element = std::remove_reference<
-        typename boost::pfr::detail::sequence_tuple::tuple_element<I, decltype(boost::pfr::detail::tie_as_flat_tuple(std::declval<T&>())) >::type
+        typename boost::pfr::detail::sequence_tuple::tuple_element<I, boost::pfr::detail::reflection_flat_tuple_t<T> >::type
     >;
 
 
@@ -127,6 +137,9 @@ auto flat_structure_tie(T& val /* @cond */, std::enable_if_t< std::is_trivially_
 /// \endcode
 template <class T, class F>
 void flat_for_each_field(T&& value, F&& func) {
+#if BOOST_PFR_FIELD_PROFILE
+    detail::profile_fields_access<std::remove_cv_t<std::remove_reference_t<T>>, detail::field_profile_kind::flat, flat_tuple_size_v<T>>(&value);
+#endif
     ::boost::pfr::detail::for_each_field_impl(
         detail::tie_as_flat_tuple(std::forward<T>(value)),
         std::forward<F>(func),
@@ -12,6 +12,8 @@
 #include <boost/pfr/flat/functors.hpp>
 #include <boost/pfr/flat/io.hpp>
 
+#include <iosfwd>
+
 /// \def BOOST_PFR_FLAT_FUNCTIONS_FOR(T)
 /// Defines comparison operators and stream operators for T.
 /// If POD is comparable or streamable using it's own operator (but not it's conversion operator), then the original operator is used.
@@ -76,6 +78,86 @@
     }                                                                                                                               \
 /**/
 
+/// \def BOOST_PFR_FLAT_FUNCTIONS_DECLARE(T)
+/// Declares comparison operators, stream operators for `char` streams and `hash_value` for T, without defining them.
+/// Use it in a header, in the namespace of T. Define the functions in exactly one translation unit using BOOST_PFR_FLAT_FUNCTIONS_DEFINE.
+///
+/// Unlike BOOST_PFR_FLAT_FUNCTIONS_FOR, the functions are not inline. So the reflection and
+/// the comparison/printing internals for T are instantiated only once in the whole program, rather than in each translation unit
+/// that uses the operators.
+///
+/// \b Example:
+/// \code
+///     // my_struct.hpp
+///     #include <boost/pfr/flat/functions_for.hpp>
+///     namespace my_ns {
+///         struct my_struct { int i; short s; };
+///         BOOST_PFR_FLAT_FUNCTIONS_DECLARE(my_struct)
+///     }
+///
+///     // my_struct.cpp
+///     #include "my_struct.hpp"
+///     namespace my_ns {
+///         BOOST_PFR_FLAT_FUNCTIONS_DEFINE(my_struct)
+///     }
+/// \endcode
+///
+/// \podops for other ways to define operators and more details.
+///
+/// \b Declares \b following \b for \b T:
+/// \code
+/// bool operator==(const T& lhs, const T& rhs) noexcept;
+/// bool operator!=(const T& lhs, const T& rhs) noexcept;
+/// bool operator< (const T& lhs, const T& rhs) noexcept;
+/// bool operator> (const T& lhs, const T& rhs) noexcept;
+/// bool operator<=(const T& lhs, const T& rhs) noexcept;
+/// bool operator>=(const T& lhs, const T& rhs) noexcept;
+///
+/// std::ostream& operator<<(std::ostream& out, const T& value);
+/// std::istream& operator>>(std::istream& in, T& value);
+///
+/// // helper function for Boost unordered containers and boost::hash<>.
+/// std::size_t hash_value(const T& value) noexcept;
+/// \endcode
+
+#define BOOST_PFR_FLAT_FUNCTIONS_DECLARE(T)                             \
+    bool operator==(const T& lhs, const T& rhs) noexcept;               \
+    bool operator!=(const T& lhs, const T& rhs) noexcept;               \
+    bool operator< (const T& lhs, const T& rhs) noexcept;               \
+    bool operator> (const T& lhs, const T& rhs) noexcept;               \
+    bool operator<=(const T& lhs, const T& rhs) noexcept;               \
+    bool operator>=(const T& lhs, const T& rhs) noexcept;               \
+    ::std::ostream& operator<<(::std::ostream& out, const T& value);    \
+    ::std::istream& operator>>(::std::istream& in, T& value);           \
+    std::size_t hash_value(const T& v) noexcept;                        \
+/**/
+
+/// \def BOOST_PFR_FLAT_FUNCTIONS_DEFINE(T)
+/// Defines the functions declared by BOOST_PFR_FLAT_FUNCTIONS_DECLARE for T.
+/// Must be used exactly once in the program, in the namespace of T.
+///
+/// \rcast
+
+#define BOOST_PFR_FLAT_FUNCTIONS_DEFINE(T)                                                                              \
+    bool operator==(const T& lhs, const T& rhs) noexcept { return ::boost::pfr::flat_equal_to<T>{}(lhs, rhs);      }    \
+    bool operator!=(const T& lhs, const T& rhs) noexcept { return ::boost::pfr::flat_not_equal<T>{}(lhs, rhs);     }    \
+    bool operator< (const T& lhs, const T& rhs) noexcept { return ::boost::pfr::flat_less<T>{}(lhs, rhs);          }    \
+    bool operator> (const T& lhs, const T& rhs) noexcept { return ::boost::pfr::flat_greater<T>{}(lhs, rhs);       }    \
+    bool operator<=(const T& lhs, const T& rhs) noexcept { return ::boost::pfr::flat_less_equal<T>{}(lhs, rhs);    }    \
+    bool operator>=(const T& lhs, const T& rhs) noexcept { return ::boost::pfr::flat_greater_equal<T>{}(lhs, rhs); }    \
+    ::std::ostream& operator<<(::std::ostream& out, const T& value) {                                                   \
+        ::boost::pfr::flat_write(out, value);                                                                           \
+        return out;                                                                                                     \
+    }                                                                                                                   \
+    ::std::istream& operator>>(::std::istream& in, T& value) {                                                          \
+        ::boost::pfr::flat_read(in, value);                                                                             \
+        return in;                                                                                                      \
+    }                                                                                                                   \
+    std::size_t hash_value(const T& v) noexcept {                                                                       \
+        return ::boost::pfr::flat_hash<T>{}(v);                                                                         \
+    }                                                                                                                   \
+/**/
+
 #endif // BOOST_PFR_FLAT_FUNCTIONS_FOR_HPP
 
 
@@ -0,0 +1,392 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_FLAT_NPY_HPP
+#define BOOST_PFR_FLAT_NPY_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <boost/pfr/detail/posix_file.hpp>
+#include <boost/pfr/flat/core.hpp>
+#include <boost/pfr/flat/tuple_size.hpp>
+
+/// \file boost/pfr/flat/npy.hpp
+/// Contains boost::pfr::write_npy and boost::pfr::map_npy that store arrays of PODs in the NumPy `.npy` format.
+///
+/// Fields of the \flattening{flattened} POD become the fields of a NumPy structured type named `f0`, `f1`... like the
+/// fields of the NumPy types created without names. Padding between the fields is described as unnamed void fields, so the
+/// records are written and mapped as is. Files could be loaded with `numpy.load(path, mmap_mode='r')` without conversion.
+///
+/// \b Requires: POSIX.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    ///////////////////// NumPy type descriptors
+    inline char npy_byte_order() noexcept {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return '>';
+#else
+        return '<';
+#endif
+    }
+
+    template <class F>
+    std::string npy_format() {
+        static_assert(
+            std::is_arithmetic<F>::value,
+            "====================> Boost.PFR: NumPy files require flattened fields of arithmetic types"
+        );
+        static_assert(
+            !std::is_floating_point<F>::value || (std::numeric_limits<F>::is_iec559 && (sizeof(F) == 4 || sizeof(F) == 8)),
+            "====================> Boost.PFR: NumPy files support only IEEE 754 float and double floating point fields"
+        );
+
+        std::string result(1, sizeof(F) == 1 ? '|' : detail::npy_byte_order());
+        if (std::is_same<F, bool>::value) {
+            result += 'b';
+        } else if (std::is_same<F, char>::value) {
+            result += 'S';
+        } else if (std::is_floating_point<F>::value) {
+            result += 'f';
+        } else {
+            result += (std::is_signed<F>::value ? 'i' : 'u');
+        }
+        result += std::to_string(sizeof(F));
+        return result;
+    }
+
+    inline void npy_append_padding(std::string& descr, std::size_t size) {
+        descr += "('', '|V";
+        descr += std::to_string(size);
+        descr += "'), ";
+    }
+
+    template <class T, std::size_t... I>
+    std::string npy_descr(std::index_sequence<I...>) {
+        const T value{};
+        const std::size_t offsets[] = {
+            static_cast<std::size_t>(
+                reinterpret_cast<const unsigned char*>(&::boost::pfr::flat_get<I>(value)) - reinterpret_cast<const unsigned char*>(&value)
+            )...,
+            sizeof(T)
+        };
+        const std::size_t sizes[] = {sizeof(::boost::pfr::flat_tuple_element_t<I, T>)..., 0};
+        const std::string formats[] = {detail::npy_format<::boost::pfr::flat_tuple_element_t<I, T>>()..., std::string()};
+
+        // Same formatting as the `repr` of `numpy.dtype.descr`
+        std::string result = "[";
+        std::size_t end = 0;
+        for (std::size_t i = 0; i < sizeof...(I); ++i) {
+            if (offsets[i] > end) {
+                detail::npy_append_padding(result, offsets[i] - end);
+            }
+            result += "('f";
+            result += std::to_string(i);
+            result += "', '";
+            result += formats[i];
+            result += "'), ";
+            end = offsets[i] + sizes[i];
+        }
+        if (sizeof(T) > end) {
+            detail::npy_append_padding(result, sizeof(T) - end);
+        }
+        if (result.size() > 1) {
+            result.resize(result.size() - 2);
+        }
+        result += ']';
+        return result;
+    }
+
+    template <class T>
+    std::string npy_descr() {
+        static_assert(
+            std::is_trivially_copyable<T>::value && !std::is_polymorphic<T>::value,
+            "====================> Boost.PFR: NumPy files require trivially copyable aggregates"
+        );
+        return detail::npy_descr<T>(std::make_index_sequence<::boost::pfr::flat_tuple_size_v<T>>{});
+    }
+
+    constexpr unsigned char npy_magic[] = {0x93, 'N', 'U', 'M', 'P', 'Y'};
+    constexpr std::size_t npy_alignment = 64;
+
+    /// \return file header for `count` records with the `descr` type.
+    inline std::string npy_header(const std::string& descr, std::size_t count) {
+        const std::string dict = "{'descr': " + descr + ", 'fortran_order': False, 'shape': (" + std::to_string(count) + ",), }";
+
+        // Version 1.0 stores the header length in 2 bytes, version 2.0 in 4 bytes
+        std::size_t preamble = sizeof(npy_magic) + 2 + 2;
+        if (preamble + dict.size() + 1 > 0xFFFF) {
+            preamble = sizeof(npy_magic) + 2 + 4;
+        }
+        const std::size_t total = (preamble + dict.size() + 1 + npy_alignment - 1) / npy_alignment * npy_alignment;
+        const std::size_t length = total - preamble;
+
+        std::string result(reinterpret_cast<const char*>(npy_magic), sizeof(npy_magic));
+        result += static_cast<char>(preamble == sizeof(npy_magic) + 4 ? 1 : 2);
+        result += '\0';
+        for (std::size_t i = 0; i < preamble - sizeof(npy_magic) - 2; ++i) {
+            result += static_cast<char>((length >> (8 * i)) & 0xFF);
+        }
+        result += dict;
+        result.append(length - dict.size() - 1, ' ');
+        result += '\n';
+        return result;
+    }
+
+    ///////////////////// Parsing of the header dictionary
+    //
+    // Only the dictionaries written by NumPy and write_npy are supported: keys in any order, values in `repr` format.
+    class npy_header_parser {
+    public:
+        npy_header_parser(const char* first, const char* last) noexcept
+            : first_(first), last_(last)
+        {}
+
+        /// \return the value of `key` as a string of characters, empty if there is no such key.
+        std::string value(const char* key) const {
+            const std::string pattern = std::string("'") + key + "':";
+            const char* it = std::search(first_, last_, pattern.begin(), pattern.end());
+            if (it == last_) {
+                return std::string();
+            }
+            it += pattern.size();
+            while (it != last_ && *it == ' ') {
+                ++it;
+            }
+
+            // Values end at the comma outside of the brackets and the quotes
+            const char* const begin = it;
+            int depth = 0;
+            bool quoted = false;
+            for (; it != last_; ++it) {
+                const char c = *it;
+                if (quoted) {
+                    quoted = (c != '\'');
+                } else if (c == '\'') {
+                    quoted = true;
+                } else if (c == '[' || c == '(') {
+                    ++depth;
+                } else if (c == ']' || c == ')') {
+                    if (!depth) {
+                        break;
+                    }
+                    --depth;
+                } else if ((c == ',' || c == '}') && !depth) {
+                    break;
+                }
+            }
+            return std::string(begin, it);
+        }
+
+    private:
+        const char* first_;
+        const char* last_;
+    };
+
+    /// \return formats of the fields of the `descr` list separated by commas, without the field names. Formats of the
+    /// padding are `|V<size>`, so layouts that differ only in the names of the fields have the same formats.
+    inline std::string npy_formats(const std::string& descr) {
+        std::string result;
+        std::size_t quoted_in_tuple = 0;
+        for (std::size_t i = 0; i < descr.size(); ++i) {
+            if (descr[i] == '(') {
+                quoted_in_tuple = 0;
+            } else if (descr[i] == '\'') {
+                const std::size_t end = descr.find('\'', i + 1);
+                if (end == std::string::npos) {
+                    return std::string();
+                }
+                if (++quoted_in_tuple == 2) {
+                    result.append(descr, i + 1, end - i - 1);
+                    result += ',';
+                }
+                i = end;
+            }
+        }
+        return result;
+    }
+
+    [[noreturn]] inline void npy_throw(const char* path, const char* what) {
+        throw std::runtime_error(std::string("boost::pfr::map_npy: ") + path + ": " + what);
+    }
+
+    /// \return count of records from the `shape` value of a one dimensional array.
+    inline std::size_t npy_parse_shape(const char* path, const std::string& shape) {
+        std::size_t i = 0;
+        if (shape.size() < 3 || shape[i++] != '(') {
+            detail::npy_throw(path, "shape is not a tuple");
+        }
+
+        std::size_t count = 0;
+        const std::size_t digits = i;
+        for (; i < shape.size() && shape[i] >= '0' && shape[i] <= '9'; ++i) {
+            const std::size_t digit = static_cast<std::size_t>(shape[i] - '0');
+            if (count > ((std::numeric_limits<std::size_t>::max)() - digit) / 10) {
+                detail::npy_throw(path, "shape is too big");
+            }
+            count = count * 10 + digit;
+        }
+        if (i == digits || shape.compare(i, std::string::npos, ",)") != 0) {
+            detail::npy_throw(path, "only one dimensional arrays are supported");
+        }
+        return count;
+    }
+
+} // namespace detail
+
+/// \brief Writes `count` records starting from `records` into a new `.npy` file at `path`, replacing the existing file.
+///
+/// The header and the records are written with a single `writev` call for most of the files.
+///
+/// \throws std::system_error if the file could not be written.
+///
+/// \b Example:
+/// \code
+///     struct tick { std::int64_t timestamp; double price; std::int32_t qty; };
+///     std::vector<tick> ticks = ...;
+///     boost::pfr::write_npy("ticks.npy", ticks.data(), ticks.size());
+///
+///     // Python:
+///     //  ticks = numpy.load("ticks.npy", mmap_mode='r')
+///     //  ticks.dtype     # dtype([('f0', '<i8'), ('f1', '<f8'), ('f2', '<i4'), ('', '|V4')])
+/// \endcode
+template <class T>
+void write_npy(const char* path, const T* records, std::size_t count) {
+    const std::string header = detail::npy_header(detail::npy_descr<T>(), count);
+    const detail::file_descriptor file(path, O_WRONLY | O_CREAT | O_TRUNC);
+
+    ::iovec iov[2];
+    iov[0].iov_base = const_cast<char*>(header.data());
+    iov[0].iov_len = header.size();
+    iov[1].iov_base = const_cast<T*>(records);
+    iov[1].iov_len = count * sizeof(T);
+    detail::write_all(file.get(), iov, count ? 2 : 1);
+}
+
+/// \overload write_npy
+///
+/// `records` must be a contiguous range with `data()` and `size()` member functions, for example `std::vector` or
+/// `std::span`.
+template <class ContiguousRange>
+void write_npy(const char* path, const ContiguousRange& records) {
+    boost::pfr::write_npy(path, records.data(), records.size());
+}
+
+/// \brief Read only records of a `.npy` file mapped into memory by boost::pfr::map_npy.
+///
+/// Records stay valid until the object is destroyed or assigned.
+template <class T>
+class mapped_npy {
+public:
+    typedef T                   value_type;
+    typedef const T*            const_iterator;
+    typedef const T*            iterator;
+
+    mapped_npy() = default;
+    mapped_npy(mapped_npy&&) noexcept = default;
+    mapped_npy& operator=(mapped_npy&&) noexcept = default;
+
+    const T* data() const noexcept          { return records_; }
+    std::size_t size() const noexcept       { return size_; }
+    bool empty() const noexcept             { return size_ == 0; }
+    const T* begin() const noexcept         { return records_; }
+    const T* end() const noexcept           { return records_ + size_; }
+
+    const T& operator[](std::size_t i) const noexcept {
+        return records_[i];
+    }
+
+private:
+    template <class U>
+    friend mapped_npy<U> map_npy(const char* path);
+
+    detail::mapped_file     file_;
+    const T*                records_ = nullptr;
+    std::size_t             size_ = 0;
+};
+
+/// \brief Maps the records of the `.npy` file at `path` into memory without copying them.
+///
+/// The file must contain a one dimensional array of the structured type that boost::pfr::write_npy writes for `T`, so
+/// NumPy arrays with the same field formats, offsets and size are accepted too. Field names are not checked.
+///
+/// \throws std::system_error if the file could not be mapped, std::runtime_error if the file is not a `.npy` file
+/// or its type does not match `T`.
+///
+/// \b Example:
+/// \code
+///     const boost::pfr::mapped_npy<tick> ticks = boost::pfr::map_npy<tick>("ticks.npy");
+///     for (const tick& t : ticks) {
+///         // ...
+///     }
+/// \endcode
+template <class T>
+mapped_npy<T> map_npy(const char* path) {
+    mapped_npy<T> result;
+    result.file_ = detail::mapped_file(path);
+    const unsigned char* const data = result.file_.data();
+    const std::size_t size = result.file_.size();
+
+    if (size < sizeof(detail::npy_magic) + 4 || std::memcmp(data, detail::npy_magic, sizeof(detail::npy_magic)) != 0) {
+        detail::npy_throw(path, "not a NumPy file");
+    }
+    const unsigned version = data[sizeof(detail::npy_magic)];
+    if (version < 1 || version > 3) {
+        detail::npy_throw(path, "unsupported version of the NumPy file format");
+    }
+    const std::size_t length_bytes = (version == 1 ? 2 : 4);
+    std::size_t offset = sizeof(detail::npy_magic) + 2 + length_bytes;
+    if (size < offset) {
+        detail::npy_throw(path, "truncated header");
+    }
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < length_bytes; ++i) {
+        length |= static_cast<std::size_t>(data[sizeof(detail::npy_magic) + 2 + i]) << (8 * i);
+    }
+    if (size - offset < length) {
+        detail::npy_throw(path, "truncated header");
+    }
+
+    const char* const header = reinterpret_cast<const char*>(data + offset);
+    const detail::npy_header_parser parser(header, header + length);
+    offset += length;
+
+    if (detail::npy_formats(parser.value("descr")) != detail::npy_formats(detail::npy_descr<T>())) {
+        detail::npy_throw(path, "type of the records does not match");
+    }
+    if (parser.value("fortran_order") != "False") {
+        detail::npy_throw(path, "Fortran order is not supported");
+    }
+
+    const std::size_t count = detail::npy_parse_shape(path, parser.value("shape"));
+    if (offset % alignof(T)) {
+        detail::npy_throw(path, "records are not aligned");
+    }
+    if (count > (size - offset) / sizeof(T)) {
+        detail::npy_throw(path, "file ends in the middle of the records");
+    }
+
+    result.records_ = reinterpret_cast<const T*>(data + offset);
+    result.size_ = count;
+    return result;
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_FLAT_NPY_HPP
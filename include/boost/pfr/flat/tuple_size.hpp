@@ -13,6 +13,7 @@
 
 #include <boost/pfr/detail/sequence_tuple.hpp>
 #include <boost/pfr/detail/core14.hpp>
+#include <boost/pfr/detail/reflection_info.hpp>
 
 namespace boost { namespace pfr {
 
@@ -23,7 +24,7 @@ namespace boost { namespace pfr {
 ///     std::array<int, boost::pfr::flat_tuple_size<my_structure>::value > a;
 /// \endcode
 template <class T>
-using flat_tuple_size = boost::pfr::detail::size_t_<decltype(boost::pfr::detail::tie_as_flat_tuple(std::declval<T&>()))::size_v>;
+using flat_tuple_size = boost::pfr::detail::size_t_<boost::pfr::detail::reflection_info<T>.flat_fields_count>;
 
 
 /// \brief `flat_tuple_size_v` is a template variable that contains fields count in a \flattening{flattened} T.
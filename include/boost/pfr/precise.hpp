@@ -8,6 +8,9 @@
 
 /// \file boost/pfr/precise.hpp
 /// Includes all the Boost.PFR headers that do not define `flat_*` functions, except \xmlonly<link linkend='header.boost.pfr.precise.global_ops_hpp'>boost/pfr/precise/global_ops.hpp</link>\endxmlonly
+///
+/// Containers, algorithms, file formats and profiling reports (for example `boost/pfr/precise/btree_map.hpp`) are not included
+/// to keep the compile times low, include their headers directly.
 
 #include <boost/pfr/precise/core.hpp>
 #include <boost/pfr/precise/functors.hpp>
@@ -0,0 +1,280 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_ARGSORT_HPP
+#define BOOST_PFR_PRECISE_ARGSORT_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/key_fields.hpp>
+#include <boost/pfr/detail/normalized_key.hpp>
+#include <boost/pfr/detail/prefetch.hpp>
+#include <boost/pfr/precise/core.hpp>
+#include <boost/pfr/precise/tuple_size.hpp>
+
+/// \file boost/pfr/precise/argsort.hpp
+/// Contains functions for sorting by key fields without moving the whole records: boost::pfr::argsort_by computes the permutation
+/// that sorts the records, boost::pfr::apply_permutation reorders the records or columns.
+///
+/// Both functions accept either a random access range of aggregates (array of structures), or an aggregate which fields are
+/// random access ranges of the same size (structure of arrays, for example `struct trades { std::vector<int> id; std::vector<double> price; };`).
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    template <class R, class = void>
+    struct is_range : std::false_type {};
+
+    template <class R>
+    struct is_range<R, decltype(void(std::begin(std::declval<R&>())), void(std::end(std::declval<R&>())))> : std::true_type {};
+
+    template <class It>
+    std::size_t range_size(It first, It last) {
+        return static_cast<std::size_t>(std::distance(first, last));
+    }
+
+    /// Row accessor of an array of structures: returns the key fields of the record `i`.
+    template <class It, std::size_t... I>
+    struct aos_rows {
+        typedef detail::key_fields<typename std::iterator_traits<It>::value_type, I...> key_fields_t;
+
+        It first;
+        std::size_t size;
+
+        auto key(std::size_t i) const {
+            return key_fields_t::tie(first[i]);
+        }
+    };
+
+    template <std::size_t... I, class Range>
+    auto make_rows(Range& range, std::true_type /*is_range*/) {
+        using std::begin;
+        using std::end;
+        return aos_rows<decltype(begin(range)), I...>{begin(range), detail::range_size(begin(range), end(range))};
+    }
+
+    /// Row accessor of a structure of arrays: returns the elements with index `i` of the key columns.
+    template <class Soa, class Columns>
+    struct soa_rows;
+
+    template <class Soa, std::size_t... I>
+    struct soa_rows<Soa, std::index_sequence<I...>> {
+        const Soa* soa;
+        std::size_t size;
+
+        auto key(std::size_t i) const {
+            using std::begin;
+            return std::tie(begin(::boost::pfr::get<I>(*soa))[i]...);
+        }
+    };
+
+    template <std::size_t... I, class Soa>
+    auto make_rows(const Soa& soa, std::false_type /*is_range*/) {
+        typedef std::conditional_t<
+            sizeof...(I) == 0,
+            std::make_index_sequence< ::boost::pfr::tuple_size_v<Soa> >,
+            std::index_sequence<I...>
+        > columns_t;
+
+        using std::begin;
+        using std::end;
+        const auto& column = ::boost::pfr::get<0>(soa);
+        return soa_rows<Soa, columns_t>{&soa, detail::range_size(begin(column), end(column))};
+    }
+
+    template <class Tuple>
+    struct decay_tuple;
+
+    template <class... T>
+    struct decay_tuple<std::tuple<T...>> {
+        typedef std::tuple<std::decay_t<T>...> type;
+    };
+
+    template <std::size_t Words>
+    struct argsort_entry {
+        std::int64_t words[Words];
+        std::size_t index;
+
+        friend bool operator<(const argsort_entry& lhs, const argsort_entry& rhs) noexcept {
+            for (std::size_t w = 0; w < Words; ++w) {
+                if (lhs.words[w] != rhs.words[w]) {
+                    return lhs.words[w] < rhs.words[w];
+                }
+            }
+            return lhs.index < rhs.index;
+        }
+    };
+
+    /// Keys with only integral fields: sorting compact normalized copies of the keys.
+    template <class Rows>
+    std::vector<std::size_t> argsort_rows(const Rows& rows, std::true_type /*normalizable*/) {
+        constexpr std::size_t words = std::tuple_size<decltype(rows.key(0))>::value;
+
+        std::vector<argsort_entry<words>> entries(rows.size);
+        for (std::size_t i = 0; i < rows.size; ++i) {
+            detail::normalize_tuple(rows.key(i), entries[i].words, std::make_index_sequence<words>{});
+            entries[i].index = i;
+        }
+        std::sort(entries.begin(), entries.end());
+
+        std::vector<std::size_t> permutation(rows.size);
+        for (std::size_t i = 0; i < rows.size; ++i) {
+            permutation[i] = entries[i].index;
+        }
+        return permutation;
+    }
+
+    /// Generic keys: sorting the indexes, comparing key fields in place.
+    template <class Rows>
+    std::vector<std::size_t> argsort_rows(const Rows& rows, std::false_type /*normalizable*/) {
+        constexpr std::size_t words = std::tuple_size<decltype(rows.key(0))>::value;
+
+        std::vector<std::size_t> permutation(rows.size);
+        for (std::size_t i = 0; i < rows.size; ++i) {
+            permutation[i] = i;
+        }
+
+        std::stable_sort(permutation.begin(), permutation.end(), [&rows](std::size_t lhs, std::size_t rhs) {
+            return detail::compare_tuples(rows.key(lhs), rows.key(rhs), std::make_index_sequence<words>{}) < 0;
+        });
+        return permutation;
+    }
+
+    /// Gathers the values with indexes from `permutation` into a buffer and copies them back.
+    /// Writes are sequential and the reads are prefetched, the fastest way for small trivially copyable values.
+    template <class It, class Permutation>
+    void apply_permutation_column(It first, const Permutation& permutation, std::true_type /*gather*/) {
+        typedef typename std::iterator_traits<It>::value_type value_t;
+        constexpr std::size_t prefetch_distance = 16;
+
+        const std::size_t n = permutation.size();
+        std::vector<value_t> gathered;
+        gathered.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i + prefetch_distance < n) {
+                detail::prefetch(std::addressof(first[permutation[i + prefetch_distance]]));
+            }
+            gathered.push_back(first[permutation[i]]);
+        }
+
+        std::copy(gathered.begin(), gathered.end(), first);
+    }
+
+    /// Follows the cycles of the permutation, moving each value once.
+    template <class It, class Permutation>
+    void apply_permutation_column(It first, const Permutation& permutation, std::false_type /*gather*/) {
+        typedef typename std::iterator_traits<It>::value_type value_t;
+
+        const std::size_t n = permutation.size();
+        std::vector<bool> done(n);
+        for (std::size_t start = 0; start < n; ++start) {
+            if (done[start] || static_cast<std::size_t>(permutation[start]) == start) {
+                continue;
+            }
+
+            value_t tmp = std::move(first[start]);
+            std::size_t dst = start;
+            for (;;) {
+                const std::size_t src = static_cast<std::size_t>(permutation[dst]);
+                done[dst] = true;
+                if (src == start) {
+                    first[dst] = std::move(tmp);
+                    break;
+                }
+
+                detail::prefetch(std::addressof(first[permutation[src]]));
+                first[dst] = std::move(first[src]);
+                dst = src;
+            }
+        }
+    }
+
+    template <class Column, class Permutation>
+    void apply_permutation_range(Column& column, const Permutation& permutation) {
+        using std::begin;
+        typedef typename std::iterator_traits<decltype(begin(column))>::value_type value_t;
+        detail::apply_permutation_column(
+            begin(column),
+            permutation,
+            std::integral_constant<bool, std::is_trivially_copyable<value_t>::value && sizeof(value_t) <= detail::cache_line_size>{}
+        );
+    }
+
+    template <class Range, class Permutation>
+    void apply_permutation_impl(Range& range, const Permutation& permutation, std::true_type /*is_range*/) {
+        detail::apply_permutation_range(range, permutation);
+    }
+
+    template <class Soa, class Permutation>
+    void apply_permutation_impl(Soa& soa, const Permutation& permutation, std::false_type /*is_range*/) {
+        ::boost::pfr::for_each_field(soa, [&permutation](auto& column) {
+            detail::apply_permutation_range(column, permutation);
+        });
+    }
+
+} // namespace detail
+
+/// \brief Returns the permutation that stably sorts `range_or_soa` by the fields `I...` (by all the fields if `I...` is empty).
+///
+/// Only the key fields are read. If all of them are integral or enums, compact normalized copies of the keys are sorted;
+/// otherwise the indexes are sorted, comparing the key fields in place. Records are not moved.
+///
+/// \param range_or_soa Random access range of aggregates, or an aggregate with random access ranges of equal size as fields.
+/// For the latter `I...` are the indexes of the key columns.
+///
+/// \return `std::vector<std::size_t> p`, such that `p[i]` is the index of the record that goes to the position `i` of the sorted sequence.
+///
+/// \b Example:
+/// \code
+///     struct trade { int instrument; long timestamp; char payload[200]; };
+///     std::vector<trade> trades = load_trades();
+///     const auto p = boost::pfr::argsort_by<0, 1>(trades);    // Sort by instrument and timestamp
+///     boost::pfr::apply_permutation(trades, p);
+/// \endcode
+template <std::size_t... I, class RangeOrSoa>
+std::vector<std::size_t> argsort_by(const RangeOrSoa& range_or_soa) {
+    const auto rows = detail::make_rows<I...>(range_or_soa, detail::is_range<const RangeOrSoa>{});
+    typedef typename detail::decay_tuple<decltype(rows.key(0))>::type key_t;
+    return detail::argsort_rows(rows, detail::all_fields_normalizable<key_t>{});
+}
+
+/// \brief Reorders the records of `range_or_soa` in place, so that the record with index `permutation[i]` goes to the position `i`.
+///
+/// Small trivially copyable values are gathered through a temporary buffer, other values are moved along the cycles of the
+/// permutation, so each value is moved once.
+///
+/// \param range_or_soa Random access range of aggregates, or an aggregate with random access ranges of equal size as fields.
+/// For the latter each of the ranges is reordered.
+/// \param permutation Random access range of indexes, for example the result of boost::pfr::argsort_by.
+///
+/// \pre `permutation` is a permutation of [0, size of `range_or_soa`).
+///
+/// \b Example:
+/// \code
+///     struct trades { std::vector<int> instrument; std::vector<double> price; std::vector<std::string> comment; };
+///     trades t = load_trades();
+///     boost::pfr::apply_permutation(t, boost::pfr::argsort_by<0>(t));    // Sort all columns by instrument
+/// \endcode
+template <class RangeOrSoa, class Permutation>
+void apply_permutation(RangeOrSoa& range_or_soa, const Permutation& permutation) {
+    detail::apply_permutation_impl(range_or_soa, permutation, detail::is_range<RangeOrSoa>{});
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_ARGSORT_HPP
@@ -0,0 +1,647 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_BTREE_MAP_HPP
+#define BOOST_PFR_PRECISE_BTREE_MAP_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/key_fields.hpp>
+#include <boost/pfr/detail/normalized_key.hpp>
+
+/// \file boost/pfr/precise/btree_map.hpp
+/// Contains B+tree based ordered map with aggregates as keys.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    /// Inserts a value constructed from `args` at position `pos` of the `n` values in the raw storage `base`.
+    template <class V, class... Args>
+    void btree_insert_at(V* base, std::size_t n, std::size_t pos, Args&&... args) {
+        if (pos == n) {
+            ::new (static_cast<void*>(base + n)) V(std::forward<Args>(args)...);
+            return;
+        }
+
+        V tmp(std::forward<Args>(args)...);
+        ::new (static_cast<void*>(base + n)) V(std::move(base[n - 1]));
+        std::move_backward(base + pos, base + n - 1, base + n);
+        base[pos] = std::move(tmp);
+    }
+
+    /// Moves values [from, n) of `src` into the raw storage `dst` and destroys them in `src`.
+    template <class V>
+    void btree_move_tail(V* src, std::size_t from, std::size_t n, V* dst) {
+        for (std::size_t i = from; i < n; ++i) {
+            ::new (static_cast<void*>(dst + (i - from))) V(std::move(src[i]));
+            src[i].~V();
+        }
+    }
+
+    template <class V>
+    void btree_destroy(V* base, std::size_t n) noexcept {
+        for (std::size_t i = 0; i < n; ++i) {
+            base[i].~V();
+        }
+    }
+
+    /// Keys of a B+tree node. Generic version: binary search with three-way comparison of the key fields.
+    template <class Key, std::size_t N, bool Normalized = normalized_key<Key>::value>
+    class btree_keys {
+        alignas(Key) unsigned char storage_[sizeof(Key) * N];
+
+    public:
+        typedef const Key& prepared_type;
+
+        static const Key& prepare(const Key& key) noexcept {
+            return key;
+        }
+
+        Key* data() noexcept { return reinterpret_cast<Key*>(storage_); }
+        const Key* data() const noexcept { return reinterpret_cast<const Key*>(storage_); }
+
+        template <bool OrEqual>
+        std::size_t count_less(std::size_t n, const Key& x) const {
+            const Key* const keys = data();
+            std::size_t first = 0;
+            while (n > 0) {
+                const std::size_t half = n / 2;
+                const int cmp = detail::key_fields<Key>::compare(keys[first + half], x);
+                if (cmp < 0 || (OrEqual && cmp == 0)) {
+                    first += half + 1;
+                    n -= half + 1;
+                } else {
+                    n = half;
+                }
+            }
+
+            return first;
+        }
+
+        bool equal_at(std::size_t i, const Key& x) const {
+            return detail::key_fields<Key>::compare(data()[i], x) == 0;
+        }
+
+        template <class K>
+        void insert(std::size_t n, std::size_t pos, K&& key) {
+            detail::btree_insert_at(data(), n, pos, std::forward<K>(key));
+        }
+
+        void move_tail(std::size_t from, std::size_t n, btree_keys& dst) {
+            detail::btree_move_tail(data(), from, n, dst.data());
+        }
+    };
+
+    /// Keys of a B+tree node. Keys with only integral fields are also stored normalized in SoA layout for SIMD search.
+    template <class Key, std::size_t N>
+    class btree_keys<Key, N, true> {
+        typedef normalized_key<Key> traits_t;
+
+        alignas(Key) unsigned char storage_[sizeof(Key) * N];
+        std::int64_t words_[traits_t::words][N] = {};
+
+    public:
+        struct prepared_type {
+            std::int64_t words[traits_t::words];
+        };
+
+        static prepared_type prepare(const Key& key) noexcept {
+            prepared_type res;
+            traits_t::normalize(key, res.words);
+            return res;
+        }
+
+        Key* data() noexcept { return reinterpret_cast<Key*>(storage_); }
+        const Key* data() const noexcept { return reinterpret_cast<const Key*>(storage_); }
+
+        template <bool OrEqual>
+        std::size_t count_less(std::size_t n, const prepared_type& x) const noexcept {
+            return detail::normalized_count_less<OrEqual>(words_, n, x.words);
+        }
+
+        bool equal_at(std::size_t i, const prepared_type& x) const noexcept {
+            bool equal = true;
+            for (std::size_t w = 0; w < traits_t::words; ++w) {
+                equal = equal & (words_[w][i] == x.words[w]);
+            }
+            return equal;
+        }
+
+        template <class K>
+        void insert(std::size_t n, std::size_t pos, K&& key) {
+            const prepared_type x = prepare(key);
+            detail::btree_insert_at(data(), n, pos, std::forward<K>(key));
+            for (std::size_t w = 0; w < traits_t::words; ++w) {
+                std::memmove(&words_[w][pos + 1], &words_[w][pos], (n - pos) * sizeof(std::int64_t));
+                words_[w][pos] = x.words[w];
+            }
+        }
+
+        void move_tail(std::size_t from, std::size_t n, btree_keys& dst) {
+            detail::btree_move_tail(data(), from, n, dst.data());
+            for (std::size_t w = 0; w < traits_t::words; ++w) {
+                std::memcpy(&dst.words_[w][0], &words_[w][from], (n - from) * sizeof(std::int64_t));
+            }
+        }
+    };
+
+} // namespace detail
+
+/// Tag for constructing containers from sorted input without duplicates, for example
+/// `boost::pfr::btree_map<K, V> m(boost::pfr::sorted_unique, v.begin(), v.end())`.
+struct sorted_unique_t {};
+
+/// \copydoc boost::pfr::sorted_unique_t
+constexpr sorted_unique_t sorted_unique{};
+
+/// \brief Ordered map from `Key` to `T` based on B+tree, that keeps up to `NodeSize` keys in each node.
+///
+/// `Key` is an integral type, enum or an aggregate. Aggregate keys are compared lexicographically field by field, like
+/// boost::pfr::less does. If all the fields of `Key` are integral or enums, then each node additionally keeps the keys
+/// converted to fixed width integers in a structure-of-arrays layout, and searches them without branches (with AVX2
+/// instructions if they are enabled at compile time). Other keys are searched with binary search, comparing each field once.
+///
+/// Unlike `std::map` there's one allocation per `NodeSize` values and values are stored contiguously in the leaf nodes.
+/// Iterators are forward iterators over values in key order, that are invalidated by insertions. Values could not be erased
+/// individually.
+///
+/// \b Requires: copy and move constructors of `Key` do not throw.
+///
+/// \b Example:
+/// \code
+///     struct order_key { std::int32_t instrument; std::int64_t timestamp; };
+///
+///     boost::pfr::btree_map<order_key, double> prices;
+///     prices.try_emplace(order_key{1, 100}, 42.0);
+///     prices[order_key{1, 200}] = 43.0;
+///     prices[order_key{2, 100}] = 1.0;
+///
+///     // Range scan over all the prices of instrument 1
+///     auto it = prices.lower_bound(order_key{1, INT64_MIN});
+///     for (; it != prices.end() && it->first.instrument == 1; ++it) {
+///         std::cout << it->first.timestamp << ' ' << it->second << '\n';
+///     }
+/// \endcode
+template <class Key, class T, std::size_t NodeSize = 32>
+class btree_map {
+    static_assert(NodeSize >= 4 && NodeSize % 4 == 0, "====================> Boost.PFR: NodeSize must be a multiple of 4");
+
+    typedef detail::btree_keys<Key, NodeSize> keys_t;
+    typedef typename keys_t::prepared_type prepared_t;
+
+    struct node_base {
+        std::size_t count = 0;
+    };
+
+    struct leaf_node: node_base {
+        keys_t keys;
+        alignas(T) unsigned char values_storage[sizeof(T) * NodeSize];
+        leaf_node* next = nullptr;
+
+        T* values() noexcept { return reinterpret_cast<T*>(values_storage); }
+    };
+
+    struct inner_node: node_base {
+        keys_t keys;                            // keys[i] is the minimal key in children[i + 1]
+        node_base* children[NodeSize + 1];
+    };
+
+    static constexpr std::size_t max_height = 64;
+
+    template <bool Const>
+    class basic_iterator {
+        typedef std::conditional_t<Const, const T, T> mapped_t;
+
+        leaf_node* leaf_ = nullptr;
+        std::size_t pos_ = 0;
+
+        friend class btree_map;
+        template <bool> friend class basic_iterator;
+
+        basic_iterator(leaf_node* leaf, std::size_t pos) noexcept
+            : leaf_(leaf), pos_(pos)
+        {}
+
+    public:
+        typedef std::forward_iterator_tag           iterator_category;
+        typedef std::pair<const Key, T>             value_type;
+        typedef std::pair<const Key&, mapped_t&>    reference;
+        typedef std::ptrdiff_t                      difference_type;
+
+        /// Result of `operator->`, keeps the `reference` to allow `it->first` and `it->second`.
+        struct pointer {
+            reference ref;
+            const reference* operator->() const noexcept { return &ref; }
+        };
+
+        basic_iterator() noexcept = default;
+
+        /// Converts `iterator` to `const_iterator`.
+        template <bool C = Const, class = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& other) noexcept
+            : leaf_(other.leaf_), pos_(other.pos_)
+        {}
+
+        reference operator*() const noexcept {
+            return reference(leaf_->keys.data()[pos_], leaf_->values()[pos_]);
+        }
+
+        pointer operator->() const noexcept {
+            return pointer{**this};
+        }
+
+        basic_iterator& operator++() noexcept {
+            if (++pos_ == leaf_->count) {
+                leaf_ = leaf_->next;
+                pos_ = 0;
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept {
+            basic_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+            return lhs.leaf_ == rhs.leaf_ && lhs.pos_ == rhs.pos_;
+        }
+
+        friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+    };
+
+public:
+    typedef Key                     key_type;
+    typedef T                       mapped_type;
+    typedef std::size_t             size_type;
+    typedef basic_iterator<false>   iterator;
+    typedef basic_iterator<true>    const_iterator;
+
+    /// Constructs an empty map.
+    btree_map() noexcept = default;
+
+    /// Bulk loads the map from the range [first, last) of pairs of key and value.
+    /// Leaves are filled completely, so the construction takes linear time and the map occupies the minimal amount of memory.
+    ///
+    /// \pre Keys in the range are sorted and have no duplicates.
+    template <class InputIt>
+    btree_map(sorted_unique_t, InputIt first, InputIt last)
+        : btree_map()
+    {
+        bulk_load(first, last);
+    }
+
+    btree_map(const btree_map& other)
+        : btree_map()
+    {
+        bulk_load(other.begin(), other.end());
+    }
+
+    btree_map(btree_map&& other) noexcept {
+        swap(other);
+    }
+
+    btree_map& operator=(btree_map other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~btree_map() {
+        clear();
+    }
+
+    void swap(btree_map& other) noexcept {
+        std::swap(root_, other.root_);
+        std::swap(head_, other.head_);
+        std::swap(height_, other.height_);
+        std::swap(size_, other.size_);
+    }
+
+    friend void swap(btree_map& lhs, btree_map& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    /// \return count of values in the map.
+    size_type size() const noexcept { return size_; }
+
+    /// \return true if there's no values in the map.
+    bool empty() const noexcept { return size_ == 0; }
+
+    /// Destroys all the values and frees all the memory.
+    void clear() noexcept {
+        if (height_) {
+            destroy_inner(static_cast<inner_node*>(root_), height_);
+        }
+
+        leaf_node* leaf = head_;
+        while (leaf) {
+            leaf_node* const next = leaf->next;
+            detail::btree_destroy(leaf->keys.data(), leaf->count);
+            detail::btree_destroy(leaf->values(), leaf->count);
+            delete leaf;
+            leaf = next;
+        }
+
+        root_ = nullptr;
+        head_ = nullptr;
+        height_ = 0;
+        size_ = 0;
+    }
+
+    iterator begin() noexcept { return iterator(head_, 0); }
+    const_iterator begin() const noexcept { return const_iterator(head_, 0); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(); }
+    const_iterator end() const noexcept { return const_iterator(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    /// \return iterator to the value with key equal to `key` or end().
+    iterator find(const Key& key) {
+        const prepared_t x = keys_t::prepare(key);
+        const auto pos = leaf_bound<false>(x);
+        return (pos.first && pos.second < pos.first->count && pos.first->keys.equal_at(pos.second, x))
+            ? iterator(pos.first, pos.second)
+            : end();
+    }
+
+    /// \overload find
+    const_iterator find(const Key& key) const {
+        return const_cast<btree_map&>(*this).find(key);
+    }
+
+    /// \return 1 if there's a value with key equal to `key`, 0 otherwise.
+    size_type count(const Key& key) const {
+        return find(key) != end();
+    }
+
+    /// \return iterator to the first value with key not less than `key` or end().
+    iterator lower_bound(const Key& key) {
+        return make_iterator(leaf_bound<false>(keys_t::prepare(key)));
+    }
+
+    /// \overload lower_bound
+    const_iterator lower_bound(const Key& key) const {
+        return const_cast<btree_map&>(*this).lower_bound(key);
+    }
+
+    /// \return iterator to the first value with key greater than `key` or end().
+    iterator upper_bound(const Key& key) {
+        return make_iterator(leaf_bound<true>(keys_t::prepare(key)));
+    }
+
+    /// \overload upper_bound
+    const_iterator upper_bound(const Key& key) const {
+        return const_cast<btree_map&>(*this).upper_bound(key);
+    }
+
+    /// Inserts the value constructed from `args` if there's no value with key equal to `key`.
+    /// \return iterator to the value with key `key` and true if the insertion took place.
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        if (!root_) {
+            return emplace_first(key, std::forward<Args>(args)...);
+        }
+
+        const prepared_t x = keys_t::prepare(key);
+
+        inner_node* path[max_height];
+        std::size_t path_index[max_height];
+        node_base* node = root_;
+        for (std::size_t depth = 0; depth < height_; ++depth) {
+            inner_node* const inner = static_cast<inner_node*>(node);
+            path[depth] = inner;
+            path_index[depth] = inner->keys.template count_less<true>(inner->count, x);
+            node = inner->children[path_index[depth]];
+        }
+
+        leaf_node* leaf = static_cast<leaf_node*>(node);
+        std::size_t pos = leaf->keys.template count_less<false>(leaf->count, x);
+        if (pos < leaf->count && leaf->keys.equal_at(pos, x)) {
+            return {iterator(leaf, pos), false};
+        }
+
+        if (leaf->count == NodeSize) {
+            // Splitting and linking the new leaf before the insertion, so the tree stays valid if constructor of T throws
+            leaf_node* const right = split_leaf(leaf);
+            insert_into_parents(path, path_index, right, &right->keys.data()[0]);
+            if (pos > leaf->count) {
+                pos -= leaf->count;
+                leaf = right;
+            }
+        }
+
+        detail::btree_insert_at(leaf->values(), leaf->count, pos, std::forward<Args>(args)...);
+        leaf->keys.insert(leaf->count, pos, key);
+        ++leaf->count;
+        ++size_;
+        return {iterator(leaf, pos), true};
+    }
+
+    /// Inserts `value.second` with key `value.first` if there's no value with key equal to `value.first`.
+    /// \return iterator to the value with key `value.first` and true if the insertion took place.
+    template <class Pair>
+    std::pair<iterator, bool> insert(Pair&& value) {
+        return try_emplace(value.first, std::forward<Pair>(value).second);
+    }
+
+    /// \return reference to the value with key equal to `key`, inserting a value initialized `T` if there's no such value.
+    T& operator[](const Key& key) {
+        return (*try_emplace(key).first).second;
+    }
+
+private:
+    template <bool OrEqual>
+    std::pair<leaf_node*, std::size_t> leaf_bound(const prepared_t& x) const {
+        node_base* node = root_;
+        if (!node) {
+            return {nullptr, 0};
+        }
+
+        for (std::size_t level = height_; level > 0; --level) {
+            inner_node* const inner = static_cast<inner_node*>(node);
+            node = inner->children[inner->keys.template count_less<true>(inner->count, x)];
+        }
+
+        leaf_node* const leaf = static_cast<leaf_node*>(node);
+        return {leaf, leaf->keys.template count_less<OrEqual>(leaf->count, x)};
+    }
+
+    static iterator make_iterator(std::pair<leaf_node*, std::size_t> pos) noexcept {
+        if (pos.first && pos.second == pos.first->count) {
+            return iterator(pos.first->next, 0);
+        }
+        return iterator(pos.first, pos.second);
+    }
+
+    /// Creates the first leaf. The leaf becomes a part of the tree only after the value is constructed, so the map stays
+    /// empty if constructor of T throws.
+    template <class... Args>
+    std::pair<iterator, bool> emplace_first(const Key& key, Args&&... args) {
+        std::unique_ptr<leaf_node> leaf(new leaf_node);
+        detail::btree_insert_at(leaf->values(), 0, 0, std::forward<Args>(args)...);
+        try {
+            leaf->keys.insert(0, 0, key);
+        } catch (...) {
+            leaf->values()[0].~T();
+            throw;
+        }
+        leaf->count = 1;
+
+        head_ = leaf.release();
+        root_ = head_;
+        size_ = 1;
+        return {iterator(head_, 0), true};
+    }
+
+    /// Moves the upper half of the full `leaf` into a new leaf, that goes right after the `leaf` in the list.
+    static leaf_node* split_leaf(leaf_node* leaf) {
+        leaf_node* const right = new leaf_node;
+        constexpr std::size_t mid = NodeSize / 2;
+        leaf->keys.move_tail(mid, NodeSize, right->keys);
+        detail::btree_move_tail(leaf->values(), mid, NodeSize, right->values());
+        right->count = NodeSize - mid;
+        leaf->count = mid;
+
+        right->next = leaf->next;
+        leaf->next = right;
+        return right;
+    }
+
+    static void inner_insert(inner_node* node, std::size_t index, const Key& separator, node_base* child) {
+        node->keys.insert(node->count, index, separator);
+        std::memmove(&node->children[index + 2], &node->children[index + 1], (node->count - index) * sizeof(node_base*));
+        node->children[index + 1] = child;
+        ++node->count;
+    }
+
+    /// Inserts the `right` node that was split from the node at `path` into the parents, splitting them if required.
+    void insert_into_parents(inner_node* const* path, const std::size_t* path_index, node_base* right, const Key* separator) {
+        std::unique_ptr<Key> carried;   // key that goes to the upper level after a split of an inner node
+
+        for (std::size_t depth = height_; depth-- > 0;) {
+            inner_node* const parent = path[depth];
+            const std::size_t index = path_index[depth];
+            if (parent->count < NodeSize) {
+                inner_insert(parent, index, *separator, right);
+                return;
+            }
+
+            constexpr std::size_t mid = NodeSize / 2;
+            inner_node* const new_inner = new inner_node;
+            std::unique_ptr<Key> promoted(new Key(std::move(parent->keys.data()[mid])));
+            parent->keys.data()[mid].~Key();
+            parent->keys.move_tail(mid + 1, NodeSize, new_inner->keys);
+            std::memcpy(&new_inner->children[0], &parent->children[mid + 1], (NodeSize - mid) * sizeof(node_base*));
+            new_inner->count = NodeSize - mid - 1;
+            parent->count = mid;
+
+            if (index <= mid) {
+                inner_insert(parent, index, *separator, right);
+            } else {
+                inner_insert(new_inner, index - mid - 1, *separator, right);
+            }
+
+            carried = std::move(promoted);
+            separator = carried.get();
+            right = new_inner;
+        }
+
+        inner_node* const root = new inner_node;
+        root->keys.insert(0, 0, *separator);
+        root->children[0] = root_;
+        root->children[1] = right;
+        root->count = 1;
+        root_ = root;
+        ++height_;
+    }
+
+    template <class InputIt>
+    void bulk_load(InputIt first, InputIt last) {
+        std::vector<std::pair<node_base*, const Key*>> level;   // nodes and their minimal keys
+
+        leaf_node* leaf = nullptr;
+        for (; first != last; ++first) {
+            if (!leaf || leaf->count == NodeSize) {
+                leaf_node* const new_leaf = new leaf_node;
+                (leaf ? leaf->next : head_) = new_leaf;
+                leaf = new_leaf;
+                level.emplace_back(leaf, leaf->keys.data());
+            }
+
+            auto&& value = *first;
+            detail::btree_insert_at(leaf->values(), leaf->count, leaf->count, value.second);
+            leaf->keys.insert(leaf->count, leaf->count, value.first);
+            ++leaf->count;
+            ++size_;
+        }
+
+        std::size_t height = 0;
+        while (level.size() > 1) {
+            // Distributing children evenly, so that each inner node has at least two of them
+            const std::size_t children = level.size();
+            const std::size_t groups = (children + NodeSize) / (NodeSize + 1);
+            std::vector<std::pair<node_base*, const Key*>> upper;
+            upper.reserve(groups);
+
+            std::size_t child = 0;
+            for (std::size_t group = 0; group < groups; ++group) {
+                const std::size_t take = children / groups + (group < children % groups ? 1 : 0);
+                inner_node* const inner = new inner_node;
+                inner->children[0] = level[child].first;
+                for (std::size_t i = 1; i < take; ++i) {
+                    inner->keys.insert(i - 1, i - 1, *level[child + i].second);
+                    inner->children[i] = level[child + i].first;
+                    ++inner->count;
+                }
+
+                upper.emplace_back(inner, level[child].second);
+                child += take;
+            }
+
+            level.swap(upper);
+            ++height;
+        }
+
+        root_ = (level.empty() ? nullptr : level[0].first);
+        height_ = height;
+    }
+
+    static void destroy_inner(inner_node* node, std::size_t level) noexcept {
+        if (level > 1) {
+            for (std::size_t i = 0; i <= node->count; ++i) {
+                destroy_inner(static_cast<inner_node*>(node->children[i]), level - 1);
+            }
+        }
+
+        detail::btree_destroy(node->keys.data(), node->count);
+        delete node;
+    }
+
+    node_base*  root_ = nullptr;
+    leaf_node*  head_ = nullptr;    // leftmost leaf, leaves are linked in key order
+    std::size_t height_ = 0;        // count of inner levels
+    std::size_t size_ = 0;
+};
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_BTREE_MAP_HPP
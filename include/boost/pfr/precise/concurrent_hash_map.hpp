@@ -0,0 +1,526 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_CONCURRENT_HASH_MAP_HPP
+#define BOOST_PFR_PRECISE_CONCURRENT_HASH_MAP_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <boost/pfr/detail/epoch.hpp>
+#include <boost/pfr/detail/prefetch.hpp>
+#include <boost/pfr/precise/core.hpp>
+#include <boost/pfr/precise/functors.hpp>
+#include <boost/pfr/precise/tuple_size.hpp>
+
+/// \file boost/pfr/precise/concurrent_hash_map.hpp
+/// Contains boost::pfr::concurrent_hash_map, hash map with lock-free lookups keyed by aggregates.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    /// Aggregates without padding and with only integral fields could be compared with `std::memcmp`, that compilers
+    /// inline into a few vector comparisons for small keys. Fields of class types are compared with their own
+    /// `operator==` by boost::pfr::equal_to that may differ from the bitwise comparison, so such keys are not bitwise
+    /// comparable even without padding.
+#if defined(__cpp_lib_has_unique_object_representations)
+    template <class K, class Seq>
+    struct all_fields_scalar_impl;
+
+    template <class K, std::size_t... I>
+    struct all_fields_scalar_impl<K, std::index_sequence<I...>>
+        : std::conjunction<std::is_scalar<std::remove_reference_t<::boost::pfr::tuple_element_t<I, K>>>...>
+    {};
+
+    /// Fields are reflected only when `::value` is used, after the cheaper checks.
+    template <class K>
+    struct all_fields_scalar {
+        static constexpr bool value = all_fields_scalar_impl<K, std::make_index_sequence<::boost::pfr::tuple_size_v<K>>>::value;
+    };
+
+    template <class K>
+    using is_bitwise_comparable = std::conjunction<
+        std::has_unique_object_representations<K>,
+        std::disjunction<std::is_scalar<K>, std::conjunction<std::is_class<K>, all_fields_scalar<K>>>
+    >;
+#else
+    template <class K>
+    using is_bitwise_comparable = std::false_type;
+#endif
+
+    /// Copies of the keys of a group of batch lookups, for the key ranges that produce temporaries.
+    template <class K, std::size_t N>
+    class key_copies {
+    public:
+        key_copies() = default;
+        key_copies(const key_copies&) = delete;
+        key_copies& operator=(const key_copies&) = delete;
+
+        ~key_copies() {
+            clear();
+        }
+
+        template <class Key>
+        const K* push(const Key& key) {
+            const K* const p = ::new (static_cast<void*>(storage_[size_])) K(key);
+            ++size_;
+            return p;
+        }
+
+        void clear() noexcept {
+            for (std::size_t i = 0; i < size_; ++i) {
+                reinterpret_cast<K*>(storage_[i])->~K();
+            }
+            size_ = 0;
+        }
+
+    private:
+        alignas(K) unsigned char    storage_[N][sizeof(K)];
+        std::size_t                 size_ = 0;
+    };
+
+    /// Finalizer of MurmurHash3: spreads the hash over all the bits, so the high bits could select a stripe and the low bits a bucket.
+    inline std::uint64_t mix_hash(std::uint64_t h) noexcept {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+} // namespace detail
+
+/// \brief Hash map from aggregates `K` to `V` for concurrent use from many threads.
+///
+/// Lookups do not take locks: they traverse immutable nodes under an epoch guard. Modifications lock one of the 64 stripes
+/// chosen by the hash of the key, modifications of keys from different stripes do not contend. Nodes are never changed
+/// after they are published: assignment replaces the node, erased and replaced nodes are freed by epoch based reclamation
+/// after all the lookups that could see them are finished.
+///
+/// Keys and values are stored inline in the nodes together with the hash of the key. Keys are hashed and compared with
+/// boost::pfr::hash and boost::pfr::equal_to by default. Keys without padding and with only integral, enum and pointer
+/// fields are compared with `std::memcmp` in C++17.
+///
+/// Lookups return copies of the values or call a functor with a reference to the value, references to the values do not
+/// outlive the lookup.
+///
+/// \b Example:
+/// \code
+///     struct order_id { std::uint32_t session; std::uint64_t seq; };
+///     boost::pfr::concurrent_hash_map<order_id, order_state> states;
+///
+///     states.insert_or_assign(order_id{1, 42}, order_state::new_);    // any thread
+///
+///     order_state s;
+///     if (states.find(order_id{1, 42}, s)) { ... }                    // any thread, lock-free
+/// \endcode
+template <class K, class V, class Hash = ::boost::pfr::hash<K>, class KeyEqual = ::boost::pfr::equal_to<K>>
+class concurrent_hash_map {
+    struct node {
+        std::uint64_t       hash;
+        K                   key;
+        V                   value;
+        std::atomic<node*>  next;
+
+        node(std::uint64_t h, const K& k, const V& v, node* n)
+            : hash(h), key(k), value(v), next(n)
+        {}
+    };
+
+    struct table {
+        std::size_t                             mask;
+        std::unique_ptr<std::atomic<node*>[]>   buckets;
+
+        explicit table(std::size_t size)
+            : mask(size - 1)
+            , buckets(new std::atomic<node*>[size])
+        {
+            for (std::size_t i = 0; i < size; ++i) {
+                buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~table() {
+            for (std::size_t i = 0; i <= mask; ++i) {
+                node* n = buckets[i].load(std::memory_order_relaxed);
+                while (n) {
+                    node* const next = n->next.load(std::memory_order_relaxed);
+                    delete n;
+                    n = next;
+                }
+            }
+        }
+    };
+
+    struct stripe {
+        std::mutex                  mutex;
+        std::atomic<table*>         buckets{nullptr};
+        std::atomic<std::size_t>    size{0};
+        char padding[detail::cache_line_size];     // stripes are modified by different threads
+    };
+
+    static constexpr std::size_t stripes_bits = 6;
+    static constexpr std::size_t stripes_count = std::size_t(1) << stripes_bits;
+    static constexpr std::size_t initial_buckets = 8;
+
+    typedef std::integral_constant<bool,
+        std::is_same<KeyEqual, ::boost::pfr::equal_to<K>>::value && detail::is_bitwise_comparable<K>::value
+    > use_memcmp_t;
+
+public:
+    typedef K           key_type;
+    typedef V           mapped_type;
+    typedef Hash        hasher;
+    typedef KeyEqual    key_equal;
+
+    /// Constructs an empty map.
+    explicit concurrent_hash_map(const Hash& hash = Hash{}, const KeyEqual& equal = KeyEqual{})
+        : stripes_(new stripe[stripes_count])
+        , hash_(hash)
+        , equal_(equal)
+    {
+        for (std::size_t i = 0; i < stripes_count; ++i) {
+            stripes_[i].buckets.store(new table(initial_buckets), std::memory_order_relaxed);
+        }
+    }
+
+    concurrent_hash_map(const concurrent_hash_map&) = delete;
+    concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+    /// \pre No other thread uses the map.
+    ~concurrent_hash_map() {
+        for (std::size_t i = 0; i < stripes_count; ++i) {
+            delete stripes_[i].buckets.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// Copies the value for `key` into `value`. Lock-free.
+    /// \return true if the key was found.
+    bool find(const K& key, V& value) const {
+        return visit(key, [&value](const V& v) { value = v; });
+    }
+
+    /// \return true if there's a value for `key`. Lock-free.
+    bool contains(const K& key) const {
+        return visit(key, [](const V&) {});
+    }
+
+    /// Calls `f(const V&)` with the value for `key`, if it exists. The reference is valid only during the call. Lock-free.
+    /// \return true if the key was found.
+    template <class F>
+    bool visit(const K& key, F&& f) const {
+        const std::uint64_t h = hash_of(key);
+        const auto guard = epochs_.pin();
+
+        const table* const t = stripe_of(h).buckets.load(std::memory_order_acquire);
+        for (const node* n = t->buckets[h & t->mask].load(std::memory_order_acquire); n; n = n->next.load(std::memory_order_acquire)) {
+            if (n->hash == h && keys_equal(n->key, key)) {
+                f(n->value);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Count of keys that are hashed and prefetched together by visit_batch and lookup_batch.
+    static constexpr std::size_t batch_size = 16;
+
+    /// \brief Looks up all the `keys` and calls `f(i, const V&)` for each found key, where `i` is the index of the key in
+    /// `keys`. The reference is valid only during the call. Lock-free.
+    ///
+    /// Keys are processed in groups of batch_size: all the keys of a group are hashed first, then the buckets and the
+    /// first nodes of their chains are prefetched, and only then the keys are compared. So the cache misses of a group
+    /// overlap instead of stalling each lookup in turn, and the group shares one epoch guard.
+    ///
+    /// `keys` is any range of `K`. If its iterators do not return references to stored `K` (transform views, generators,
+    /// ranges of convertible types), the keys of a group are copied before the lookups.
+    ///
+    /// \return count of the found keys.
+    template <class KeyRange, class F>
+    std::size_t visit_batch(const KeyRange& keys, F&& f) const {
+        std::size_t found = 0;
+        for_each_group(keys, [&found, &f](std::size_t i, const V* value) {
+            if (value) {
+                f(i, *value);
+                ++found;
+            }
+        });
+        return found;
+    }
+
+    /// \brief Looks up all the `keys` like visit_batch does and writes a `std::pair<bool, V>` for each key into `out`: `true`
+    /// and a copy of the value if the key was found, `false` and `V{}` otherwise. Lock-free.
+    ///
+    /// \b Example:
+    /// \code
+    ///     std::vector<std::pair<bool, instrument>> enriched;
+    ///     instruments.lookup_batch(trade_instrument_ids, std::back_inserter(enriched));
+    /// \endcode
+    template <class KeyRange, class OutputIt>
+    OutputIt lookup_batch(const KeyRange& keys, OutputIt out) const {
+        for_each_group(keys, [&out](std::size_t /*i*/, const V* value) {
+            *out = (value ? std::pair<bool, V>(true, *value) : std::pair<bool, V>(false, V{}));
+            ++out;
+        });
+        return out;
+    }
+
+    /// Inserts `value` for `key` if there's no value for `key` yet.
+    /// \return true if the value was inserted.
+    bool insert(const K& key, const V& value) {
+        const std::uint64_t h = hash_of(key);
+        stripe& s = stripe_of(h);
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        std::atomic<node*>* const link = find_link(s, key, h);
+        if (link->load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        insert_new(s, key, value, h);
+        return true;
+    }
+
+    /// Inserts `value` for `key` or replaces the existing value.
+    /// \return true if the value was inserted, false if it was replaced.
+    bool insert_or_assign(const K& key, const V& value) {
+        const std::uint64_t h = hash_of(key);
+        stripe& s = stripe_of(h);
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        std::atomic<node*>* const link = find_link(s, key, h);
+        node* const old = link->load(std::memory_order_relaxed);
+        if (!old) {
+            insert_new(s, key, value, h);
+            return true;
+        }
+
+        link->store(new node(h, old->key, value, old->next.load(std::memory_order_relaxed)), std::memory_order_release);
+        epochs_.retire(old);
+        return false;
+    }
+
+    /// Removes the value for `key`.
+    /// \return true if the value was removed.
+    bool erase(const K& key) {
+        const std::uint64_t h = hash_of(key);
+        stripe& s = stripe_of(h);
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        std::atomic<node*>* const link = find_link(s, key, h);
+        node* const old = link->load(std::memory_order_relaxed);
+        if (!old) {
+            return false;
+        }
+
+        link->store(old->next.load(std::memory_order_relaxed), std::memory_order_release);
+        s.size.fetch_sub(1, std::memory_order_relaxed);
+        epochs_.retire(old);
+        return true;
+    }
+
+    /// Removes all the values.
+    void clear() {
+        for (std::size_t i = 0; i < stripes_count; ++i) {
+            stripe& s = stripes_[i];
+            std::lock_guard<std::mutex> lock(s.mutex);
+            table* const old = s.buckets.exchange(new table(initial_buckets), std::memory_order_acq_rel);
+            s.size.store(0, std::memory_order_relaxed);
+            epochs_.retire(old);
+        }
+    }
+
+    /// \return count of the values. Under concurrent modifications the result is approximate.
+    std::size_t size() const noexcept {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < stripes_count; ++i) {
+            result += stripes_[i].size.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    /// \return true if the map has no values. Under concurrent modifications the result is approximate.
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+private:
+    std::uint64_t hash_of(const K& key) const {
+        return detail::mix_hash(static_cast<std::uint64_t>(hash_(key)));
+    }
+
+    stripe& stripe_of(std::uint64_t h) const noexcept {
+        return stripes_[h >> (64 - stripes_bits)];
+    }
+
+    bool keys_equal(const K& lhs, const K& rhs) const {
+        return keys_equal_impl(lhs, rhs, use_memcmp_t{});
+    }
+
+    bool keys_equal_impl(const K& lhs, const K& rhs, std::true_type /*use_memcmp*/) const noexcept {
+        return std::memcmp(&lhs, &rhs, sizeof(K)) == 0;
+    }
+
+    bool keys_equal_impl(const K& lhs, const K& rhs, std::false_type /*use_memcmp*/) const {
+        return equal_(lhs, rhs);
+    }
+
+    /// Calls `f(i, value or nullptr)` for each of the `keys` in order.
+    template <class KeyRange, class F>
+    void for_each_group(const KeyRange& keys, F&& f) const {
+        using std::begin;
+        typedef decltype(*begin(keys)) reference_t;
+        for_each_group_impl(keys, f, std::integral_constant<bool,
+            std::is_lvalue_reference<reference_t>::value
+            && std::is_same<std::remove_cv_t<std::remove_reference_t<reference_t>>, K>::value
+        >{});
+    }
+
+    /// Keys are referenced in the range.
+    template <class KeyRange, class F>
+    void for_each_group_impl(const KeyRange& keys, F& f, std::true_type /*stored_keys*/) const {
+        const K* group[batch_size];
+        std::size_t index = 0;
+        std::size_t n = 0;
+        for (const K& key : keys) {
+            group[n++] = std::addressof(key);
+            if (n == batch_size) {
+                visit_group(group, n, index, f);
+                index += n;
+                n = 0;
+            }
+        }
+        if (n) {
+            visit_group(group, n, index, f);
+        }
+    }
+
+    /// Range produces temporaries (transform views, generators, proxies) that do not outlive the iteration, keys of a
+    /// group are copied.
+    template <class KeyRange, class F>
+    void for_each_group_impl(const KeyRange& keys, F& f, std::false_type /*stored_keys*/) const {
+        const K* group[batch_size];
+        detail::key_copies<K, batch_size> copies;
+        std::size_t index = 0;
+        std::size_t n = 0;
+        for (auto&& key : keys) {
+            group[n++] = copies.push(key);
+            if (n == batch_size) {
+                visit_group(group, n, index, f);
+                copies.clear();
+                index += n;
+                n = 0;
+            }
+        }
+        if (n) {
+            visit_group(group, n, index, f);
+        }
+    }
+
+    template <class F>
+    void visit_group(const K* const* keys, std::size_t n, std::size_t first_index, F& f) const {
+        std::uint64_t hashes[batch_size];
+        for (std::size_t i = 0; i < n; ++i) {
+            hashes[i] = hash_of(*keys[i]);
+        }
+
+        const auto guard = epochs_.pin();
+        const std::atomic<node*>* heads[batch_size];
+        for (std::size_t i = 0; i < n; ++i) {
+            const table* const t = stripe_of(hashes[i]).buckets.load(std::memory_order_acquire);
+            heads[i] = &t->buckets[hashes[i] & t->mask];
+            detail::prefetch(heads[i]);
+        }
+
+        const node* nodes[batch_size];
+        for (std::size_t i = 0; i < n; ++i) {
+            nodes[i] = heads[i]->load(std::memory_order_acquire);
+            if (nodes[i]) {
+                detail::prefetch(nodes[i]);
+                if (sizeof(node) > detail::cache_line_size) {
+                    detail::prefetch(nodes[i], sizeof(node) - 1);
+                }
+            }
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            const V* value = nullptr;
+            for (const node* nd = nodes[i]; nd; nd = nd->next.load(std::memory_order_acquire)) {
+                if (nd->hash == hashes[i] && keys_equal(nd->key, *keys[i])) {
+                    value = &nd->value;
+                    break;
+                }
+            }
+            f(first_index + i, value);
+        }
+    }
+
+    /// Returns the link that points to the node with `key`, or the null link at the end of the bucket. Stripe must be locked.
+    std::atomic<node*>* find_link(stripe& s, const K& key, std::uint64_t h) const {
+        table* const t = s.buckets.load(std::memory_order_relaxed);
+        std::atomic<node*>* link = &t->buckets[h & t->mask];
+        for (node* n = link->load(std::memory_order_relaxed); n; n = link->load(std::memory_order_relaxed)) {
+            if (n->hash == h && keys_equal(n->key, key)) {
+                break;
+            }
+            link = &n->next;
+        }
+        return link;
+    }
+
+    /// Inserts a node at the head of the bucket and grows the table of the stripe if needed. Stripe must be locked.
+    void insert_new(stripe& s, const K& key, const V& value, std::uint64_t h) {
+        table* const t = s.buckets.load(std::memory_order_relaxed);
+        std::atomic<node*>& head = t->buckets[h & t->mask];
+        head.store(new node(h, key, value, head.load(std::memory_order_relaxed)), std::memory_order_release);
+
+        const std::size_t size = s.size.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (size > t->mask + 1) {
+            grow(s, t);
+        }
+    }
+
+    /// Doubles the table. Nodes are copied, as concurrent lookups may be traversing the old chains.
+    void grow(stripe& s, table* old) {
+        const std::size_t new_size = 2 * (old->mask + 1);
+        std::unique_ptr<table> t(new table(new_size));
+        for (std::size_t i = 0; i <= old->mask; ++i) {
+            for (node* n = old->buckets[i].load(std::memory_order_relaxed); n; n = n->next.load(std::memory_order_relaxed)) {
+                std::atomic<node*>& head = t->buckets[n->hash & t->mask];
+                head.store(new node(n->hash, n->key, n->value, head.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+            }
+        }
+
+        s.buckets.store(t.release(), std::memory_order_release);
+        epochs_.retire(old);
+    }
+
+    std::unique_ptr<stripe[]>       stripes_;
+    Hash                            hash_;
+    KeyEqual                        equal_;
+    mutable detail::epoch_domain    epochs_;
+};
+
+template <class K, class V, class Hash, class KeyEqual>
+constexpr std::size_t concurrent_hash_map<K, V, Hash, KeyEqual>::batch_size;
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_CONCURRENT_HASH_MAP_HPP
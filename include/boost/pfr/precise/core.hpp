@@ -17,6 +17,9 @@
 #include <boost/pfr/detail/for_each_field_impl.hpp>
 
 #include <boost/pfr/precise/tuple_size.hpp>
+#if BOOST_PFR_FIELD_PROFILE
+#   include <boost/pfr/detail/field_profile.hpp>
+#endif
 #if BOOST_PFR_USE_CPP17
 #   include <boost/pfr/detail/core17.hpp>
 #else
@@ -40,6 +43,11 @@ namespace boost { namespace pfr {
 /// \endcode
 template <std::size_t I, class T>
 constexpr decltype(auto) get(const T& val) noexcept {
+#if BOOST_PFR_FIELD_PROFILE
+    detail::profile_field_access<
+        T, detail::field_profile_kind::precise, detail::reflection_info<T>.fields_count
+    >(&val, I);
+#endif
     return detail::sequence_tuple::get<I>( detail::tie_as_tuple(val) );
 }
 
@@ -47,6 +55,11 @@ constexpr decltype(auto) get(const T& val) noexcept {
 /// \overload get
 template <std::size_t I, class T>
 constexpr decltype(auto) get(T& val) noexcept {
+#if BOOST_PFR_FIELD_PROFILE
+    detail::profile_field_access<
+        std::remove_cv_t<T>, detail::field_profile_kind::precise, detail::reflection_info<std::remove_cv_t<T>>.fields_count
+    >(&val, I);
+#endif
     return detail::sequence_tuple::get<I>( detail::tie_as_tuple(val) );
 }
 
@@ -60,7 +73,7 @@ constexpr decltype(auto) get(T& val) noexcept {
 ///     std::vector<  boost::pfr::tuple_element<0, my_structure>::type  > v;
 /// \endcode
 template <std::size_t I, class T>
-using tuple_element = detail::sequence_tuple::tuple_element<I, decltype( ::boost::pfr::detail::tie_as_tuple(std::declval<T&>()) ) >;
+using tuple_element = detail::sequence_tuple::tuple_element<I, detail::reflection_tuple_t<T> >;
 
 
 /// \brief Type of a field with index `I` in aggregate `T`.
@@ -140,7 +153,10 @@ constexpr auto structure_tie(T& val) noexcept {
 /// \endcode
 template <class T, class F>
 void for_each_field(T&& value, F&& func) {
-    constexpr std::size_t fields_count = detail::fields_count<std::remove_reference_t<T>>();
+    constexpr std::size_t fields_count = detail::reflection_info<std::remove_cv_t<std::remove_reference_t<T>>>.fields_count;
+#if BOOST_PFR_FIELD_PROFILE
+    detail::profile_fields_access<std::remove_cv_t<std::remove_reference_t<T>>, detail::field_profile_kind::precise, fields_count>(&value);
+#endif
 
     ::boost::pfr::detail::for_each_field_dispatcher(
         std::forward<T>(value),
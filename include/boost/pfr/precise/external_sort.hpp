@@ -0,0 +1,279 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_EXTERNAL_SORT_HPP
+#define BOOST_PFR_PRECISE_EXTERNAL_SORT_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#if defined(_WIN32)
+#   error POSIX is required for this header.
+#endif
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/key_fields.hpp>
+#include <boost/pfr/detail/normalized_key.hpp>
+#include <boost/pfr/detail/posix_file.hpp>
+#include <boost/pfr/detail/prefetch.hpp>
+#include <boost/pfr/precise/argsort.hpp>
+#include <boost/pfr/precise/kway_merge.hpp>
+
+/// \file boost/pfr/precise/external_sort.hpp
+/// Contains boost::pfr::external_sort that sorts files of trivially copyable records that do not fit into memory.
+///
+/// \b Requires: POSIX, C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    /// Writes blocks to a file on a background thread, so the caller could prepare the next block meanwhile.
+    class background_writer {
+    public:
+        explicit background_writer(int fd)
+            : fd_(fd)
+            , thread_([this] { run(); })
+        {}
+
+        background_writer(const background_writer&) = delete;
+        background_writer& operator=(const background_writer&) = delete;
+
+        /// Waits for the pending block and stops the thread, errors of the pending block are ignored.
+        ~background_writer() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            cv_.notify_all();
+            thread_.join();
+        }
+
+        /// Waits for the previous block and starts writing `size` bytes of `data` at the current position of the file.
+        /// `data` must stay valid and unmodified until the following call to write() or wait().
+        void write(const void* data, std::size_t size) {
+            wait();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                data_ = data;
+                size_ = size;
+                pending_ = true;
+            }
+            cv_.notify_all();
+        }
+
+        /// Waits for the pending block, rethrows the error of writing it.
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !pending_; });
+            if (error_) {
+                std::rethrow_exception(std::exchange(error_, nullptr));
+            }
+        }
+
+    private:
+        void run() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                cv_.wait(lock, [this] { return pending_ || stop_; });
+                if (!pending_) {
+                    return;
+                }
+
+                ::iovec iov{const_cast<void*>(data_), size_};
+                lock.unlock();
+                std::exception_ptr error;
+                try {
+                    detail::write_all(fd_, &iov, 1);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                lock.lock();
+
+                error_ = error;
+                pending_ = false;
+                cv_.notify_all();
+            }
+        }
+
+        const int               fd_;
+        std::mutex              mutex_;
+        std::condition_variable cv_;
+        const void*             data_ = nullptr;
+        std::size_t             size_ = 0;
+        bool                    pending_ = false;
+        bool                    stop_ = false;
+        std::exception_ptr      error_;
+        std::thread             thread_;    // last, starts after all the other members are initialized
+    };
+
+    template <class T>
+    struct record_span {
+        const T* first;
+        const T* last;
+
+        const T* begin() const noexcept { return first; }
+        const T* end() const noexcept { return last; }
+    };
+
+    /// Memory for a record of a run: the record itself, its sorted copy and the sort index of argsort_by.
+    template <class KeyFields>
+    constexpr std::size_t external_sort_bytes_per_record(std::size_t record_size) noexcept {
+        typedef typename KeyFields::type key_t;
+        return 2 * record_size + sizeof(std::size_t) + (detail::all_fields_normalizable<key_t>::value
+            ? sizeof(detail::argsort_entry<std::tuple_size<key_t>::value>)
+            : sizeof(std::size_t)    // buffer of std::stable_sort
+        );
+    }
+
+    /// Copies the records of `run` to `sorted` in the order of `permutation`.
+    template <class T>
+    void external_sort_gather(const T* run, const std::vector<std::size_t>& permutation, T* sorted) noexcept {
+        constexpr std::size_t prefetch_distance = 16;
+
+        const std::size_t n = permutation.size();
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i + prefetch_distance < n) {
+                detail::prefetch(run + permutation[i + prefetch_distance]);
+            }
+            sorted[i] = run[permutation[i]];
+        }
+    }
+
+    [[noreturn]] inline void external_sort_throw(const char* path, const char* what) {
+        throw std::runtime_error(std::string("boost::pfr::external_sort: ") + path + ": " + what);
+    }
+
+} // namespace detail
+
+/// \brief Stably sorts the records of type `T` stored in the file `in_path` by the fields `I...` (by all the fields if `I...` is
+/// empty) and writes them to the file `out_path`, using about `memory_budget` bytes of memory.
+///
+/// Input is read in runs that fit into the memory budget. Each run is sorted with boost::pfr::argsort_by, so keys with only
+/// integral and enum fields are sorted as compact normalized copies. Sorted runs are written to a temporary file on a
+/// background thread while the next run is read and sorted. Runs are merged in a single pass with
+/// boost::pfr::kway_merge_by, output blocks are written on a background thread while the next block is merged. If the
+/// input fits into a single run no temporary file is created.
+///
+/// The temporary file takes as much disk space as the input. It is created without a name (or unlinked right after
+/// creation if the file system does not support that) in the directory of `out_path`, so it does not clash with other
+/// files and concurrent sorts, and it is removed even if the process crashes. Runs are read from it through a memory
+/// mapping, the page cache used for that is not included in `memory_budget`. `out_path` could be the same as `in_path`.
+///
+/// \tparam T trivially copyable aggregate, records are stored in the files as is.
+///
+/// \throws std::system_error on I/O errors, std::runtime_error if the size of the input is not a multiple of `sizeof(T)`.
+///
+/// \b Example:
+/// \code
+///     struct trade { std::uint32_t symbol_id; std::int64_t ts; double price; std::int64_t qty; };
+///
+///     // Sorts by symbol and timestamp with 1 GB of memory
+///     boost::pfr::external_sort<trade, 0, 1>("trades.bin", "trades.sorted.bin", std::size_t(1) << 30);
+/// \endcode
+template <class T, std::size_t... I>
+void external_sort(const char* in_path, const char* out_path, std::size_t memory_budget) {
+    static_assert(
+        std::is_trivially_copyable<T>::value,
+        "====================> Boost.PFR: external_sort requires trivially copyable records"
+    );
+    typedef detail::key_fields<T, I...> key_fields_t;
+
+    const detail::file_descriptor in(in_path, O_RDONLY);
+    struct ::stat st;
+    if (::fstat(in.get(), &st) != 0) {
+        throw std::system_error(errno, std::generic_category(), in_path);
+    }
+    const std::size_t bytes = static_cast<std::size_t>(st.st_size);
+    if (bytes % sizeof(T)) {
+        detail::external_sort_throw(in_path, "size is not a multiple of the record size");
+    }
+    const std::size_t count = bytes / sizeof(T);
+    const std::size_t run_size = (std::max)(
+        memory_budget / detail::external_sort_bytes_per_record<key_fields_t>(sizeof(T)), std::size_t{1}
+    );
+
+    if (count <= run_size) {
+        std::vector<T> run(count);
+        std::vector<T> sorted(count);
+        detail::read_all(in.get(), run.data(), bytes, 0);
+        detail::external_sort_gather(run.data(), ::boost::pfr::argsort_by<I...>(run), sorted.data());
+
+        const detail::file_descriptor out(out_path, O_WRONLY | O_CREAT | O_TRUNC);
+        ::iovec iov{sorted.data(), bytes};
+        detail::write_all(out.get(), &iov, 1);
+        return;
+    }
+
+    ///////////////////// Sorting runs, the previous run is written while the next one is read and sorted
+    const detail::file_descriptor runs_file(detail::create_temporary_file(out_path));
+
+    std::vector<std::size_t> run_ends;
+    {
+        std::vector<T> run(run_size);
+        std::vector<T> sorted(run_size);
+        detail::background_writer writer(runs_file.get());
+        for (std::size_t pos = 0; pos < count;) {
+            const std::size_t n = (std::min)(run_size, count - pos);
+            detail::read_all(in.get(), run.data(), n * sizeof(T), static_cast<::off_t>(pos * sizeof(T)));
+            const std::vector<std::size_t> permutation = ::boost::pfr::argsort_by<I...>(
+                detail::record_span<T>{run.data(), run.data() + n}
+            );
+            writer.wait();
+            detail::external_sort_gather(run.data(), permutation, sorted.data());
+            writer.write(sorted.data(), n * sizeof(T));
+            pos += n;
+            run_ends.push_back(pos);
+        }
+        writer.wait();
+    }
+
+    ///////////////////// Merging the runs, the previous block is written while the next one is merged
+    const detail::mapped_file runs(runs_file.get(), out_path);
+    ::madvise(const_cast<unsigned char*>(runs.data()), runs.size(), MADV_SEQUENTIAL);
+    const T* const records = reinterpret_cast<const T*>(runs.data());
+
+    std::vector<detail::record_span<T>> spans;
+    for (std::size_t r = 0; r < run_ends.size(); ++r) {
+        spans.push_back({records + (r ? run_ends[r - 1] : 0), records + run_ends[r]});
+    }
+
+    const std::size_t block_size = (std::max)(memory_budget / 2 / sizeof(T), std::size_t{1});
+    std::vector<T> blocks[2] = {std::vector<T>(block_size), std::vector<T>(block_size)};
+    std::size_t block = 0;
+    std::size_t fill = 0;
+
+    const detail::file_descriptor out(out_path, O_WRONLY | O_CREAT | O_TRUNC);
+    detail::background_writer writer(out.get());
+    ::boost::pfr::kway_merge_by<I...>(spans, [&](const T& value) {
+        blocks[block][fill++] = value;
+        if (fill == block_size) {
+            writer.write(blocks[block].data(), fill * sizeof(T));
+            block ^= 1;
+            fill = 0;
+        }
+    });
+    if (fill) {
+        writer.write(blocks[block].data(), fill * sizeof(T));
+    }
+    writer.wait();
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_EXTERNAL_SORT_HPP
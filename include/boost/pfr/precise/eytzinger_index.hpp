@@ -0,0 +1,243 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_EYTZINGER_INDEX_HPP
+#define BOOST_PFR_PRECISE_EYTZINGER_INDEX_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/key_fields.hpp>
+#include <boost/pfr/detail/prefetch.hpp>
+
+/// \file boost/pfr/precise/eytzinger_index.hpp
+/// Contains read-only index that keeps the aggregates in Eytzinger (BFS) order of their key fields.
+///
+/// Binary search over a sorted array touches a new cache line on almost every step and the branch on the comparison result
+/// is unpredictable. In the Eytzinger layout the children of the node `k` are at `2k` and `2k+1`, so the descendants of a node for
+/// several levels down are in a few adjacent cache lines that can be prefetched, and the search loop has no data dependent branches.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    /// Returns `k` with the trailing ones and the first zero removed. This undoes the last steps of the Eytzinger search
+    /// that went right, giving the node where the search went left for the last time.
+    inline std::size_t eytzinger_unwind(std::size_t k) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return k >> (__builtin_ctzll(~static_cast<unsigned long long>(k)) + 1);
+#else
+        while (k & 1u) {
+            k >>= 1;
+        }
+        return k >> 1;
+#endif
+    }
+
+    /// Maximal power of two count of adjacent Eytzinger nodes of size `elem_size` that fit into 3 cache lines.
+    /// Prefetching more memory on each step of the search makes it slower for small keys, prefetching less does not hide
+    /// the memory latency for big ones.
+    constexpr std::size_t eytzinger_prefetch_stride(std::size_t elem_size) noexcept {
+        std::size_t stride = 1;
+        while (stride * 2 * elem_size <= 3 * cache_line_size) {
+            stride *= 2;
+        }
+        return stride;
+    }
+
+    /// Writes into `order` the index in sorted array for each position of the Eytzinger array.
+    /// Positions in `order` are 0-based, nodes `k` are 1-based.
+    inline void eytzinger_fill_order(std::vector<std::size_t>& order, std::size_t& sorted_index, std::size_t k) {
+        if (k > order.size()) {
+            return;
+        }
+
+        detail::eytzinger_fill_order(order, sorted_index, 2 * k);
+        order[k - 1] = sorted_index++;
+        detail::eytzinger_fill_order(order, sorted_index, 2 * k + 1);
+    }
+
+} // namespace detail
+
+/// Tag for boost::pfr::basic_eytzinger_index: the keys are copied into a separate array that is used for search.
+/// Search touches less memory if the key is much smaller than the whole aggregate.
+struct extracted_keys {};
+
+/// Tag for boost::pfr::basic_eytzinger_index: the keys are read directly from the stored aggregates, no additional memory is used.
+struct inline_keys {};
+
+/// \brief Read-only index over aggregates of type `T`, ordered by the fields with indexes `I...` (by all the fields if `I...` is empty).
+///
+/// Values are kept in Eytzinger (BFS) order. Lookups are branchless and prefetch the descendants several levels down.
+/// Values with equal keys are kept in order in which they were passed to the constructor.
+///
+/// \tparam KeyStorage boost::pfr::extracted_keys or boost::pfr::inline_keys.
+///
+/// \b Example:
+/// \code
+///     struct instrument { int id; double price; };
+///     std::vector<instrument> v = load_instruments();
+///
+///     boost::pfr::eytzinger_index<instrument, 0> index(v.begin(), v.end());
+///     const instrument* p = index.find(42);   // search by the field with index 0
+///     assert(!p || p->id == 42);
+/// \endcode
+template <class T, class KeyStorage, std::size_t... I>
+class basic_eytzinger_index {
+    static_assert(
+        std::is_same<KeyStorage, extracted_keys>::value || std::is_same<KeyStorage, inline_keys>::value,
+        "====================> Boost.PFR: KeyStorage must be boost::pfr::extracted_keys or boost::pfr::inline_keys"
+    );
+
+    typedef detail::key_fields<T, I...> key_fields_t;
+
+public:
+    typedef T                               value_type;
+    typedef typename key_fields_t::type     key_type;   ///< `std::tuple` of the key fields
+    typedef std::size_t                     size_type;
+
+    /// Constructs an empty index.
+    basic_eytzinger_index() = default;
+
+    /// Constructs an index from the values in range [first, last).
+    template <class InputIt>
+    basic_eytzinger_index(InputIt first, InputIt last)
+        : basic_eytzinger_index(std::vector<T>(first, last))
+    {}
+
+    /// Constructs an index from the `values`, taking ownership of them.
+    explicit basic_eytzinger_index(std::vector<T> values) {
+        std::stable_sort(values.begin(), values.end(), [](const T& lhs, const T& rhs) {
+            return key_fields_t::tie(lhs) < key_fields_t::tie(rhs);
+        });
+
+        std::vector<std::size_t> order(values.size());
+        std::size_t sorted_index = 0;
+        detail::eytzinger_fill_order(order, sorted_index, 1);
+
+        values_.reserve(values.size());
+        for (std::size_t i : order) {
+            values_.push_back(std::move(values[i]));
+        }
+
+        extract_keys(KeyStorage{});
+    }
+
+    /// \return count of values in the index.
+    size_type size() const noexcept { return values_.size(); }
+
+    /// \return true if the index has no values.
+    bool empty() const noexcept { return values_.empty(); }
+
+    /// \return pointer to the `size()` values, stored in Eytzinger order.
+    const T* data() const noexcept { return values_.data(); }
+
+    /// \return pointer to the first value in key order with key not less than `key`, or nullptr if there is no such value.
+    const T* lower_bound(const key_type& key) const {
+        return lower_bound_impl(key);
+    }
+
+    /// \overload lower_bound
+    /// Key is specified as the values of the key fields, for example `index.lower_bound(42, 3.14)`.
+    template <class... K>
+    const T* lower_bound(const K&... key) const {
+        static_assert(sizeof...(K) == std::tuple_size<key_type>::value, "====================> Boost.PFR: Wrong count of the key fields");
+        return lower_bound_impl(std::tie(key...));
+    }
+
+    /// \return pointer to the first value in key order with key equal to `key`, or nullptr if there is no such value.
+    const T* find(const key_type& key) const {
+        return find_impl(key);
+    }
+
+    /// \overload find
+    template <class... K>
+    const T* find(const K&... key) const {
+        static_assert(sizeof...(K) == std::tuple_size<key_type>::value, "====================> Boost.PFR: Wrong count of the key fields");
+        return find_impl(std::tie(key...));
+    }
+
+private:
+    void extract_keys(extracted_keys) {
+        keys_.reserve(values_.size());
+        for (const T& v : values_) {
+            keys_.push_back(key_fields_t::make(v));
+        }
+    }
+
+    void extract_keys(inline_keys) noexcept {}
+
+    const key_type& key_at(std::size_t i, extracted_keys) const noexcept {
+        return keys_[i];
+    }
+
+    auto key_at(std::size_t i, inline_keys) const noexcept {
+        return key_fields_t::tie(values_[i]);
+    }
+
+    const void* search_base(extracted_keys) const noexcept { return keys_.data(); }
+    const void* search_base(inline_keys) const noexcept { return values_.data(); }
+
+    template <class Key>
+    const T* lower_bound_impl(const Key& key) const {
+        typedef std::conditional_t<std::is_same<KeyStorage, extracted_keys>::value, key_type, T> search_elem_t;
+
+        // Nodes [k * stride, k * stride + stride) are the descendants of the node `k` that are log2(stride) levels down.
+        // Those are prefetched while the next log2(stride) levels are searched.
+        constexpr std::size_t stride = detail::eytzinger_prefetch_stride(sizeof(search_elem_t));
+        constexpr std::size_t prefetch_lines = (stride * sizeof(search_elem_t) + detail::cache_line_size - 1) / detail::cache_line_size;
+
+        const std::size_t n = values_.size();
+        const void* const base = search_base(KeyStorage{});
+
+        std::size_t k = 1;
+        while (k <= n) {
+            for (std::size_t line = 0; line < prefetch_lines; ++line) {
+                detail::prefetch(base, (k * stride - 1) * sizeof(search_elem_t) + line * detail::cache_line_size);
+            }
+            k = 2 * k + (key_at(k - 1, KeyStorage{}) < key);
+        }
+
+        k = detail::eytzinger_unwind(k);
+        return (k ? &values_[k - 1] : nullptr);
+    }
+
+    template <class Key>
+    const T* find_impl(const Key& key) const {
+        const T* const res = lower_bound_impl(key);
+        if (!res || key < key_fields_t::tie(*res)) {
+            return nullptr;
+        }
+
+        return res;
+    }
+
+    std::vector<T>          values_;
+    std::vector<key_type>   keys_;      // empty for inline_keys
+};
+
+/// \brief boost::pfr::basic_eytzinger_index that keeps the keys in a separate array. See boost::pfr::basic_eytzinger_index for details.
+///
+/// \b Example:
+/// \code
+///     struct instrument { int id; double price; };
+///     boost::pfr::eytzinger_index<instrument, 0> index(v.begin(), v.end());
+/// \endcode
+template <class T, std::size_t... I>
+using eytzinger_index = basic_eytzinger_index<T, extracted_keys, I...>;
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_EYTZINGER_INDEX_HPP
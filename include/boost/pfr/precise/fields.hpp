@@ -0,0 +1,29 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_FIELDS_HPP
+#define BOOST_PFR_PRECISE_FIELDS_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <utility>      // metaprogramming stuff
+
+namespace boost { namespace pfr {
+
+/// \brief List of field indexes, that is used by algorithms to select the key fields of an aggregate.
+/// Empty list means all the fields.
+///
+/// \b Example:
+/// \code
+///     struct order { int account; long order_id; double price; };
+///     typedef boost::pfr::fields<0, 1> order_key;  // (account, order_id)
+/// \endcode
+template <std::size_t... I>
+using fields = std::index_sequence<I...>;
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_FIELDS_HPP
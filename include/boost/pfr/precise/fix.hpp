@@ -0,0 +1,516 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_FIX_HPP
+#define BOOST_PFR_PRECISE_FIX_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#if !BOOST_PFR_USE_CPP17
+#   error C++17 is required for this header.
+#endif
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#   include <emmintrin.h>
+#endif
+
+#include <boost/pfr/precise/core.hpp>
+#include <boost/pfr/precise/tuple_size.hpp>
+
+/// \file boost/pfr/precise/fix.hpp
+/// Contains functions for decoding and encoding aggregates as FIX (Financial Information eXchange) `tag=value` messages.
+///
+/// Tags of the fields are specified by specializing boost::pfr::fix_tags. Supported field types are integral and floating point
+/// types, `char`, `bool` (`Y` or `N`), enums (as `char` if the underlying type is one byte long, as integers otherwise),
+/// `std::string_view` and `std::string`.
+///
+/// \b Requires: C++17.
+namespace boost { namespace pfr {
+
+/// List of FIX tags for the fields of an aggregate, in the order of the fields. Tag 0 means that the field is not encoded or decoded.
+template <unsigned... Tags>
+struct fix_tag_list {};
+
+/// \brief Trait that must be specialized for each aggregate used with boost::pfr::fix_decode and boost::pfr::fix_encode.
+///
+/// \b Example:
+/// \code
+///     struct new_order { char msg_type; std::string_view cl_ord_id; std::string_view symbol; char side; double price; int qty; };
+///
+///     template <> struct boost::pfr::fix_tags<new_order> : boost::pfr::fix_tag_list<35, 11, 55, 54, 44, 38> {};
+/// \endcode
+template <class T>
+struct fix_tags;
+
+namespace detail {
+
+    constexpr char fix_soh = '\x01';
+
+    template <unsigned... Tags>
+    constexpr fix_tag_list<Tags...> fix_tag_list_of(fix_tag_list<Tags...>) noexcept { return {}; }
+
+    ///////////////////// Pre-rendered `tag=` literals
+    constexpr std::size_t fix_digits(unsigned v) noexcept {
+        std::size_t digits = 1;
+        while (v >= 10) {
+            v /= 10;
+            ++digits;
+        }
+        return digits;
+    }
+
+    template <unsigned Tag>
+    struct fix_tag_literal {
+        static constexpr std::size_t size = detail::fix_digits(Tag) + 1;
+
+        static constexpr std::array<char, size> render() noexcept {
+            std::array<char, size> result{};
+            unsigned v = Tag;
+            for (std::size_t i = size - 1; i > 0; --i) {
+                result[i - 1] = static_cast<char>('0' + v % 10);
+                v /= 10;
+            }
+            result[size - 1] = '=';
+            return result;
+        }
+
+        static constexpr std::array<char, size> chars = render();
+
+        static constexpr unsigned checksum() noexcept {
+            unsigned sum = 0;
+            for (char c : chars) {
+                sum += static_cast<unsigned char>(c);
+            }
+            return sum;
+        }
+    };
+
+    ///////////////////// Compile-time perfect hash of the tags
+    //
+    // slot = (tag * multiplier) >> (32 - log2(size)). The multiplier and the size are searched at compile time, so
+    // that all the tags go to different slots and the dispatch is a single multiplication and a table lookup.
+    template <unsigned... Tags>
+    struct fix_perfect_hash {
+        static constexpr std::size_t count = sizeof...(Tags);
+        static constexpr unsigned tags[] = {Tags..., 0};
+        static constexpr std::size_t max_size = 1024;
+
+        struct params {
+            std::uint32_t multiplier;
+            unsigned bits;
+        };
+
+        static constexpr std::uint32_t slot(unsigned tag, params p) noexcept {
+            return p.bits ? static_cast<std::uint32_t>(tag * p.multiplier) >> (32 - p.bits) : 0;
+        }
+
+        static constexpr bool collision_free(params p) noexcept {
+            std::array<bool, max_size> used{};
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!tags[i]) {
+                    continue;
+                }
+                const std::uint32_t s = slot(tags[i], p);
+                if (used[s]) {
+                    return false;
+                }
+                used[s] = true;
+            }
+            return true;
+        }
+
+        static constexpr params find() noexcept {
+            unsigned bits = 0;
+            while ((std::size_t(1) << bits) < count) {
+                ++bits;
+            }
+
+            for (; (std::size_t(1) << bits) <= max_size; ++bits) {
+                std::uint32_t multiplier = 2654435769u;     // 2^32 / golden ratio
+                for (unsigned attempt = 0; attempt < 2000; ++attempt, multiplier += 2 * 0x9E3779B9u + 2) {
+                    if (collision_free(params{multiplier, bits})) {
+                        return params{multiplier, bits};
+                    }
+                }
+            }
+            return params{0, 0};
+        }
+
+        static constexpr params hash = find();
+        static_assert(
+            count < 2 || hash.multiplier,
+            "====================> Boost.PFR: Failed to build perfect hash for the FIX tags, there are too many of them"
+        );
+
+        static constexpr std::size_t size = std::size_t(1) << hash.bits;
+
+        /// Field index + 1 for each slot, 0 for empty slots.
+        static constexpr std::array<std::uint16_t, size> make_table() noexcept {
+            std::array<std::uint16_t, size> table{};
+            for (std::size_t i = 0; i < count; ++i) {
+                if (tags[i]) {
+                    table[slot(tags[i], hash)] = static_cast<std::uint16_t>(i + 1);
+                }
+            }
+            return table;
+        }
+
+        static constexpr std::array<std::uint16_t, size> table = make_table();
+
+        /// \return field index + 1 for `tag`, 0 if there is no field with such tag.
+        static constexpr std::size_t find_field(unsigned tag) noexcept {
+            const std::size_t index = table[slot(tag, hash)];
+            return (index && tags[index - 1] == tag ? index : 0);
+        }
+    };
+
+    template <unsigned... Tags>
+    constexpr bool fix_unique_tags(fix_tag_list<Tags...>) noexcept {
+        const unsigned tags[] = {Tags..., 0};
+        for (std::size_t i = 0; i < sizeof...(Tags); ++i) {
+            for (std::size_t j = i + 1; j < sizeof...(Tags); ++j) {
+                if (tags[i] && tags[i] == tags[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    ///////////////////// Delimiter scanning
+    inline const char* fix_find_soh(const char* first, const char* last) noexcept {
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+        const __m128i soh = _mm_set1_epi8(fix_soh);
+        for (; last - first >= 16; first += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, soh)));
+            if (mask) {
+                return first + __builtin_ctz(mask);
+            }
+        }
+#endif
+        while (first != last && *first != fix_soh) {
+            ++first;
+        }
+        return first;
+    }
+
+    inline unsigned fix_checksum(const char* first, const char* last) noexcept {
+        unsigned sum = 0;
+        for (; first != last; ++first) {
+            sum += static_cast<unsigned char>(*first);
+        }
+        return sum;
+    }
+
+    ///////////////////// Values
+    template <class F>
+    bool fix_parse_value(std::string_view s, F& value) {
+        if constexpr (std::is_same<F, bool>::value) {
+            if (s.size() != 1 || (s[0] != 'Y' && s[0] != 'N')) {
+                return false;
+            }
+            value = (s[0] == 'Y');
+            return true;
+        } else if constexpr (std::is_same<F, char>::value) {
+            if (s.size() != 1) {
+                return false;
+            }
+            value = s[0];
+            return true;
+        } else if constexpr (std::is_enum<F>::value) {
+            typedef std::underlying_type_t<F> underlying_t;
+            std::conditional_t<sizeof(underlying_t) == 1, char, underlying_t> v{};
+            if (!detail::fix_parse_value(s, v)) {
+                return false;
+            }
+            value = static_cast<F>(v);
+            return true;
+        } else if constexpr (std::is_arithmetic<F>::value) {
+            const auto res = std::from_chars(s.data(), s.data() + s.size(), value);
+            return res.ec == std::errc{} && res.ptr == s.data() + s.size();
+        } else {
+            static_assert(
+                std::is_assignable<F&, std::string_view>::value,
+                "====================> Boost.PFR: Unsupported type of the field for FIX decoding"
+            );
+            value = s;
+            return true;
+        }
+    }
+
+    /// Appends bytes to the buffer and sums them for the FIX checksum.
+    struct fix_writer {
+        char* pos;
+        char* const end;
+        unsigned sum;
+
+        bool put(const char* data, std::size_t size, unsigned checksum) noexcept {
+            if (static_cast<std::size_t>(end - pos) < size) {
+                return false;
+            }
+            std::memcpy(pos, data, size);
+            pos += size;
+            sum += checksum;
+            return true;
+        }
+
+        bool put(const char* data, std::size_t size) noexcept {
+            return put(data, size, detail::fix_checksum(data, data + size));
+        }
+
+        bool put(char c) noexcept {
+            return put(&c, 1, static_cast<unsigned char>(c));
+        }
+
+        template <class F>
+        bool put_chars(const F& value) noexcept {
+            const auto res = std::to_chars(pos, end, value);
+            if (res.ec != std::errc{}) {
+                return false;
+            }
+            sum += detail::fix_checksum(pos, res.ptr);
+            pos = res.ptr;
+            return true;
+        }
+
+        template <class F>
+        bool put_value(const F& value) {
+            if constexpr (std::is_same<F, bool>::value) {
+                return put(value ? 'Y' : 'N');
+            } else if constexpr (std::is_same<F, char>::value) {
+                return put(value);
+            } else if constexpr (std::is_enum<F>::value) {
+                typedef std::underlying_type_t<F> underlying_t;
+                return put_value(static_cast<std::conditional_t<sizeof(underlying_t) == 1, char, underlying_t>>(value));
+            } else if constexpr (std::is_floating_point<F>::value) {
+                const auto res = std::to_chars(pos, end, value, std::chars_format::fixed);    // FIX does not allow exponents
+                if (res.ec != std::errc{}) {
+                    return false;
+                }
+                sum += detail::fix_checksum(pos, res.ptr);
+                pos = res.ptr;
+                return true;
+            } else if constexpr (std::is_arithmetic<F>::value) {
+                return put_chars(value);
+            } else {
+                const std::string_view s = value;
+                return put(s.data(), s.size());
+            }
+        }
+    };
+
+    template <class F>
+    bool fix_is_empty(const F& value) noexcept {
+        if constexpr (std::is_convertible<const F&, std::string_view>::value && !std::is_arithmetic<F>::value) {
+            return std::string_view(value).empty();
+        } else {
+            (void)value;
+            return false;
+        }
+    }
+
+    template <class T, std::size_t I>
+    bool fix_parse_field(T& value, std::string_view s) {
+        return detail::fix_parse_value(s, ::boost::pfr::get<I>(value));
+    }
+
+    template <class T, unsigned... Tags, std::size_t... I>
+    bool fix_decode_impl(std::string_view message, T& value, fix_tag_list<Tags...>, std::index_sequence<I...>) {
+        typedef fix_perfect_hash<Tags...> hash_t;
+        typedef bool (*parser_t)(T&, std::string_view);
+        constexpr parser_t parsers[] = {&detail::fix_parse_field<T, I>..., nullptr};
+
+        const char* const begin = message.data();
+        const char* const end = begin + message.size();
+        const char* p = begin;
+        while (p != end) {
+            // Tags are short, parsing them while scanning for '=' is faster than searching for it first
+            unsigned tag = 0;
+            const char* const tag_begin = p;
+            for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+                tag = tag * 10 + static_cast<unsigned>(*p - '0');
+            }
+            if (p == tag_begin || p == end || *p != '=' || p - tag_begin > 9) {
+                return false;
+            }
+
+            const char* const value_begin = p + 1;
+            const char* const value_end = detail::fix_find_soh(value_begin, end);
+            if (value_end == end) {
+                return false;
+            }
+
+            if (tag == 10) {
+                // CheckSum: sum of all the bytes before the "10=" modulo 256, must be the last field
+                std::uint32_t expected = 0;
+                const auto res = std::from_chars(value_begin, value_end, expected);
+                if (res.ec != std::errc{} || res.ptr != value_end || value_end + 1 != end
+                    || expected != detail::fix_checksum(begin, tag_begin) % 256)
+                {
+                    return false;
+                }
+            } else if (const std::size_t field = hash_t::find_field(tag)) {
+                if (!parsers[field - 1](value, std::string_view(value_begin, static_cast<std::size_t>(value_end - value_begin)))) {
+                    return false;
+                }
+            }
+
+            p = value_end + 1;
+        }
+
+        return true;
+    }
+
+    template <unsigned Tag, class F>
+    bool fix_encode_field(fix_writer& out, const F& value) {
+        if constexpr (Tag == 0) {
+            (void)out;
+            (void)value;
+            return true;
+        } else {
+            if (detail::fix_is_empty(value)) {
+                return true;
+            }
+
+            typedef fix_tag_literal<Tag> literal_t;
+            return out.put(literal_t::chars.data(), literal_t::size, literal_t::checksum())
+                && out.put_value(value)
+                && out.put(fix_soh);
+        }
+    }
+
+    template <class T, unsigned... Tags, std::size_t... I>
+    bool fix_encode_body(fix_writer& out, const T& value, fix_tag_list<Tags...>, std::index_sequence<I...>) {
+        bool ok = true;
+        const bool ignore[] = {true, (ok = ok && detail::fix_encode_field<Tags>(out, ::boost::pfr::get<I>(value)))...};
+        (void)ignore;
+        return ok;
+    }
+
+    template <class T>
+    auto fix_tags_of() noexcept {
+        typedef decltype(detail::fix_tag_list_of(::boost::pfr::fix_tags<T>{})) tags_t;
+        static_assert(
+            detail::fix_unique_tags(tags_t{}),
+            "====================> Boost.PFR: FIX tags of the fields must be unique"
+        );
+        return tags_t{};
+    }
+
+    template <unsigned... Tags>
+    constexpr std::size_t fix_tags_count(fix_tag_list<Tags...>) noexcept { return sizeof...(Tags); }
+
+} // namespace detail
+
+/// \brief Decodes FIX message `message` into an aggregate `T`, tags of the fields are taken from boost::pfr::fix_tags<T>.
+///
+/// Fields that are missing in the message are value initialized, tags that are not in boost::pfr::fix_tags<T> are skipped.
+/// If the message has the CheckSum(10) field, it must be the last one and its value must match the message.
+/// `std::string_view` fields point into the `message`. Does not allocate memory, unless `T` has `std::string` fields.
+///
+/// Values are found with SIMD search of the SOH delimiter, tags are dispatched to the fields with a perfect hash
+/// computed at compile time, numbers are parsed by `std::from_chars`.
+///
+/// \return decoded value, or an empty `std::optional` if the message is malformed or some value could not be parsed.
+///
+/// \b Example:
+/// \code
+///     const std::optional<new_order> o = boost::pfr::fix_decode<new_order>("35=D\x01" "11=abc\x01" "55=EURUSD\x01" "54=1\x01" "44=1.1\x01" "38=100\x01");
+///     assert(o && o->qty == 100);
+/// \endcode
+template <class T>
+std::optional<T> fix_decode(std::string_view message) {
+    const auto tags = detail::fix_tags_of<T>();
+    static_assert(
+        detail::fix_tags_count(tags) == ::boost::pfr::tuple_size_v<T>,
+        "====================> Boost.PFR: boost::pfr::fix_tags must have a tag for each field"
+    );
+
+    std::optional<T> result{std::in_place};
+    if (!detail::fix_decode_impl(message, *result, tags, std::make_index_sequence<::boost::pfr::tuple_size_v<T>>{})) {
+        result.reset();
+    }
+    return result;
+}
+
+/// \brief Encodes `value` as a FIX message into the `buffer` of `size` bytes, tags of the fields are taken from boost::pfr::fix_tags<T>.
+///
+/// The message starts with the BeginString(8) and BodyLength(9) fields, followed by the fields of `value` in their order and
+/// the CheckSum(10) field. Fields with tag 0 and empty strings are not written.
+/// `tag=` prefixes of the fields are rendered at compile time, the checksum is computed while writing.
+/// Does not allocate memory.
+///
+/// \return view of the encoded message inside `buffer`, or an empty view if the `buffer` is too small.
+///
+/// \b Example:
+/// \code
+///     char buffer[512];
+///     const std::string_view msg = boost::pfr::fix_encode(order, buffer, sizeof(buffer));
+///     send(socket, msg.data(), msg.size());
+/// \endcode
+template <class T>
+std::string_view fix_encode(const T& value, char* buffer, std::size_t size, std::string_view begin_string = "FIX.4.4") {
+    const auto tags = detail::fix_tags_of<T>();
+    static_assert(
+        detail::fix_tags_count(tags) == ::boost::pfr::tuple_size_v<T>,
+        "====================> Boost.PFR: boost::pfr::fix_tags must have a tag for each field"
+    );
+
+    // "8=<begin_string>\x01" "9=<body length>\x01" is written after the body just before it, reserving space for 10 digits
+    // of body length.
+    constexpr std::size_t max_length_digits = 10;
+    const std::size_t max_header = 2 + begin_string.size() + 1 + 2 + max_length_digits + 1;
+    if (size < max_header) {
+        return {};
+    }
+
+    char* const body = buffer + max_header;
+    detail::fix_writer out{body, buffer + size, 0};
+    if (!detail::fix_encode_body(out, value, tags, std::make_index_sequence<::boost::pfr::tuple_size_v<T>>{})) {
+        return {};
+    }
+    const std::size_t body_length = static_cast<std::size_t>(out.pos - body);
+
+    char length_chars[max_length_digits];
+    const auto length_end = std::to_chars(length_chars, length_chars + max_length_digits, body_length).ptr;
+    const std::size_t length_digits = static_cast<std::size_t>(length_end - length_chars);
+
+    char* const message = body - (2 + begin_string.size() + 1 + 2 + length_digits + 1);
+    detail::fix_writer header{message, body, out.sum};
+    header.put("8=", 2);
+    header.put(begin_string.data(), begin_string.size());
+    header.put(detail::fix_soh);
+    header.put("9=", 2);
+    header.put(length_chars, length_digits);
+    header.put(detail::fix_soh);
+
+    const unsigned checksum = header.sum % 256;
+    const char trailer[] = {
+        '1', '0', '=',
+        static_cast<char>('0' + checksum / 100), static_cast<char>('0' + checksum / 10 % 10), static_cast<char>('0' + checksum % 10),
+        detail::fix_soh
+    };
+    if (!out.put(trailer, sizeof(trailer), 0)) {
+        return {};
+    }
+
+    return std::string_view(message, static_cast<std::size_t>(out.pos - message));
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_FIX_HPP
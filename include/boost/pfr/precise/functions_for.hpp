@@ -12,6 +12,8 @@
 #include <boost/pfr/precise/functors.hpp>
 #include <boost/pfr/precise/io.hpp>
 
+#include <iosfwd>
+
 /// \def BOOST_PFR_PRECISE_FUNCTIONS_FOR(T)
 /// Defines comparison operators and stream operators for T.
 /// If type T is comparable or streamable using it's own operator (but not it's conversion operator), then the original operator is used.
@@ -76,6 +78,86 @@
     }                                                                                                                   \
 /**/
 
+/// \def BOOST_PFR_PRECISE_FUNCTIONS_DECLARE(T)
+/// Declares comparison operators, stream operators for `char` streams and `hash_value` for T, without defining them.
+/// Use it in a header, in the namespace of T. Define the functions in exactly one translation unit using BOOST_PFR_PRECISE_FUNCTIONS_DEFINE.
+///
+/// Unlike BOOST_PFR_PRECISE_FUNCTIONS_FOR, the functions are not inline. So the reflection and
+/// the comparison/printing internals for T are instantiated only once in the whole program, rather than in each translation unit
+/// that uses the operators.
+///
+/// \b Example:
+/// \code
+///     // my_struct.hpp
+///     #include <boost/pfr/precise/functions_for.hpp>
+///     namespace my_ns {
+///         struct my_struct { int i; short s; };
+///         BOOST_PFR_PRECISE_FUNCTIONS_DECLARE(my_struct)
+///     }
+///
+///     // my_struct.cpp
+///     #include "my_struct.hpp"
+///     namespace my_ns {
+///         BOOST_PFR_PRECISE_FUNCTIONS_DEFINE(my_struct)
+///     }
+/// \endcode
+///
+/// \podops for other ways to define operators and more details.
+///
+/// \b Declares \b following \b for \b T:
+/// \code
+/// bool operator==(const T& lhs, const T& rhs);
+/// bool operator!=(const T& lhs, const T& rhs);
+/// bool operator< (const T& lhs, const T& rhs);
+/// bool operator> (const T& lhs, const T& rhs);
+/// bool operator<=(const T& lhs, const T& rhs);
+/// bool operator>=(const T& lhs, const T& rhs);
+///
+/// std::ostream& operator<<(std::ostream& out, const T& value);
+/// std::istream& operator>>(std::istream& in, T& value);
+///
+/// // helper function for Boost unordered containers and boost::hash<>.
+/// std::size_t hash_value(const T& value);
+/// \endcode
+
+#define BOOST_PFR_PRECISE_FUNCTIONS_DECLARE(T)                          \
+    bool operator==(const T& lhs, const T& rhs);                        \
+    bool operator!=(const T& lhs, const T& rhs);                        \
+    bool operator< (const T& lhs, const T& rhs);                        \
+    bool operator> (const T& lhs, const T& rhs);                        \
+    bool operator<=(const T& lhs, const T& rhs);                        \
+    bool operator>=(const T& lhs, const T& rhs);                        \
+    ::std::ostream& operator<<(::std::ostream& out, const T& value);    \
+    ::std::istream& operator>>(::std::istream& in, T& value);           \
+    std::size_t hash_value(const T& v);                                 \
+/**/
+
+/// \def BOOST_PFR_PRECISE_FUNCTIONS_DEFINE(T)
+/// Defines the functions declared by BOOST_PFR_PRECISE_FUNCTIONS_DECLARE for T.
+/// Must be used exactly once in the program, in the namespace of T.
+///
+/// \rcast14
+
+#define BOOST_PFR_PRECISE_FUNCTIONS_DEFINE(T)                                                             \
+    bool operator==(const T& lhs, const T& rhs) { return ::boost::pfr::equal_to<T>{}(lhs, rhs);      }    \
+    bool operator!=(const T& lhs, const T& rhs) { return ::boost::pfr::not_equal<T>{}(lhs, rhs);     }    \
+    bool operator< (const T& lhs, const T& rhs) { return ::boost::pfr::less<T>{}(lhs, rhs);          }    \
+    bool operator> (const T& lhs, const T& rhs) { return ::boost::pfr::greater<T>{}(lhs, rhs);       }    \
+    bool operator<=(const T& lhs, const T& rhs) { return ::boost::pfr::less_equal<T>{}(lhs, rhs);    }    \
+    bool operator>=(const T& lhs, const T& rhs) { return ::boost::pfr::greater_equal<T>{}(lhs, rhs); }    \
+    ::std::ostream& operator<<(::std::ostream& out, const T& value) {                                     \
+        ::boost::pfr::write(out, value);                                                                  \
+        return out;                                                                                       \
+    }                                                                                                     \
+    ::std::istream& operator>>(::std::istream& in, T& value) {                                            \
+        ::boost::pfr::read(in, value);                                                                    \
+        return in;                                                                                        \
+    }                                                                                                     \
+    std::size_t hash_value(const T& v) {                                                                  \
+        return ::boost::pfr::hash<T>{}(v);                                                                \
+    }                                                                                                     \
+/**/
+
 #endif // BOOST_PFR_PRECISE_FUNCTIONS_FOR_HPP
 
 
@@ -29,8 +29,8 @@ namespace detail {
 
     template <template <std::size_t, std::size_t> class Visitor, class T, class U>
     bool binary_visit(const T& x, const U& y) {
-        constexpr std::size_t fields_count_lhs = detail::fields_count<std::remove_reference_t<T>>();
-        constexpr std::size_t fields_count_rhs = detail::fields_count<std::remove_reference_t<U>>();
+        constexpr std::size_t fields_count_lhs = detail::reflection_info<std::remove_cv_t<std::remove_reference_t<T>>>.fields_count;
+        constexpr std::size_t fields_count_rhs = detail::reflection_info<std::remove_cv_t<std::remove_reference_t<U>>>.fields_count;
         constexpr std::size_t fields_count_min = detail::min_size(fields_count_lhs, fields_count_rhs);
         typedef Visitor<0, fields_count_min> visitor_t;
 
@@ -248,7 +248,7 @@ template <class T> struct hash {
     ///
     /// \rcast14
     std::size_t operator()(const T& x) const {
-        constexpr std::size_t fields_count = detail::fields_count<std::remove_reference_t<T>>();
+        constexpr std::size_t fields_count = detail::reflection_info<std::remove_cv_t<std::remove_reference_t<T>>>.fields_count;
 #if BOOST_PFR_USE_CPP17
         return detail::hash_impl<0, fields_count>::compute(detail::tie_as_tuple(x));
 #else
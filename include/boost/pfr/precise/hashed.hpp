@@ -0,0 +1,160 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_HASHED_HPP
+#define BOOST_PFR_PRECISE_HASHED_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include <boost/pfr/precise/functors.hpp>
+
+/// \file boost/pfr/precise/hashed.hpp
+/// Contains boost::pfr::hashed, aggregate with its cached hash value, and the specializations of boost::pfr::hash,
+/// boost::pfr::equal_to and std::hash for it.
+///
+/// \b Requires: C++17 or \constexprinit{C++14 constexpr aggregate intializable type}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+/// \brief Value of type `T` with its hash computed by `Hash` on construction and on modification.
+///
+/// Hashing of a boost::pfr::hashed returns the cached value. Comparison for equality compares the hashes first and
+/// compares the fields with boost::pfr::equal_to only if the hashes are equal, so most of the unequal values are rejected
+/// without touching the fields. Useful as a key of the hash containers, especially if the same key is looked up in
+/// multiple containers or has expensive to hash fields like strings.
+///
+/// `Hash` must be a default constructible function object that returns equal hashes for the values that are equal
+/// according to boost::pfr::equal_to.
+///
+/// \b Example:
+/// \code
+///     struct order_key { std::string symbol; std::int32_t account; };
+///     typedef boost::pfr::hashed<order_key> key_t;
+///
+///     std::unordered_map<key_t, double> positions;          // uses std::hash<key_t>
+///     boost::pfr::concurrent_hash_map<key_t, double> limits; // uses boost::pfr::hash<key_t>
+///
+///     const key_t key = boost::pfr::make_hashed(order_key{"MSFT", 42});   // hashed once...
+///     positions[key] += 100;
+///     limits.insert(key, 1e6);                                            // ...used twice
+///
+///     key_t k2 = key;
+///     k2.modify([](order_key& k) { k.account = 43; });                    // rehashed
+/// \endcode
+template <class T, class Hash = ::boost::pfr::hash<T>>
+class hashed {
+public:
+    typedef T       value_type;
+    typedef Hash    hasher;
+
+    /// Constructs the value with `T{}`.
+    hashed()
+        : hashed(T{})
+    {}
+
+    explicit hashed(const T& value)
+        : hash_(Hash{}(value))
+        , value_(value)
+    {}
+
+    explicit hashed(T&& value)
+        : hash_(Hash{}(value))
+        , value_(std::move(value))
+    {}
+
+    const T& value() const noexcept     { return value_; }
+    const T& operator*() const noexcept { return value_; }
+    const T* operator->() const noexcept { return &value_; }
+
+    /// \return the cached hash value.
+    std::size_t hash() const noexcept {
+        return hash_;
+    }
+
+    /// Calls `f(value)` with a mutable reference to the value and recomputes the hash. The hash is recomputed even if
+    /// `f` throws.
+    template <class F>
+    void modify(F&& f) {
+        try {
+            std::forward<F>(f)(value_);
+        } catch (...) {
+            hash_ = Hash{}(value_);
+            throw;
+        }
+        hash_ = Hash{}(value_);
+    }
+
+    /// Replaces the value and recomputes the hash.
+    hashed& operator=(const T& value) {
+        return *this = hashed(value);
+    }
+
+    /// \overload
+    hashed& operator=(T&& value) {
+        return *this = hashed(std::move(value));
+    }
+
+    hashed(const hashed&) = default;
+    hashed(hashed&&) = default;
+    hashed& operator=(const hashed&) = default;
+    hashed& operator=(hashed&&) = default;
+
+    friend bool operator==(const hashed& x, const hashed& y) {
+        return x.hash_ == y.hash_ && ::boost::pfr::equal_to<T>{}(x.value_, y.value_);
+    }
+
+    friend bool operator!=(const hashed& x, const hashed& y) {
+        return !(x == y);
+    }
+
+private:
+    std::size_t     hash_;      // first, so that the comparisons of the hashes touch only the beginning of the object
+    T               value_;
+};
+
+/// \return boost::pfr::hashed that holds `value`.
+template <class T>
+hashed<std::decay_t<T>> make_hashed(T&& value) {
+    return hashed<std::decay_t<T>>(std::forward<T>(value));
+}
+
+/// \brief Returns the cached hash of boost::pfr::hashed.
+template <class T, class Hash>
+struct hash<hashed<T, Hash>> {
+    std::size_t operator()(const hashed<T, Hash>& x) const noexcept {
+        return x.hash();
+    }
+};
+
+/// \brief Compares the hashes of boost::pfr::hashed before the fields.
+template <class T, class Hash>
+struct equal_to<hashed<T, Hash>> {
+    bool operator()(const hashed<T, Hash>& x, const hashed<T, Hash>& y) const {
+        return x == y;
+    }
+};
+
+}} // namespace boost::pfr
+
+namespace std {
+
+/// \brief Returns the cached hash of boost::pfr::hashed.
+template <class T, class Hash>
+struct hash<::boost::pfr::hashed<T, Hash>> {
+    std::size_t operator()(const ::boost::pfr::hashed<T, Hash>& x) const noexcept {
+        return x.hash();
+    }
+};
+
+} // namespace std
+
+#endif // BOOST_PFR_PRECISE_HASHED_HPP
@@ -0,0 +1,267 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_INLINE_RECORD_HPP
+#define BOOST_PFR_PRECISE_INLINE_RECORD_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/precise/core.hpp>
+#include <boost/pfr/precise/tuple_size.hpp>
+
+/// \file boost/pfr/precise/inline_record.hpp
+/// Contains boost::pfr::inline_record, trivially copyable mirror of an aggregate with strings and vectors stored inline.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+/// \brief String of at most `Cap` chars stored inline with a length byte. Unused chars are always zero, so equal strings
+/// are bitwise equal.
+template <std::size_t Cap>
+struct inline_string {
+    static_assert(Cap > 0 && Cap < 256, "====================> Boost.PFR: Capacity of inline_string must be in range [1, 255]");
+
+    unsigned char   length;
+    char            chars[Cap];
+
+    /// \throws std::length_error if `size > Cap`.
+    void assign(const char* data, std::size_t size) {
+        if (size > Cap) {
+            throw std::length_error("boost::pfr::inline_string: string is longer than the capacity");
+        }
+        length = static_cast<unsigned char>(size);
+        std::memcpy(chars, data, size);
+        std::memset(chars + size, 0, Cap - size);
+    }
+
+    const char* data() const noexcept { return chars; }
+    std::size_t size() const noexcept { return length; }
+    bool empty() const noexcept { return length == 0; }
+    std::string str() const { return std::string(chars, length); }
+};
+
+/// \brief Vector of at most `Cap` trivially copyable values stored inline with a length byte. Unused values are zero filled.
+template <class T, std::size_t Cap>
+struct inline_vector {
+    static_assert(Cap > 0 && Cap < 256, "====================> Boost.PFR: Capacity of inline_vector must be in range [1, 255]");
+    static_assert(std::is_trivially_copyable<T>::value, "====================> Boost.PFR: Values of inline_vector must be trivially copyable");
+
+    unsigned char   length;
+    T               items[Cap];
+
+    const T* data() const noexcept { return items; }
+    T* data() noexcept { return items; }
+    std::size_t size() const noexcept { return length; }
+    bool empty() const noexcept { return length == 0; }
+
+    const T* begin() const noexcept { return items; }
+    const T* end() const noexcept { return items + length; }
+    T* begin() noexcept { return items; }
+    T* end() noexcept { return items + length; }
+
+    const T& operator[](std::size_t i) const noexcept { return items[i]; }
+    T& operator[](std::size_t i) noexcept { return items[i]; }
+};
+
+template <class T, std::size_t Cap>
+struct inline_record;
+
+namespace detail {
+
+    ///////////////////// Types of the inline fields
+    template <class F, std::size_t Cap, class = void>
+    struct inline_mirror {
+        typedef ::boost::pfr::inline_record<F, Cap> type;    // aggregates with strings or vectors
+    };
+
+    template <class F, std::size_t Cap>
+    struct inline_mirror<F, Cap, std::enable_if_t<std::is_trivially_copyable<F>::value>> {
+        typedef F type;
+    };
+
+    template <class Traits, class Allocator, std::size_t Cap>
+    struct inline_mirror<std::basic_string<char, Traits, Allocator>, Cap, void> {
+        typedef ::boost::pfr::inline_string<Cap> type;
+    };
+
+    template <class E, class Allocator, std::size_t Cap>
+    struct inline_mirror<std::vector<E, Allocator>, Cap, void> {
+        typedef ::boost::pfr::inline_vector<typename inline_mirror<E, Cap>::type, Cap> type;
+    };
+
+    /// Fields of the mirror in the order of the fields of the aggregate. Nested aggregates without base classes, so the
+    /// mirror is a flat POD if all the fields are.
+    template <class... M>
+    struct inline_fields;
+
+    template <class M>
+    struct inline_fields<M> {
+        M head;
+    };
+
+    template <class M, class... Tail>
+    struct inline_fields<M, Tail...> {
+        M                       head;
+        inline_fields<Tail...>  tail;
+    };
+
+    template <class T, std::size_t Cap, class Seq = std::make_index_sequence<::boost::pfr::tuple_size_v<T>>>
+    struct inline_record_fields;
+
+    template <class T, std::size_t Cap, std::size_t... I>
+    struct inline_record_fields<T, Cap, std::index_sequence<I...>> {
+        static_assert(sizeof...(I) > 0, "====================> Boost.PFR: inline_record requires an aggregate with fields");
+        typedef inline_fields<typename inline_mirror<::boost::pfr::tuple_element_t<I, T>, Cap>::type...> type;
+    };
+
+    template <class Fields>
+    constexpr auto& inline_field(Fields& f, std::integral_constant<std::size_t, 0>) noexcept {
+        return f.head;
+    }
+
+    template <class Fields, std::size_t I>
+    constexpr auto& inline_field(Fields& f, std::integral_constant<std::size_t, I>) noexcept {
+        return detail::inline_field(f.tail, std::integral_constant<std::size_t, I - 1>{});
+    }
+
+    ///////////////////// Conversions of the fields
+    template <class F>
+    void inline_assign(F& to, const F& from) noexcept {
+        to = from;
+    }
+
+    template <std::size_t Cap, class Traits, class Allocator>
+    void inline_assign(::boost::pfr::inline_string<Cap>& to, const std::basic_string<char, Traits, Allocator>& from) {
+        to.assign(from.data(), from.size());
+    }
+
+    template <class M, std::size_t Cap, class E, class Allocator>
+    void inline_assign(::boost::pfr::inline_vector<M, Cap>& to, const std::vector<E, Allocator>& from) {
+        if (from.size() > Cap) {
+            throw std::length_error("boost::pfr::inline_vector: vector is longer than the capacity");
+        }
+        to.length = static_cast<unsigned char>(from.size());
+        std::memset(to.items, 0, sizeof(to.items));
+        for (std::size_t i = 0; i < from.size(); ++i) {
+            detail::inline_assign(to.items[i], from[i]);
+        }
+    }
+
+    template <class T, std::size_t Cap>
+    void inline_assign(::boost::pfr::inline_record<T, Cap>& to, const T& from) {
+        to = ::boost::pfr::inline_record<T, Cap>::from(from);
+    }
+
+    template <class F>
+    void inline_restore(F& to, const F& from) noexcept {
+        to = from;
+    }
+
+    template <class Traits, class Allocator, std::size_t Cap>
+    void inline_restore(std::basic_string<char, Traits, Allocator>& to, const ::boost::pfr::inline_string<Cap>& from) {
+        to.assign(from.data(), from.size());
+    }
+
+    template <class E, class Allocator, class M, std::size_t Cap>
+    void inline_restore(std::vector<E, Allocator>& to, const ::boost::pfr::inline_vector<M, Cap>& from) {
+        to.resize(from.size());
+        for (std::size_t i = 0; i < from.size(); ++i) {
+            detail::inline_restore(to[i], from.items[i]);
+        }
+    }
+
+    template <class T, std::size_t Cap>
+    void inline_restore(T& to, const ::boost::pfr::inline_record<T, Cap>& from) {
+        to = from.to_value();
+    }
+
+} // namespace detail
+
+/// \brief Trivially copyable mirror of aggregate `T`: `std::string` fields are stored as boost::pfr::inline_string<Cap>,
+/// `std::vector` fields as boost::pfr::inline_vector of at most `Cap` mirrored values, nested aggregates with such fields
+/// as inline_record<Nested, Cap>, other trivially copyable fields as is.
+///
+/// The mirror has no pointers, so arrays of mirrors could be copied with `std::memcpy`, written to files and memory mapped
+/// back, and all the values of a record are in one contiguous block. If all the fields of `T` are flat PODs, the mirror is a
+/// flat POD too and works with the boost::pfr::flat_* functions. Padding of the mirror, unused chars and unused values are
+/// zero filled by from(), so records with equal values are bitwise equal unless the trivially copyable fields themselves have
+/// padding.
+///
+/// \b Example:
+/// \code
+///     struct quote { std::string symbol; double bid; double ask; std::string venue; };
+///
+///     typedef boost::pfr::inline_record<quote, 15> packed_quote;  // 16 bytes per string
+///     static_assert(std::is_trivially_copyable<packed_quote>::value, "");
+///
+///     std::vector<packed_quote> v;
+///     v.push_back(packed_quote::from(quote{"AAPL", 189.5, 189.52, "XNAS"}));
+///     assert(v[0].get<0>().str() == "AAPL");
+///     quote q = v[0].to_value();
+/// \endcode
+template <class T, std::size_t Cap>
+struct inline_record {
+    typedef T value_type;
+    typedef typename detail::inline_record_fields<T, Cap>::type fields_type;
+
+    /// Mirrors of the fields of `T` in order, use get<I>() to access them.
+    fields_type fields;
+
+    /// \return mirror of `value`.
+    /// \throws std::length_error if a string or a vector of `value` is longer than `Cap`.
+    static inline_record from(const T& value) {
+        inline_record result;
+        std::memset(&result, 0, sizeof(result));
+        result.assign_impl(value, std::make_index_sequence<::boost::pfr::tuple_size_v<T>>{});
+        return result;
+    }
+
+    /// \return the aggregate with the values of the mirror.
+    T to_value() const {
+        T result{};
+        restore_impl(result, std::make_index_sequence<::boost::pfr::tuple_size_v<T>>{});
+        return result;
+    }
+
+    /// \return mirror of the field `I` of `T`.
+    template <std::size_t I>
+    auto& get() noexcept {
+        return detail::inline_field(fields, std::integral_constant<std::size_t, I>{});
+    }
+
+    /// \return mirror of the field `I` of `T`.
+    template <std::size_t I>
+    const auto& get() const noexcept {
+        return detail::inline_field(fields, std::integral_constant<std::size_t, I>{});
+    }
+
+private:
+    template <std::size_t... I>
+    void assign_impl(const T& value, std::index_sequence<I...>) {
+        const int ignore[] = {0, (detail::inline_assign(this->template get<I>(), ::boost::pfr::get<I>(value)), 0)...};
+        (void)ignore;
+    }
+
+    template <std::size_t... I>
+    void restore_impl(T& value, std::index_sequence<I...>) const {
+        const int ignore[] = {0, (detail::inline_restore(::boost::pfr::get<I>(value), this->template get<I>()), 0)...};
+        (void)ignore;
+    }
+};
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_INLINE_RECORD_HPP
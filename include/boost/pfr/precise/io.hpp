@@ -39,7 +39,7 @@ namespace boost { namespace pfr {
 /// \endcode
 template <class Char, class Traits, class T>
 void write(std::basic_ostream<Char, Traits>& out, const T& value) {
-    constexpr std::size_t fields_count = detail::fields_count<std::remove_reference_t<T>>();
+    constexpr std::size_t fields_count = detail::reflection_info<std::remove_cv_t<std::remove_reference_t<T>>>.fields_count;
     out << '{';
 #if BOOST_PFR_USE_CPP17
     detail::print_impl<0, fields_count>::print(out, detail::tie_as_tuple(value));
@@ -73,7 +73,7 @@ void write(std::basic_ostream<Char, Traits>& out, const T& value) {
 /// \endcode
 template <class Char, class Traits, class T>
 void read(std::basic_istream<Char, Traits>& in, T& value) {
-    constexpr std::size_t fields_count = detail::fields_count<std::remove_reference_t<T>>();
+    constexpr std::size_t fields_count = detail::reflection_info<std::remove_cv_t<std::remove_reference_t<T>>>.fields_count;
 
     const auto prev_exceptions = in.exceptions();
     in.exceptions( typename std::basic_istream<Char, Traits>::iostate(0) );
@@ -0,0 +1,113 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_KWAY_MERGE_HPP
+#define BOOST_PFR_PRECISE_KWAY_MERGE_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/key_fields.hpp>
+#include <boost/pfr/detail/loser_tree.hpp>
+
+/// \file boost/pfr/precise/kway_merge.hpp
+/// Contains boost::pfr::kway_merge_by that merges any number of sorted sequences of aggregates by their key fields.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    template <class It, class Sentinel>
+    struct merge_cursor {
+        It first;
+        Sentinel last;
+    };
+
+} // namespace detail
+
+/// \brief Merges the sorted input ranges of `streams` by the fields `I...` (by all the fields if `I...` is empty), calling
+/// `sink(value)` for each value in the merged order.
+///
+/// Uses a tournament tree of losers: each value costs log2(streams count) comparisons. Key fields of the current value of
+/// each stream are copied once when the stream advances, keys with only integral and enum fields are kept as normalized
+/// 64 bit words, so the matches compare compact cached keys instead of reading the values through the reflection. Once a
+/// single stream remains it is passed to `sink` without comparisons.
+///
+/// The merge is stable: values with equal keys go in the order of the streams, and in their order within each stream.
+/// Streams are traversed once, so they could be input ranges that read from files or sockets.
+///
+/// \param streams Range of input ranges of aggregates of the same type, for example `std::vector<std::vector<T>>` or
+/// `std::vector<boost::pfr::mapped_npy<T>>`. Ranges are traversed through the copies of their iterators.
+/// \param sink Function object called with each value of the streams.
+///
+/// \pre Each stream is sorted in lexicographical order of the fields `I...`.
+///
+/// \b Example:
+/// \code
+///     struct tick { std::int64_t ts; std::uint32_t venue; double price; };
+///     std::vector<std::vector<tick>> feeds = load_feeds();    // one feed per venue, ordered by time
+///
+///     std::vector<tick> consolidated;
+///     boost::pfr::kway_merge_by<0>(feeds, [&consolidated](const tick& t) { consolidated.push_back(t); });
+/// \endcode
+template <std::size_t... I, class Streams, class Sink>
+void kway_merge_by(Streams& streams, Sink&& sink) {
+    using std::begin;
+    using std::end;
+    typedef decltype(begin(*begin(streams))) iterator_t;
+    typedef decltype(end(*begin(streams))) sentinel_t;
+    typedef std::remove_cv_t<std::remove_reference_t<decltype(*std::declval<iterator_t&>())>> value_t;
+    typedef detail::key_fields<value_t, I...> key_fields_t;
+
+    std::vector<detail::merge_cursor<iterator_t, sentinel_t>> cursors;
+    for (auto&& stream : streams) {
+        cursors.push_back({begin(stream), end(stream)});
+    }
+
+    const std::size_t k = cursors.size();
+    detail::merge_tree<key_fields_t> tree(k);
+    std::size_t active = 0;
+    for (std::size_t s = 0; s < k; ++s) {
+        if (cursors[s].first != cursors[s].last) {
+            tree.load(s, *cursors[s].first);
+            ++active;
+        } else {
+            tree.exhaust(s);
+        }
+    }
+    if (!active) {
+        return;
+    }
+
+    tree.build();
+    while (active > 1) {
+        auto& cursor = cursors[tree.top()];
+        sink(*cursor.first);
+        if (++cursor.first != cursor.last) {
+            tree.replace_top(*cursor.first);
+        } else {
+            tree.exhaust_top();
+            --active;
+        }
+    }
+
+    auto& cursor = cursors[tree.top()];
+    for (; cursor.first != cursor.last; ++cursor.first) {
+        sink(*cursor.first);
+    }
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_KWAY_MERGE_HPP
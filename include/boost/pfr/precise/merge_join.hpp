@@ -0,0 +1,108 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_MERGE_JOIN_HPP
+#define BOOST_PFR_PRECISE_MERGE_JOIN_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <boost/pfr/detail/key_fields.hpp>
+#include <boost/pfr/precise/fields.hpp>
+
+/// \file boost/pfr/precise/merge_join.hpp
+/// Contains merge join of two sorted sequences of aggregates on their key fields.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+/// \brief Joins two sequences of aggregates sorted by the key fields `LeftFields` and `RightFields` respectively.
+///
+/// Each input is traversed once, each step does a single three-way comparison of the keys. Input iterators are supported,
+/// so the inputs could be read from streams or memory mapped files without materializing them.
+///
+/// For each value of the left sequence calls `on_match(left_value, right_value)` if there's a value with equal key in the right sequence,
+/// `on_left_only(left_value)` otherwise. For the right values that were not matched calls `on_right_only(right_value)`.
+/// Values with equal keys are matched pairwise in order of the sequences, unmatched values with duplicate keys are reported as
+/// `on_left_only` or `on_right_only`. All the functions are called in the key order.
+///
+/// \tparam LeftFields boost::pfr::fields with indexes of the key fields in the left values, boost::pfr::fields<> for all the fields.
+/// \tparam RightFields boost::pfr::fields with indexes of the key fields in the right values.
+///
+/// \pre Both sequences are sorted in lexicographical order of their key fields.
+///
+/// \b Example:
+/// \code
+///     struct our_order { int account; long order_id; double price; };
+///     struct exchange_order { long order_id; int account; double price; };
+///
+///     boost::pfr::merge_join<boost::pfr::fields<0, 1>, boost::pfr::fields<1, 0>>(
+///         ours.begin(), ours.end(), theirs.begin(), theirs.end(),
+///         [](const our_order& l, const exchange_order& r) { if (l.price != r.price) report_mismatch(l, r); },
+///         [](const our_order& l) { report_missing_at_exchange(l); },
+///         [](const exchange_order& r) { report_unknown_order(r); }
+///     );
+/// \endcode
+template <class LeftFields, class RightFields, class LeftIt, class RightIt, class OnMatch, class OnLeftOnly, class OnRightOnly>
+void merge_join(LeftIt left_first, LeftIt left_last, RightIt right_first, RightIt right_last,
+                OnMatch&& on_match, OnLeftOnly&& on_left_only, OnRightOnly&& on_right_only)
+{
+    typedef typename detail::key_fields_of<typename std::iterator_traits<LeftIt>::value_type, LeftFields>::type left_key_t;
+    typedef typename detail::key_fields_of<typename std::iterator_traits<RightIt>::value_type, RightFields>::type right_key_t;
+    static_assert(
+        left_key_t::size == right_key_t::size,
+        "====================> Boost.PFR: Left and right keys must have the same count of fields"
+    );
+
+    while (left_first != left_last && right_first != right_last) {
+        auto&& left = *left_first;
+        auto&& right = *right_first;
+        const int cmp = detail::compare_tuples(
+            left_key_t::tie(left), right_key_t::tie(right), std::make_index_sequence<left_key_t::size>{}
+        );
+
+        if (cmp < 0) {
+            on_left_only(left);
+            ++left_first;
+        } else if (cmp > 0) {
+            on_right_only(right);
+            ++right_first;
+        } else {
+            on_match(left, right);
+            ++left_first;
+            ++right_first;
+        }
+    }
+
+    for (; left_first != left_last; ++left_first) {
+        on_left_only(*left_first);
+    }
+
+    for (; right_first != right_last; ++right_first) {
+        on_right_only(*right_first);
+    }
+}
+
+/// \overload merge_join
+/// Joins ranges `left` and `right`.
+template <class LeftFields, class RightFields, class LeftRange, class RightRange, class OnMatch, class OnLeftOnly, class OnRightOnly>
+void merge_join(LeftRange&& left, RightRange&& right, OnMatch&& on_match, OnLeftOnly&& on_left_only, OnRightOnly&& on_right_only) {
+    using std::begin;
+    using std::end;
+    ::boost::pfr::merge_join<LeftFields, RightFields>(
+        begin(left), end(left), begin(right), end(right),
+        std::forward<OnMatch>(on_match), std::forward<OnLeftOnly>(on_left_only), std::forward<OnRightOnly>(on_right_only)
+    );
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_MERGE_JOIN_HPP
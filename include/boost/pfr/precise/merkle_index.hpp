@@ -0,0 +1,235 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_MERKLE_INDEX_HPP
+#define BOOST_PFR_PRECISE_MERKLE_INDEX_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <boost/pfr/detail/xxhash64.hpp>
+#include <boost/pfr/precise/stable_hash.hpp>
+
+/// \file boost/pfr/precise/merkle_index.hpp
+/// Contains boost::pfr::merkle_index, tree of hashes over blocks of records that finds the differing records of two copies of
+/// a table without comparing all of them.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    struct merkle_stable_hash {
+        template <class T>
+        std::uint64_t operator()(const T& value) const {
+            return ::boost::pfr::stable_hash(value);
+        }
+    };
+
+    /// Hash of a record at position `pos`: records with equal values at different positions contribute differently.
+    inline std::uint64_t merkle_record_hash(std::size_t pos, std::uint64_t value_hash) noexcept {
+        detail::xxhash64 state(static_cast<std::uint64_t>(pos));
+        state.update(value_hash);
+        return state.finish();
+    }
+
+    inline std::uint64_t merkle_node_hash(const std::uint64_t* children, std::size_t count) noexcept {
+        detail::xxhash64 state(static_cast<std::uint64_t>(count));
+        for (std::size_t i = 0; i < count; ++i) {
+            state.update(children[i]);
+        }
+        return state.finish();
+    }
+
+} // namespace detail
+
+/// Range of records [first, last) reported by boost::pfr::merkle_index::diff.
+struct merkle_range {
+    std::size_t first;
+    std::size_t last;
+};
+
+/// \brief Tree of hashes over the blocks of `BlockSize` records of type `T`, for synchronizing copies of a table by
+/// exchanging and comparing only the hashes of their differing parts.
+///
+/// Hash of a block is the sum of the hashes of its records mixed with their positions, so changing or appending a record
+/// updates the hash of its block without reading the other records of the block. Then the log2(blocks count) hashes on
+/// the path to the root are recomputed. The index does not keep the records, the caller passes the previous value of the
+/// record on update.
+///
+/// diff() descends only into the subtrees with different hashes, so finding `d` differing blocks of `n` takes about
+/// d * log2(n) comparisons instead of `n`. Hashes of the levels are available through level() for sending them to a
+/// remote replica.
+///
+/// \tparam Hash function object that returns a 64 bit hash of `T`. The default boost::pfr::stable_hash gives the same hashes
+/// on all the platforms, so the indexes of the replicas on different machines are comparable.
+///
+/// \b Example:
+/// \code
+///     struct position { std::uint64_t account; std::int64_t qty; double price; };
+///     std::vector<position> primary = load(), replica = primary;
+///     boost::pfr::merkle_index<position> primary_index(primary.begin(), primary.end());
+///     boost::pfr::merkle_index<position> replica_index(replica.begin(), replica.end());
+///
+///     primary_index.update(42, primary[42], position{7, 100, 1.5});   // old and new values
+///     primary[42] = position{7, 100, 1.5};
+///
+///     for (boost::pfr::merkle_range r : primary_index.diff(replica_index)) {
+///         std::copy(primary.begin() + r.first, primary.begin() + r.last, replica.begin() + r.first);  // block with 42
+///     }
+/// \endcode
+template <class T, std::size_t BlockSize = 256, class Hash = detail::merkle_stable_hash>
+class merkle_index {
+    static_assert(BlockSize > 0, "====================> Boost.PFR: BlockSize must be positive");
+
+public:
+    typedef T       value_type;
+    typedef Hash    hasher;
+
+    /// Count of records in a block.
+    static constexpr std::size_t block_size = BlockSize;
+
+    /// Constructs an index of an empty table.
+    merkle_index()
+        : levels_(1)
+    {}
+
+    /// Constructs an index of the records in range [first, last). Input iterators are supported.
+    template <class InputIt>
+    merkle_index(InputIt first, InputIt last)
+        : levels_(1)
+    {
+        for (; first != last; ++first) {
+            add_to_leaf(*first);
+        }
+        for (std::size_t l = 1; levels_[l - 1].size() > 1; ++l) {
+            levels_.emplace_back((levels_[l - 1].size() + 1) / 2);
+            for (std::size_t i = 0; i < levels_[l].size(); ++i) {
+                levels_[l][i] = node_hash(l, i);
+            }
+        }
+    }
+
+    /// \return count of records in the table.
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /// Updates the hashes after the record at position `pos` is changed from `old_value` to `new_value`.
+    /// \pre `pos < size()`, `old_value` is the value that was hashed at position `pos`.
+    void update(std::size_t pos, const T& old_value, const T& new_value) {
+        const std::size_t block = pos / BlockSize;
+        levels_[0][block] += detail::merkle_record_hash(pos, Hash{}(new_value))
+            - detail::merkle_record_hash(pos, Hash{}(old_value));
+        update_path(block);
+    }
+
+    /// Updates the hashes after `value` is appended to the table.
+    void push_back(const T& value) {
+        add_to_leaf(value);
+        update_path((size_ - 1) / BlockSize);
+    }
+
+    /// \return hash of all the records, 0 for an empty table.
+    std::uint64_t root_hash() const noexcept {
+        return levels_.back().empty() ? 0 : levels_.back()[0];
+    }
+
+    /// \return count of levels of the tree, the last level has a single hash for non empty tables.
+    std::size_t levels_count() const noexcept {
+        return levels_.size();
+    }
+
+    /// \return hashes of the level `l`. Level 0 has hashes of the blocks, hash `i` of level `l` covers the blocks
+    /// [i << l, (i + 1) << l).
+    const std::vector<std::uint64_t>& level(std::size_t l) const noexcept {
+        return levels_[l];
+    }
+
+    /// \return ordered and not adjacent ranges of records that differ between this table and the table of `other`,
+    /// with the granularity of blocks. Records that exist in only one of the tables are reported as differing.
+    std::vector<merkle_range> diff(const merkle_index& other) const {
+        std::vector<merkle_range> result;
+        const std::size_t top = (std::max)(levels_.size(), other.levels_.size()) - 1;
+        diff_subtree(other, top, 0, result);
+        return result;
+    }
+
+private:
+    void add_to_leaf(const T& value) {
+        if (size_ % BlockSize == 0) {
+            levels_[0].push_back(0);
+        }
+        levels_[0].back() += detail::merkle_record_hash(size_, Hash{}(value));
+        ++size_;
+    }
+
+    std::uint64_t node_hash(std::size_t l, std::size_t i) const noexcept {
+        const std::vector<std::uint64_t>& children = levels_[l - 1];
+        return detail::merkle_node_hash(children.data() + 2 * i, (std::min)(children.size() - 2 * i, std::size_t{2}));
+    }
+
+    /// Recomputes the hashes over the block, adding the nodes and the levels that appeared after push_back().
+    void update_path(std::size_t block) {
+        std::size_t i = block;
+        for (std::size_t l = 1; levels_[l - 1].size() > 1; ++l) {
+            if (levels_.size() == l) {
+                levels_.emplace_back();
+            }
+            levels_[l].resize((levels_[l - 1].size() + 1) / 2);
+            i /= 2;
+            levels_[l][i] = node_hash(l, i);
+        }
+    }
+
+    const std::uint64_t* node(std::size_t l, std::size_t i) const noexcept {
+        return (l < levels_.size() && i < levels_[l].size() ? &levels_[l][i] : nullptr);
+    }
+
+    void diff_subtree(const merkle_index& other, std::size_t l, std::size_t i, std::vector<merkle_range>& result) const {
+        const std::uint64_t* const mine = node(l, i);
+        const std::uint64_t* const theirs = other.node(l, i);
+        if ((!mine && !theirs) || (mine && theirs && *mine == *theirs)) {
+            return;
+        }
+
+        // Trees of tables of different sizes have different heights: the root of the lower tree is compared with the
+        // leftmost node of the higher tree on the same level
+        const bool above_lower_root = (i == 0 && (l >= levels_.size() || l >= other.levels_.size()));
+        if (l > 0 && ((mine && theirs) || above_lower_root)) {
+            diff_subtree(other, l - 1, 2 * i, result);
+            diff_subtree(other, l - 1, 2 * i + 1, result);
+            return;
+        }
+
+        // Leaf that differs or subtree that exists only in one of the tables
+        const std::size_t records = (std::max)(size_, other.size_);
+        const std::size_t first = (std::min)((i << l) * BlockSize, records);
+        const std::size_t last = (std::min)(((i + 1) << l) * BlockSize, records);
+        if (!result.empty() && result.back().last == first) {
+            result.back().last = last;
+        } else if (first != last) {
+            result.push_back({first, last});
+        }
+    }
+
+    std::vector<std::vector<std::uint64_t>> levels_;    // levels_[0] are the hashes of the blocks
+    std::size_t                             size_ = 0;
+};
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_MERKLE_INDEX_HPP
@@ -0,0 +1,274 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_PACKED_COLUMN_HPP
+#define BOOST_PFR_PRECISE_PACKED_COLUMN_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/bitpack.hpp>
+#include <boost/pfr/precise/core.hpp>
+
+/// \file boost/pfr/precise/packed_column.hpp
+/// Contains boost::pfr::packed_column, integer column compressed with frame of reference and bit packing, and
+/// boost::pfr::pack_field that builds it from a field of aggregates.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+    struct identity_projection {
+        template <class T>
+        const T& operator()(const T& value) const noexcept {
+            return value;
+        }
+    };
+} // namespace detail
+
+/// \brief Read-only column of integers compressed in blocks of 256 values. Each block stores its minimum and the
+/// differences from it packed with the count of bits that the largest difference requires.
+///
+/// Columns of timestamps, sequence numbers and quantities usually have small ranges within a block and take 4-16 bits per
+/// value instead of 64. Packing and unpacking use AVX2 if it is enabled at compile time. count_between and select_between
+/// skip the blocks outside of the range or fully inside it by their bounds and compare the remaining blocks in the packed
+/// representation.
+///
+/// \b Example:
+/// \code
+///     struct trade { std::int64_t timestamp; std::uint32_t qty; double price; };
+///     std::vector<trade> trades = ...;
+///
+///     const auto timestamps = boost::pfr::pack_field<0>(trades);
+///     std::size_t in_second = timestamps.count_between(start, start + 999999999);
+///     std::int64_t t = timestamps[42];
+/// \endcode
+template <class Int>
+class packed_column {
+    static_assert(
+        std::is_integral<Int>::value && sizeof(Int) <= sizeof(std::uint64_t),
+        "====================> Boost.PFR: packed_column requires integral values of at most 64 bits"
+    );
+
+    static constexpr std::uint64_t sign_bit = std::uint64_t(1) << 63;
+
+    // Keys are unsigned and have the same order as the values
+    static std::uint64_t to_key(Int value) noexcept {
+        return std::is_signed<Int>::value
+            ? static_cast<std::uint64_t>(static_cast<std::int64_t>(value)) ^ sign_bit
+            : static_cast<std::uint64_t>(value);
+    }
+
+    static Int from_key(std::uint64_t key) noexcept {
+        return std::is_signed<Int>::value
+            ? static_cast<Int>(static_cast<std::int64_t>(key ^ sign_bit))
+            : static_cast<Int>(key);
+    }
+
+public:
+    typedef Int value_type;
+
+    /// Count of values in a block.
+    static constexpr std::size_t block_size = detail::bitpack_block_size;
+
+    /// Constructs an empty column.
+    packed_column() = default;
+
+    /// Packs the values `proj(*it)` for `it` in `[first, last)`. Input iterators are supported.
+    template <class It, class Projection = detail::identity_projection>
+    packed_column(It first, It last, Projection proj = Projection{}) {
+        std::uint64_t keys[block_size];
+        std::size_t n = 0;
+        for (; first != last; ++first) {
+            keys[n++] = to_key(static_cast<Int>(proj(*first)));
+            if (n == block_size) {
+                append_block(keys, n);
+                n = 0;
+            }
+        }
+        if (n) {
+            append_block(keys, n);
+        }
+    }
+
+    /// \return count of values.
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /// \return value with index `i`.
+    Int operator[](std::size_t i) const noexcept {
+        const std::size_t b = i / block_size;
+        return from_key(mins_[b] + detail::bitunpack_one(words_.data() + offsets_[b], bits_[b], i % block_size));
+    }
+
+    /// Unpacks all the values into `out`.
+    template <class OutputIt>
+    OutputIt decode(OutputIt out) const {
+        std::uint64_t deltas[block_size];
+        for (std::size_t b = 0; b < mins_.size(); ++b) {
+            detail::bitunpack_block(words_.data() + offsets_[b], bits_[b], deltas);
+            const std::size_t n = block_values(b);
+            for (std::size_t i = 0; i < n; ++i) {
+                *out = from_key(mins_[b] + deltas[i]);
+                ++out;
+            }
+        }
+        return out;
+    }
+
+    /// \return count of values `v` with `low <= v && v <= high`.
+    std::size_t count_between(Int low, Int high) const noexcept {
+        std::size_t result = 0;
+        scan_between(low, high, [&result](std::size_t /*b*/, std::size_t n, const std::uint64_t* matches) {
+            if (!matches) {
+                result += n;
+                return;
+            }
+            for (std::size_t w = 0; w < 4; ++w) {
+                result += detail::popcount(matches[w]);
+            }
+        });
+        return result;
+    }
+
+    /// Writes indexes of the values `v` with `low <= v && v <= high` into `out` in ascending order.
+    template <class OutputIt>
+    OutputIt select_between(Int low, Int high, OutputIt out) const {
+        scan_between(low, high, [&out](std::size_t b, std::size_t n, const std::uint64_t* matches) {
+            const std::size_t first = b * block_size;
+            if (!matches) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    *out = first + i;
+                    ++out;
+                }
+                return;
+            }
+            for (std::size_t w = 0; w < 4; ++w) {
+                for (std::uint64_t m = matches[w]; m; m &= m - 1) {
+                    *out = first + w * 64 + detail::bit_width(m & (~m + 1)) - 1;
+                    ++out;
+                }
+            }
+        });
+        return out;
+    }
+
+    /// \return count of bytes used by the packed values and the block headers.
+    std::size_t memory_usage() const noexcept {
+        return words_.size() * sizeof(std::uint64_t)
+            + mins_.size() * (2 * sizeof(std::uint64_t) + sizeof(std::size_t) + sizeof(unsigned char));
+    }
+
+private:
+    std::size_t block_values(std::size_t b) const noexcept {
+        return (std::min)(block_size, size_ - b * block_size);
+    }
+
+    void append_block(std::uint64_t (&keys)[block_size], std::size_t n) {
+        const std::uint64_t min = *std::min_element(keys, keys + n);
+        const std::uint64_t max = *std::max_element(keys, keys + n);
+        for (std::size_t i = 0; i < n; ++i) {
+            keys[i] -= min;
+        }
+        std::fill(keys + n, keys + block_size, std::uint64_t(0));
+
+        const unsigned bits = detail::bit_width(max - min);
+        const std::size_t offset = words_.size();
+        words_.resize(offset + detail::bitpack_lanes * bits);
+        detail::bitpack_block(keys, bits, words_.data() + offset);
+
+        mins_.push_back(min);
+        maxs_.push_back(max);
+        offsets_.push_back(offset);
+        bits_.push_back(static_cast<unsigned char>(bits));
+        size_ += n;
+    }
+
+    /// Calls `f(block, count of values in block, matches)` for the blocks with values in range, `matches` is null if all
+    /// the values of the block are in range.
+    template <class F>
+    void scan_between(Int low, Int high, F f) const {
+        const std::uint64_t lo = to_key(low);
+        const std::uint64_t hi = to_key(high);
+        if (lo > hi) {
+            return;
+        }
+
+        std::uint64_t matches[4];
+        for (std::size_t b = 0; b < mins_.size(); ++b) {
+            if (maxs_[b] < lo || hi < mins_[b]) {
+                continue;
+            }
+
+            const std::size_t n = block_values(b);
+            if (lo <= mins_[b] && maxs_[b] <= hi) {
+                f(b, n, static_cast<const std::uint64_t*>(nullptr));
+                continue;
+            }
+
+            const std::uint64_t delta_lo = (lo > mins_[b] ? lo - mins_[b] : 0);
+            const std::uint64_t delta_hi = (hi < maxs_[b] ? hi : maxs_[b]) - mins_[b];
+            detail::bitpacked_match_block(words_.data() + offsets_[b], bits_[b], delta_lo, delta_hi, matches);
+            if (n < block_size) {
+                // Padding values of the last block
+                for (std::size_t i = n; i < block_size; ++i) {
+                    matches[i / 64] &= ~(std::uint64_t(1) << (i % 64));
+                }
+            }
+            f(b, n, static_cast<const std::uint64_t*>(matches));
+        }
+    }
+
+    std::vector<std::uint64_t>  words_;
+    std::vector<std::uint64_t>  mins_;
+    std::vector<std::uint64_t>  maxs_;
+    std::vector<std::size_t>    offsets_;
+    std::vector<unsigned char>  bits_;
+    std::size_t                 size_ = 0;
+};
+
+template <class Int>
+constexpr std::size_t packed_column<Int>::block_size;
+
+template <class Int>
+constexpr std::uint64_t packed_column<Int>::sign_bit;
+
+/// \brief Packs the field `I` of the aggregates of `records` into a boost::pfr::packed_column.
+///
+/// \b Example:
+/// \code
+///     struct quote { std::int64_t timestamp; std::uint32_t seq; double bid; double ask; };
+///     const auto seqs = boost::pfr::pack_field<1>(quotes);     // boost::pfr::packed_column<std::uint32_t>
+/// \endcode
+template <std::size_t I, class Range>
+auto pack_field(const Range& records) {
+    using std::begin;
+    using std::end;
+    typedef std::decay_t<decltype(*begin(records))> record_t;
+    typedef std::remove_cv_t<std::remove_reference_t<decltype(::boost::pfr::get<I>(std::declval<const record_t&>()))>> field_t;
+
+    return packed_column<field_t>(begin(records), end(records), [](const record_t& r) -> field_t {
+        return ::boost::pfr::get<I>(r);
+    });
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_PACKED_COLUMN_HPP
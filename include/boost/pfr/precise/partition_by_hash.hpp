@@ -0,0 +1,296 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_PARTITION_BY_HASH_HPP
+#define BOOST_PFR_PRECISE_PARTITION_BY_HASH_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/key_fields.hpp>
+#include <boost/pfr/detail/prefetch.hpp>
+
+/// \file boost/pfr/precise/partition_by_hash.hpp
+/// Contains functions for radix partitioning of aggregates by hash of their key fields, the first step of parallel group-by and hash join.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    /// Maps hash onto [0, partitions). Multiplication spreads the identity hashes of integers over the high bits,
+    /// multiply-shift range reduction avoids division.
+    inline std::uint32_t hash_to_partition(std::size_t hash, std::size_t partitions) noexcept {
+        const std::uint64_t mixed = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::uint32_t>(((mixed >> 32) * static_cast<std::uint64_t>(partitions)) >> 32);
+    }
+
+    /// Hashes the records [begin, end) once, stores their partitions into `ids` and counts them in `histogram`.
+    template <class KeyFields, class It>
+    void partition_histogram(It first, std::size_t begin, std::size_t end, std::size_t partitions,
+                             std::uint32_t* ids, std::size_t* histogram)
+    {
+        for (std::size_t i = begin; i < end; ++i) {
+            const std::uint32_t p = detail::hash_to_partition(KeyFields::hash(first[i]), partitions);
+            ids[i] = p;
+            ++histogram[p];
+        }
+    }
+
+    /// Software write-combining buffer of one partition: two cache lines of records that are flushed at once.
+    struct alignas(cache_line_size) partition_line {
+        unsigned char bytes[2 * cache_line_size];
+    };
+
+    /// Array of cache line aligned buffers. `new partition_line[n]` does not respect the alignment before C++17.
+    class partition_lines {
+    public:
+        explicit partition_lines(std::size_t n)
+            : storage_(new unsigned char[(n + 1) * sizeof(partition_line)])
+        {
+            void* p = storage_.get();
+            std::size_t space = (n + 1) * sizeof(partition_line);
+            lines_ = static_cast<partition_line*>(std::align(alignof(partition_line), n * sizeof(partition_line), p, space));
+        }
+
+        partition_line& operator[](std::size_t i) noexcept {
+            return lines_[i];
+        }
+
+    private:
+        std::unique_ptr<unsigned char[]>    storage_;
+        partition_line*                     lines_;
+    };
+
+    /// Write-combining buffers of a thread and their fill levels. Allocated before the threads start.
+    struct partition_buffers {
+        explicit partition_buffers(std::size_t partitions)
+            : lines(partitions)
+            , fill(new std::size_t[partitions])
+            , limit(new std::size_t[partitions])
+        {}
+
+        partition_lines                     lines;
+        std::unique_ptr<std::size_t[]>      fill;
+        std::unique_ptr<std::size_t[]>      limit;
+    };
+
+    /// \return count of records of size `size` from `out` to the next cache line boundary, or `per_line` if records can
+    /// not end on the boundary.
+    inline std::size_t records_to_line_boundary(const void* out, std::size_t size, std::size_t per_line) noexcept {
+        const std::size_t bytes = (cache_line_size - reinterpret_cast<std::uintptr_t>(out) % cache_line_size) % cache_line_size;
+        return (bytes && bytes % size == 0 ? bytes / size : per_line);
+    }
+
+    /// Copies the records [begin, end) into `out[positions[p]++]`, where `p` is the partition of the record.
+    /// Small trivially copyable records are gathered into per partition buffers, so the output is written by whole cache lines
+    /// instead of scattering single records over `partitions` distant memory locations. The first flush of a partition
+    /// is shortened to end on a line boundary, so the following flushes do not split lines.
+    template <class It, class T>
+    void partition_scatter(It first, std::size_t begin, std::size_t end, const std::uint32_t* ids,
+                           std::size_t* positions, std::size_t partitions, T* out, partition_buffers* buffers,
+                           std::true_type /*write combining*/)
+    {
+        constexpr std::size_t per_line = sizeof(partition_line) / sizeof(T);
+
+        partition_lines& lines = buffers->lines;
+        std::size_t* const fill = buffers->fill.get();
+        std::size_t* const limit = buffers->limit.get();
+        for (std::size_t p = 0; p < partitions; ++p) {
+            fill[p] = 0;
+            limit[p] = detail::records_to_line_boundary(out + positions[p], sizeof(T), per_line);
+        }
+
+        for (std::size_t i = begin; i < end; ++i) {
+            const std::uint32_t p = ids[i];
+            std::memcpy(lines[p].bytes + fill[p] * sizeof(T), std::addressof(first[i]), sizeof(T));
+            if (++fill[p] == limit[p]) {
+                std::memcpy(out + positions[p], lines[p].bytes, fill[p] * sizeof(T));
+                positions[p] += fill[p];
+                fill[p] = 0;
+                limit[p] = per_line;
+            }
+        }
+
+        for (std::size_t p = 0; p < partitions; ++p) {
+            if (fill[p]) {
+                std::memcpy(out + positions[p], lines[p].bytes, fill[p] * sizeof(T));
+                positions[p] += fill[p];
+            }
+        }
+    }
+
+    template <class It, class OutIt>
+    void partition_scatter(It first, std::size_t begin, std::size_t end, const std::uint32_t* ids,
+                           std::size_t* positions, std::size_t /*partitions*/, OutIt out, partition_buffers* /*buffers*/,
+                           std::false_type /*write combining*/)
+    {
+        for (std::size_t i = begin; i < end; ++i) {
+            out[positions[ids[i]]++] = first[i];
+        }
+    }
+
+    template <class It, class OutIt>
+    using use_write_combining = std::integral_constant<bool,
+        std::is_pointer<OutIt>::value
+        && std::is_same<typename std::iterator_traits<It>::value_type, std::remove_pointer_t<OutIt>>::value
+        && std::is_trivially_copyable<typename std::iterator_traits<It>::value_type>::value
+        && sizeof(typename std::iterator_traits<It>::value_type) * 2 <= sizeof(partition_line)
+    >;
+
+    template <class KeyFields, class It, class OutIt>
+    std::vector<std::size_t> partition_by_hash_impl(It first, std::size_t n, std::size_t partitions, OutIt out, std::size_t threads) {
+        if (!partitions) {
+            throw std::invalid_argument("boost::pfr::partition_by_hash: count of partitions must not be 0");
+        }
+        if (threads > n / 4096 + 1) {
+            threads = n / 4096 + 1;    // threads would not pay off for small inputs
+        }
+
+        std::vector<std::uint32_t> ids(n);
+        std::vector<std::size_t> histograms(threads * partitions);    // `partitions` counters per thread
+        const auto chunk_begin = [n, threads](std::size_t t) { return n / threads * t + (t < n % threads ? t : n % threads); };
+
+        // Runs `f(t)` for all the threads. Exceptions of the threads and of their creation are rethrown after all the
+        // started threads are joined.
+        const auto run = [threads](auto&& f) {
+            std::vector<std::exception_ptr> errors(threads);
+            const auto guarded = [&f, &errors](std::size_t t) {
+                try {
+                    f(t);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            try {
+                workers.reserve(threads - 1);
+                for (std::size_t t = 1; t < threads; ++t) {
+                    workers.emplace_back(guarded, t);
+                }
+                guarded(std::size_t{0});
+            } catch (...) {
+                errors[0] = std::current_exception();   // not all the threads started, chunk 0 is not processed
+            }
+
+            for (std::thread& w : workers) {
+                w.join();
+            }
+            for (const std::exception_ptr& e : errors) {
+                if (e) {
+                    std::rethrow_exception(e);
+                }
+            }
+        };
+
+        run([&](std::size_t t) {
+            detail::partition_histogram<KeyFields>(
+                first, chunk_begin(t), chunk_begin(t + 1), partitions, ids.data(), histograms.data() + t * partitions
+            );
+        });
+
+        // Prefix sum: partition `p` of thread `t` starts after all the partitions before `p` and after partition `p` of the previous threads.
+        std::vector<std::size_t> offsets(partitions + 1);
+        std::size_t position = 0;
+        for (std::size_t p = 0; p < partitions; ++p) {
+            offsets[p] = position;
+            for (std::size_t t = 0; t < threads; ++t) {
+                const std::size_t count = histograms[t * partitions + p];
+                histograms[t * partitions + p] = position;
+                position += count;
+            }
+        }
+        offsets[partitions] = position;
+
+        std::vector<partition_buffers> buffers;
+        if (detail::use_write_combining<It, OutIt>::value) {
+            buffers.reserve(threads);
+            for (std::size_t t = 0; t < threads; ++t) {
+                buffers.emplace_back(partitions);
+            }
+        }
+
+        run([&](std::size_t t) {
+            detail::partition_scatter(
+                first, chunk_begin(t), chunk_begin(t + 1), ids.data(), histograms.data() + t * partitions, partitions, out,
+                (buffers.empty() ? nullptr : &buffers[t]), detail::use_write_combining<It, OutIt>{}
+            );
+        });
+
+        return offsets;
+    }
+
+} // namespace detail
+
+/// \brief Copies the aggregates from `range` into `out`, grouping them into `partitions` partitions by hash of the fields `I...`
+/// (of all the fields if `I...` is empty).
+///
+/// Each key is hashed once. The first pass computes the partitions of the records and their histogram, the second pass copies
+/// the records to the positions given by the prefix sum of the histogram. If `out` is a pointer and the records are small and
+/// trivially copyable, the records are gathered in cache line sized buffers and written to `out` by whole lines.
+///
+/// Records with equal keys are in the same partition, records keep their relative order within a partition.
+/// Fields are hashed by `std::hash`.
+///
+/// \param range Random access range of aggregates.
+/// \param partitions Count of partitions, less than 2^32. Throws `std::invalid_argument` if it is 0.
+/// \param out Random access iterator to the range of at least `size(range)` assignable elements, for example `std::vector::data()`.
+///
+/// \return `std::vector<std::size_t>` of `partitions + 1` offsets, partition `p` is in [out + offsets[p], out + offsets[p + 1]).
+///
+/// \b Example:
+/// \code
+///     struct trade { int account; int instrument; double volume; };
+///     std::vector<trade> partitioned(trades.size());
+///     const auto offsets = boost::pfr::partition_by_hash<0>(trades, 64, partitioned.data());  // partition by account
+/// \endcode
+template <std::size_t... I, class Range, class OutIt>
+std::vector<std::size_t> partition_by_hash(const Range& range, std::size_t partitions, OutIt out) {
+    using std::begin;
+    using std::end;
+    typedef detail::key_fields<typename std::iterator_traits<decltype(begin(range))>::value_type, I...> key_fields_t;
+
+    return detail::partition_by_hash_impl<key_fields_t>(
+        begin(range), static_cast<std::size_t>(std::distance(begin(range), end(range))), partitions, out, 1
+    );
+}
+
+/// \overload partition_by_hash
+/// Partitions the `range` using `threads` threads. Each thread takes a contiguous chunk of the `range`, computes its own histogram
+/// and copies its records into its own subranges of the output partitions, so the threads do not use locks or atomics.
+/// The result is the same as with a single thread.
+///
+/// \b Example:
+/// \code
+///     const auto offsets = boost::pfr::partition_by_hash<0>(trades, 64, partitioned.data(), std::thread::hardware_concurrency());
+/// \endcode
+template <std::size_t... I, class Range, class OutIt>
+std::vector<std::size_t> partition_by_hash(const Range& range, std::size_t partitions, OutIt out, std::size_t threads) {
+    using std::begin;
+    using std::end;
+    typedef detail::key_fields<typename std::iterator_traits<decltype(begin(range))>::value_type, I...> key_fields_t;
+
+    return detail::partition_by_hash_impl<key_fields_t>(
+        begin(range), static_cast<std::size_t>(std::distance(begin(range), end(range))), partitions, out, (threads ? threads : 1)
+    );
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_PARTITION_BY_HASH_HPP
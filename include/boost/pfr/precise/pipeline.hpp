@@ -0,0 +1,478 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_PIPELINE_HPP
+#define BOOST_PFR_PRECISE_PIPELINE_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/prefetch.hpp>
+#include <boost/pfr/precise/io.hpp>
+
+/// \file boost/pfr/precise/pipeline.hpp
+/// Contains boost::pfr::pipeline that reads, transforms and writes records in parallel stages.
+///
+/// \b Requires: C++17 or \constexprinit{C++14 constexpr aggregate intializable type}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+/// Throughput counters of a stage of boost::pfr::pipeline.
+struct pipeline_stage_stats {
+    std::uint64_t               records = 0;
+    std::uint64_t               batches = 0;
+    std::chrono::nanoseconds    busy{0};        ///< time spent in the source, the transformation or the sink
+    std::chrono::nanoseconds    waiting{0};     ///< time spent waiting for the other stages
+
+    /// \return records processed per second of the busy time, 0 if nothing was processed.
+    double records_per_second() const noexcept {
+        return busy.count() ? static_cast<double>(records) * 1e9 / static_cast<double>(busy.count()) : 0.0;
+    }
+};
+
+/// Counters of all the stages of boost::pfr::pipeline. Counters of the transformation stage are summed over the workers.
+struct pipeline_stats {
+    pipeline_stage_stats read;
+    pipeline_stage_stats transform;
+    pipeline_stage_stats write;
+};
+
+struct pipeline_options {
+    /// Count of records in a batch.
+    std::size_t batch_size = 4096;
+
+    /// Count of the transformation threads, 0 for all the hardware threads except the two for reading and writing.
+    unsigned workers = 0;
+
+    /// Count of batches allocated for the whole run, 0 for twice the count of threads. Limits the records in flight.
+    std::size_t batches = 0;
+};
+
+namespace detail {
+
+    ///////////////////// Bounded lock free queue of multiple producers and consumers
+    //
+    // Each cell has a sequence number that tells whether the cell is ready for the producer or for the consumer on the
+    // current lap over the ring, so the producers and the consumers contend only on their own position counters.
+    template <class T>
+    class bounded_queue {
+        static_assert(std::is_trivially_copyable<T>::value, "====================> Boost.PFR: Internal error in the queue");
+
+        struct cell {
+            std::atomic<std::size_t>    sequence;
+            T                           value;
+        };
+
+    public:
+        /// Capacity is rounded up to a power of two.
+        explicit bounded_queue(std::size_t capacity) {
+            std::size_t size = 2;
+            while (size < capacity) {
+                size *= 2;
+            }
+            mask_ = size - 1;
+            cells_.reset(new cell[size]);
+            for (std::size_t i = 0; i < size; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bounded_queue(const bounded_queue&) = delete;
+        bounded_queue& operator=(const bounded_queue&) = delete;
+
+        /// \return false if the queue is full.
+        bool try_push(T value) noexcept {
+            std::size_t pos = push_pos_.load(std::memory_order_relaxed);
+            for (;;) {
+                cell& c = cells_[pos & mask_];
+                const std::size_t seq = c.sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (push_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        c.value = value;
+                        c.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = push_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /// \return false if the queue is empty.
+        bool try_pop(T& value) noexcept {
+            std::size_t pos = pop_pos_.load(std::memory_order_relaxed);
+            for (;;) {
+                cell& c = cells_[pos & mask_];
+                const std::size_t seq = c.sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (diff == 0) {
+                    if (pop_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        value = c.value;
+                        c.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = pop_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        std::unique_ptr<cell[]>     cells_;
+        std::size_t                 mask_;
+        char                        padding0_[detail::cache_line_size];    // positions are modified by different threads
+        std::atomic<std::size_t>    push_pos_{0};
+        char                        padding1_[detail::cache_line_size];
+        std::atomic<std::size_t>    pop_pos_{0};
+        char                        padding2_[detail::cache_line_size];
+    };
+
+    ///////////////////// Stages
+    template <class In, class Out>
+    struct pipeline_batch {
+        std::vector<In>     in;
+        std::vector<Out>    out;
+        std::size_t         size = 0;
+        std::uint64_t       sequence = 0;
+    };
+
+    /// First error of any stage, stops all the stages.
+    class pipeline_control {
+    public:
+        void fail(std::exception_ptr e) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::move(e);
+            }
+            failed_.store(true, std::memory_order_release);
+        }
+
+        bool failed() const noexcept {
+            return failed_.load(std::memory_order_acquire);
+        }
+
+        void rethrow() {
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+        }
+
+    private:
+        std::atomic<bool>   failed_{false};
+        std::mutex          mutex_;
+        std::exception_ptr  error_;
+    };
+
+    typedef std::chrono::steady_clock pipeline_clock;
+
+    /// Retries `op` until it succeeds or `stop` returns true, yielding at first and then sleeping. Lock free queues do not
+    /// block, so the waiting is done here.
+    template <class Op, class Stop>
+    bool pipeline_wait(Op op, Stop stop, pipeline_stage_stats& stats) {
+        if (op()) {
+            return true;
+        }
+
+        const auto start = pipeline_clock::now();
+        bool done = false;
+        for (unsigned attempt = 0; !(done = op()) && !stop(); ++attempt) {
+            if (attempt < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        stats.waiting += std::chrono::duration_cast<std::chrono::nanoseconds>(pipeline_clock::now() - start);
+        return done;
+    }
+
+    ///////////////////// Sources and sinks
+    template <class S, class T, class = void>
+    struct has_pop : std::false_type {};
+
+    template <class S, class T>
+    struct has_pop<S, T, decltype(void(std::declval<S&>().pop(std::declval<T&>())))> : std::true_type {};
+
+    template <class S, class T, class = void>
+    struct has_push : std::false_type {};
+
+    template <class S, class T>
+    struct has_push<S, T, decltype(void(std::declval<S&>().push(std::declval<const T&>())))> : std::true_type {};
+
+    template <int Priority> struct priority : priority<Priority - 1> {};
+    template <> struct priority<0> {};
+
+    /// Record readers: `bool pop(T&)`, for example boost::pfr::uring_record_reader.
+    template <class Source, class T>
+    auto pipeline_pull(Source& source, T& value, priority<2>) -> std::enable_if_t<has_pop<Source, T>::value, bool> {
+        return source.pop(value);
+    }
+
+    /// Text streams: records in the format of boost::pfr::read separated by whitespaces.
+    template <class Source, class T>
+    auto pipeline_pull(Source& in, T& value, priority<1>)
+        -> std::enable_if_t<std::is_base_of<std::basic_istream<typename Source::char_type, typename Source::traits_type>, Source>::value, bool>
+    {
+        in >> std::ws;  // boost::pfr::read does not skip whitespaces
+        if (in.eof() && !in.bad()) {
+            return false;
+        }
+        ::boost::pfr::read(in, value);
+        if (in.fail()) {
+            // Stopping silently would look like a successful run with truncated output
+            throw std::runtime_error("boost::pfr::pipeline: malformed record or read error in the input stream");
+        }
+        return true;
+    }
+
+    /// Function objects: `bool source(T&)`.
+    template <class Source, class T>
+    bool pipeline_pull(Source& source, T& value, priority<0>) {
+        return source(value);
+    }
+
+    /// Record writers: `push(const T&)`, for example boost::pfr::uring_record_writer.
+    template <class Sink, class T>
+    auto pipeline_put(Sink& sink, const T& value, priority<2>) -> std::enable_if_t<has_push<Sink, T>::value> {
+        sink.push(value);
+    }
+
+    /// Text streams: records in the format of boost::pfr::write, one per line.
+    template <class Sink, class T>
+    auto pipeline_put(Sink& out, const T& value, priority<1>)
+        -> std::enable_if_t<std::is_base_of<std::basic_ostream<typename Sink::char_type, typename Sink::traits_type>, Sink>::value>
+    {
+        ::boost::pfr::write(out, value);
+        out << '\n';
+    }
+
+    /// Function objects: `sink(const T&)`.
+    template <class Sink, class T>
+    void pipeline_put(Sink& sink, const T& value, priority<0>) {
+        sink(value);
+    }
+
+    inline void pipeline_add_time(pipeline_stage_stats& stats, pipeline_clock::time_point start) noexcept {
+        stats.busy += std::chrono::duration_cast<std::chrono::nanoseconds>(pipeline_clock::now() - start);
+    }
+
+} // namespace detail
+
+/// \brief Reads records of type `In` from `source`, transforms them into records of type `Out` with `transform` on several
+/// threads and writes them to `sink` in the order of reading.
+///
+/// The source is read on a dedicated thread, `options.workers` threads transform the records, the sink is written on the
+/// calling thread, so I/O bound and CPU bound stages overlap. Records travel between the stages in batches through bounded
+/// lock free queues. All the batches are allocated at start and recycled, so nothing is allocated while the records
+/// flow and at most `options.batches` batches are in flight.
+///
+/// \param source One of:
+/// - record reader with `bool pop(In&)`, for example boost::pfr::uring_record_reader<In>;
+/// - `std::basic_istream` with records in the format of boost::pfr::read separated by whitespaces, a malformed record
+///   is reported with std::runtime_error;
+/// - function object `bool source(In&)` that returns false at the end of the records.
+/// \param transform Function object `Out transform(const In&)`, called concurrently from the worker threads.
+/// \param sink One of:
+/// - record writer with `push(const Out&)`, for example boost::pfr::uring_record_writer<Out>;
+/// - `std::basic_ostream`, records are written with boost::pfr::write one per line;
+/// - function object `sink(const Out&)`.
+///
+/// \return throughput counters of the stages.
+/// \throws the first exception thrown by the source, the transformation or the sink. Other stages are stopped.
+///
+/// \b Example:
+/// \code
+///     struct raw_tick { std::uint32_t instrument; std::int64_t price_e8; std::int32_t qty; };
+///     struct tick { std::uint32_t instrument; double price; double notional; };
+///
+///     boost::pfr::uring_record_reader<raw_tick> in("raw.bin");
+///     boost::pfr::uring_record_writer<tick> out("ticks.bin");
+///     const auto stats = boost::pfr::pipeline<raw_tick, tick>(in, [](const raw_tick& r) {
+///         const double price = r.price_e8 * 1e-8;
+///         return tick{r.instrument, price, price * r.qty};
+///     }, out);
+///     out.close();
+///     std::cout << stats.transform.records_per_second() << " records/s per worker\n";
+/// \endcode
+template <class In, class Out = In, class Source, class Transform, class Sink>
+pipeline_stats pipeline(Source&& source, const Transform& transform, Sink&& sink, const pipeline_options& options = {}) {
+    typedef detail::pipeline_batch<In, Out> batch_t;
+    typedef detail::priority<2> dispatch_t;
+
+    const std::size_t batch_size = (options.batch_size ? options.batch_size : 1);
+    const unsigned hardware = std::thread::hardware_concurrency();
+    const unsigned workers = (options.workers ? options.workers : (hardware > 3 ? hardware - 2 : 1));
+    const std::size_t batches_count = (options.batches ? options.batches : 2 * (std::size_t{workers} + 2));
+
+    std::vector<batch_t> batches(batches_count);
+    for (batch_t& b : batches) {
+        b.in.resize(batch_size);
+        b.out.resize(batch_size);
+    }
+
+    detail::bounded_queue<batch_t*> free_batches(batches_count);
+    detail::bounded_queue<batch_t*> read_batches(batches_count + workers);     // and a null batch per worker at the end
+    detail::bounded_queue<batch_t*> transformed_batches(batches_count);
+    for (batch_t& b : batches) {
+        free_batches.try_push(&b);
+    }
+
+    pipeline_stats stats;
+    std::vector<pipeline_stage_stats> worker_stats(workers);
+    detail::pipeline_control control;
+    std::atomic<std::uint64_t> total_batches{(std::numeric_limits<std::uint64_t>::max)()};
+    const auto failed = [&control]() { return control.failed(); };
+
+    ///////////////////// Reading
+    const auto read_stage = [&]() {
+        std::uint64_t sequence = 0;
+        try {
+            for (bool more = true; more;) {
+                batch_t* b = nullptr;
+                if (!detail::pipeline_wait([&]() { return free_batches.try_pop(b); }, failed, stats.read)) {
+                    break;
+                }
+
+                const auto start = detail::pipeline_clock::now();
+                std::size_t n = 0;
+                while (n < batch_size && (more = detail::pipeline_pull(source, b->in[n], dispatch_t{}))) {
+                    ++n;
+                }
+                detail::pipeline_add_time(stats.read, start);
+                if (!n) {
+                    break;
+                }
+
+                b->size = n;
+                b->sequence = sequence++;
+                stats.read.records += n;
+                ++stats.read.batches;
+                if (!detail::pipeline_wait([&]() { return read_batches.try_push(b); }, failed, stats.read)) {
+                    break;
+                }
+            }
+        } catch (...) {
+            control.fail(std::current_exception());
+        }
+
+        total_batches.store(sequence, std::memory_order_release);
+        for (unsigned w = 0; w < workers; ++w) {
+            detail::pipeline_wait([&]() { return read_batches.try_push(nullptr); }, failed, stats.read);
+        }
+    };
+
+    ///////////////////// Transforming
+    const auto transform_stage = [&](unsigned w) {
+        pipeline_stage_stats& s = worker_stats[w];
+        try {
+            for (;;) {
+                batch_t* b = nullptr;
+                if (!detail::pipeline_wait([&]() { return read_batches.try_pop(b); }, failed, s) || !b) {
+                    return;
+                }
+
+                const auto start = detail::pipeline_clock::now();
+                for (std::size_t i = 0; i < b->size; ++i) {
+                    b->out[i] = transform(b->in[i]);
+                }
+                detail::pipeline_add_time(s, start);
+                s.records += b->size;
+                ++s.batches;
+
+                if (!detail::pipeline_wait([&]() { return transformed_batches.try_push(b); }, failed, s)) {
+                    return;
+                }
+            }
+        } catch (...) {
+            control.fail(std::current_exception());
+        }
+    };
+
+    // Failure to start a thread stops the started ones like an error of a stage, they are joined below
+    std::thread reader;
+    std::vector<std::thread> transformers;
+    try {
+        transformers.reserve(workers);
+        reader = std::thread(read_stage);
+        for (unsigned w = 0; w < workers; ++w) {
+            transformers.emplace_back(transform_stage, w);
+        }
+    } catch (...) {
+        control.fail(std::current_exception());
+    }
+
+    ///////////////////// Writing in the order of reading
+    try {
+        std::vector<batch_t*> reordered(batches_count);     // batch with sequence `s` waits at `s % batches_count`
+        std::uint64_t next = 0;
+        const auto done = [&]() { return control.failed() || next == total_batches.load(std::memory_order_acquire); };
+        while (!done()) {
+            batch_t* b = nullptr;
+            if (!detail::pipeline_wait([&]() { return transformed_batches.try_pop(b); }, done, stats.write)) {
+                break;
+            }
+            reordered[b->sequence % batches_count] = b;
+
+            while ((b = reordered[next % batches_count]) != nullptr && b->sequence == next) {
+                reordered[next % batches_count] = nullptr;
+
+                const auto start = detail::pipeline_clock::now();
+                for (std::size_t i = 0; i < b->size; ++i) {
+                    detail::pipeline_put(sink, b->out[i], dispatch_t{});
+                }
+                detail::pipeline_add_time(stats.write, start);
+                stats.write.records += b->size;
+                ++stats.write.batches;
+                ++next;
+
+                free_batches.try_push(b);   // never full: holds at most all the batches
+            }
+        }
+    } catch (...) {
+        control.fail(std::current_exception());
+    }
+
+    if (reader.joinable()) {
+        reader.join();
+    }
+    for (std::thread& t : transformers) {
+        t.join();
+    }
+    control.rethrow();
+
+    for (const pipeline_stage_stats& s : worker_stats) {
+        stats.transform.records += s.records;
+        stats.transform.batches += s.batches;
+        stats.transform.busy += s.busy;
+        stats.transform.waiting += s.waiting;
+    }
+    return stats;
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_PIPELINE_HPP
@@ -0,0 +1,271 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_ROLLING_HPP
+#define BOOST_PFR_PRECISE_ROLLING_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <deque>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <boost/pfr/precise/core.hpp>
+
+/// \file boost/pfr/precise/rolling.hpp
+/// Contains boost::pfr::rolling, rolling window aggregations over the fields of aggregates, and the windows and operations for it.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+///////////////////// Windows
+
+/// Window of the last `ticks` values.
+struct tick_window {
+    std::size_t ticks;
+
+    template <class T>
+    bool expired(const T& /*oldest*/, const T& /*newest*/, std::size_t count) const noexcept {
+        return count > ticks;
+    }
+};
+
+/// Window of the values with the field `I` (timestamp) greater than the timestamp of the newest value minus `length`.
+/// Timestamps must not decrease. `Duration` is the type of `length`, for example `std::int64_t` for integral timestamps or
+/// `std::chrono::nanoseconds` for `std::chrono::time_point` timestamps.
+template <std::size_t I, class Duration>
+struct time_window {
+    Duration length;
+
+    template <class T>
+    bool expired(const T& oldest, const T& newest, std::size_t /*count*/) const {
+        return !(::boost::pfr::get<I>(newest) < ::boost::pfr::get<I>(oldest) + length);
+    }
+};
+
+///////////////////// Operations
+
+/// Sum of the field `I` over the window, updated in O(1) on each value.
+template <std::size_t I>
+struct rolling_sum {
+    static constexpr std::size_t index = I;
+
+    template <class F>
+    struct state {
+        F sum{};
+
+        void push(std::size_t /*seq*/, const F& v) { sum += v; }
+        void pop(std::size_t /*seq*/, const F& v) { sum -= v; }
+        F result(std::size_t /*count*/) const { return sum; }
+    };
+};
+
+/// Arithmetic mean of the field `I` over the window, computed in the type of the field.
+template <std::size_t I>
+struct rolling_mean {
+    static constexpr std::size_t index = I;
+
+    template <class F>
+    struct state : rolling_sum<I>::template state<F> {
+        F result(std::size_t count) const { return static_cast<F>(this->sum / static_cast<F>(count)); }
+    };
+};
+
+namespace detail {
+    /// Monotonic deque: keeps only the values that could become the extremum after older values leave the window.
+    /// Each value is inserted and removed once, so the updates are amortized O(1).
+    template <class F, class Better>
+    struct monotonic_state {
+        std::deque<std::pair<std::size_t, F>> candidates;
+
+        void push(std::size_t seq, const F& v) {
+            while (!candidates.empty() && !Better{}(candidates.back().second, v)) {
+                candidates.pop_back();
+            }
+            candidates.emplace_back(seq, v);
+        }
+
+        void pop(std::size_t seq, const F& /*v*/) {
+            if (candidates.front().first == seq) {
+                candidates.pop_front();
+            }
+        }
+
+        F result(std::size_t /*count*/) const { return candidates.front().second; }
+    };
+
+    struct less_op {
+        template <class F>
+        bool operator()(const F& lhs, const F& rhs) const { return lhs < rhs; }
+    };
+
+    struct greater_op {
+        template <class F>
+        bool operator()(const F& lhs, const F& rhs) const { return rhs < lhs; }
+    };
+} // namespace detail
+
+/// Minimum of the field `I` over the window, amortized O(1) updates.
+template <std::size_t I>
+struct rolling_min {
+    static constexpr std::size_t index = I;
+
+    template <class F>
+    struct state : detail::monotonic_state<F, detail::less_op> {};
+};
+
+/// Maximum of the field `I` over the window, amortized O(1) updates.
+template <std::size_t I>
+struct rolling_max {
+    static constexpr std::size_t index = I;
+
+    template <class F>
+    struct state : detail::monotonic_state<F, detail::greater_op> {};
+};
+
+namespace detail {
+    /// Returns position of the operation for the field `field` in `op_fields`, or `sizeof...(OpFields)` if there is no such operation.
+    template <std::size_t... OpFields>
+    constexpr std::size_t find_rolling_op(std::size_t field) noexcept {
+        const std::size_t op_fields[] = {OpFields..., field};
+        std::size_t i = 0;
+        while (op_fields[i] != field) {
+            ++i;
+        }
+        return i;
+    }
+
+    template <std::size_t... OpFields>
+    constexpr bool unique_rolling_ops() noexcept {
+        const std::size_t op_fields[] = {OpFields..., 0};
+        for (std::size_t i = 0; i < sizeof...(OpFields); ++i) {
+            for (std::size_t j = i + 1; j < sizeof...(OpFields); ++j) {
+                if (op_fields[i] == op_fields[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+} // namespace detail
+
+/// \brief Rolling window aggregations over the fields of `T`.
+///
+/// Keeps the values of the `Window` and the state of each of the `Ops...`. Each operation aggregates a single field of `T`,
+/// there must be at most one operation per field.
+///
+/// \tparam Window boost::pfr::tick_window, boost::pfr::time_window or a class with member function
+/// `bool expired(const T& oldest, const T& newest, std::size_t count) const`.
+/// \tparam Ops boost::pfr::rolling_sum, boost::pfr::rolling_mean, boost::pfr::rolling_min or boost::pfr::rolling_max with field indexes.
+///
+/// \b Example:
+/// \code
+///     struct tick { std::int64_t timestamp; double price; int volume; };
+///
+///     boost::pfr::rolling<tick, boost::pfr::time_window<0, std::int64_t>, boost::pfr::rolling_max<1>, boost::pfr::rolling_sum<2>>
+///         last_second{{1000000000}};
+///
+///     for (const tick& t : ticks) {
+///         last_second.push(t);
+///         const tick s = last_second.snapshot();   // s.price is the max price, s.volume is the total volume in the last second
+///     }
+/// \endcode
+template <class T, class Window, class... Ops>
+class rolling {
+    static_assert(
+        detail::unique_rolling_ops<Ops::index...>(),
+        "====================> Boost.PFR: There must be at most one rolling operation per field"
+    );
+
+    typedef std::tuple<typename Ops::template state< std::remove_cv_t<::boost::pfr::tuple_element_t<Ops::index, T>> >...> states_t;
+
+public:
+    typedef T       value_type;
+    typedef Window  window_type;
+
+    /// Constructs an empty rolling window.
+    explicit rolling(Window window = Window{})
+        : window_(std::move(window))
+    {}
+
+    /// Adds `value` to the window and removes the values that are not in the window any more.
+    void push(const T& value) {
+        values_.push_back(value);
+        for_each_state(value, pushed_, push_fn{});
+        ++pushed_;
+
+        while (!values_.empty() && window_.expired(values_.front(), value, values_.size())) {
+            for_each_state(values_.front(), pushed_ - values_.size(), pop_fn{});
+            values_.pop_front();
+        }
+    }
+
+    /// \return `T` with the fields that have operations set to the results of the operations over the window and other fields
+    /// equal to the fields of the newest value.
+    /// \pre `!empty()`
+    T snapshot() const {
+        T result = values_.back();
+        ::boost::pfr::for_each_field(result, [this](auto& field, auto index) {
+            constexpr std::size_t op = detail::find_rolling_op<Ops::index...>(decltype(index)::value);
+            this->template assign_result<op>(field, std::integral_constant<bool, (op < sizeof...(Ops))>{});
+        });
+        return result;
+    }
+
+    /// \return count of the values in the window.
+    std::size_t size() const noexcept { return values_.size(); }
+
+    /// \return true if the window has no values.
+    bool empty() const noexcept { return values_.empty(); }
+
+    /// Removes all the values.
+    void clear() {
+        values_.clear();
+        states_ = states_t{};
+    }
+
+private:
+    struct push_fn {
+        template <class State, class F>
+        void operator()(State& s, std::size_t seq, const F& v) const { s.push(seq, v); }
+    };
+
+    struct pop_fn {
+        template <class State, class F>
+        void operator()(State& s, std::size_t seq, const F& v) const { s.pop(seq, v); }
+    };
+
+    template <class Fn>
+    void for_each_state(const T& value, std::size_t seq, Fn fn) {
+        for_each_state_impl(value, seq, fn, std::index_sequence_for<Ops...>{});
+    }
+
+    template <class Fn, std::size_t... I>
+    void for_each_state_impl(const T& value, std::size_t seq, Fn fn, std::index_sequence<I...>) {
+        const int ignore[] = {0, (fn(std::get<I>(states_), seq, ::boost::pfr::get<Ops::index>(value)), 0)...};
+        (void)ignore;
+    }
+
+    template <std::size_t Op, class F>
+    void assign_result(F& field, std::true_type /*has operation*/) const {
+        field = std::get<Op>(states_).result(values_.size());
+    }
+
+    template <std::size_t Op, class F>
+    void assign_result(F& /*field*/, std::false_type /*has operation*/) const noexcept {}
+
+    Window          window_;
+    std::deque<T>   values_;
+    std::size_t     pushed_ = 0;
+    states_t        states_;
+};
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_ROLLING_HPP
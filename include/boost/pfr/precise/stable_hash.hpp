@@ -0,0 +1,165 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_STABLE_HASH_HPP
+#define BOOST_PFR_PRECISE_STABLE_HASH_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include <boost/pfr/detail/xxhash64.hpp>
+#include <boost/pfr/precise/core.hpp>
+
+/// \file boost/pfr/precise/stable_hash.hpp
+/// Contains boost::pfr::stable_hash, hash function that gives the same results for the same values on all the platforms,
+/// compilers and standard libraries.
+///
+/// \b Requires: C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    template <class T, class = void>
+    struct is_byte_string : std::false_type {};
+
+    // std::basic_string and std::basic_string_view of 1 byte characters
+    template <class T>
+    struct is_byte_string<T, decltype(void(std::declval<typename T::traits_type>()), void(std::declval<const T&>().data()), void(std::declval<const T&>().size()))>
+        : std::integral_constant<bool, sizeof(typename T::value_type) == 1 && std::is_integral<typename T::value_type>::value>
+    {};
+
+    template <class T, class = void>
+    struct is_stable_hash_range : std::false_type {};
+
+    template <class T>
+    struct is_stable_hash_range<T, decltype(void(std::begin(std::declval<const T&>())), void(std::end(std::declval<const T&>())))> : std::true_type {};
+
+    enum class stable_hash_category { integer, floating_point, byte_string, range, aggregate };
+
+    template <class T>
+    constexpr stable_hash_category stable_hash_category_of() noexcept {
+        return std::is_integral<T>::value || std::is_enum<T>::value ? stable_hash_category::integer
+            : std::is_floating_point<T>::value ? stable_hash_category::floating_point
+            : detail::is_byte_string<T>::value ? stable_hash_category::byte_string
+            : detail::is_stable_hash_range<T>::value ? stable_hash_category::range
+            : stable_hash_category::aggregate;
+    }
+
+    template <stable_hash_category C>
+    using stable_hash_tag = std::integral_constant<stable_hash_category, C>;
+
+    ///////////////////// Canonical encoding of the values into 64 bit words
+    struct stable_hash_encoder {
+        template <class T>
+        static void append(xxhash64& state, const T& value) {
+            static_assert(
+                !std::is_pointer<T>::value && !std::is_member_pointer<T>::value,
+                "====================> Boost.PFR: stable_hash can not hash pointers, their values differ between runs"
+            );
+            stable_hash_encoder::append(state, value, stable_hash_tag<detail::stable_hash_category_of<T>()>{});
+        }
+
+        template <class T>
+        static void append(xxhash64& state, const T& value, stable_hash_tag<stable_hash_category::integer>) {
+            typedef std::conditional_t<std::is_enum<T>::value, std::underlying_type<T>, std::enable_if<true, T>> underlying_t;
+            typedef typename underlying_t::type integer_t;
+
+            // Signedness of `char` and `wchar_t` differs between the platforms, they are converted to their unsigned
+            // counterparts before widening, so the negative values of the signed ones are not sign extended
+            constexpr bool platform_signedness = std::is_same<integer_t, char>::value || std::is_same<integer_t, wchar_t>::value;
+            constexpr bool sign_extend = std::is_signed<integer_t>::value && !platform_signedness;
+            typedef std::conditional_t<platform_signedness, std::make_unsigned<integer_t>, std::enable_if<true, integer_t>> widened_t;
+            state.update(sign_extend
+                ? static_cast<std::uint64_t>(static_cast<std::int64_t>(static_cast<integer_t>(value)))
+                : static_cast<std::uint64_t>(static_cast<typename widened_t::type>(static_cast<integer_t>(value)))
+            );
+        }
+
+        template <class T>
+        static void append(xxhash64& state, const T& value, stable_hash_tag<stable_hash_category::floating_point>) {
+            static_assert(
+                sizeof(T) <= sizeof(double) && std::numeric_limits<double>::is_iec559,
+                "====================> Boost.PFR: stable_hash supports only float and double IEEE 754 floating point types"
+            );
+            const double d = value;
+            std::uint64_t bits;
+            if (d != d) {
+                bits = 0x7FF8000000000000ull;   // all the NaNs are equal
+            } else if (d == 0.0) {
+                bits = 0;                       // -0.0 == 0.0
+            } else {
+                std::memcpy(&bits, &d, sizeof(bits));
+            }
+            state.update(bits);
+        }
+
+        template <class T>
+        static void append(xxhash64& state, const T& value, stable_hash_tag<stable_hash_category::byte_string>) {
+            state.update(static_cast<std::uint64_t>(value.size()));
+            state.update_bytes(reinterpret_cast<const unsigned char*>(value.data()), value.size());
+        }
+
+        template <class T>
+        static void append(xxhash64& state, const T& value, stable_hash_tag<stable_hash_category::range>) {
+            using std::begin;
+            using std::end;
+            state.update(static_cast<std::uint64_t>(std::distance(begin(value), end(value))));
+            for (const auto& v : value) {
+                stable_hash_encoder::append(state, v);
+            }
+        }
+
+        template <class T>
+        static void append(xxhash64& state, const T& value, stable_hash_tag<stable_hash_category::aggregate>) {
+            ::boost::pfr::for_each_field(value, [&state](const auto& field) {
+                stable_hash_encoder::append(state, field);
+            });
+        }
+    };
+
+} // namespace detail
+
+/// \brief Hashes `value` with XXH64 of its canonical encoding. Results are the same on all the platforms and do not depend
+/// on the compiler, the standard library, the endianness or the size of the types, so they could be persisted in files
+/// or used to route values to shards.
+///
+/// The canonical encoding is a sequence of 64 bit little endian words:
+/// - `bool`, integers, characters and enums are converted to 64 bits with sign extension for the signed types, `char` and
+///   `wchar_t` are treated as unsigned;
+/// - `float` and `double` are converted to `double`, `-0.0` is encoded as `0.0` and all the NaNs as `0x7FF8000000000000`;
+/// - `std::basic_string` and `std::basic_string_view` of 1 byte characters are encoded as their size in bytes followed by
+///   the bytes, the last word is padded with zeros;
+/// - other ranges, including C arrays and `std::array`, are encoded as their size followed by the elements;
+/// - aggregates are encoded as their fields.
+///
+/// Changing the type of a field to an integer of another size does not change the hashes, changing the order of the
+/// fields does. Pointers and `long double` are not supported.
+///
+/// \b Example:
+/// \code
+///     struct order_key { std::string symbol; std::int32_t account; };
+///     std::size_t shard = boost::pfr::stable_hash(order_key{"MSFT", 42}) % shards_count;
+///     assert(boost::pfr::stable_hash(order_key{"MSFT", 42}) == 0xe2ba25e40afb074cull); // on any platform
+/// \endcode
+template <class T>
+std::uint64_t stable_hash(const T& value, std::uint64_t seed = 0) {
+    detail::xxhash64 state(seed);
+    detail::stable_hash_encoder::append(state, value);
+    return state.finish();
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_STABLE_HASH_HPP
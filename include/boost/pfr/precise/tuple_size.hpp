@@ -14,7 +14,7 @@
 #include <utility>      // metaprogramming stuff
 
 #include <boost/pfr/detail/sequence_tuple.hpp>
-#include <boost/pfr/detail/fields_count.hpp>
+#include <boost/pfr/detail/reflection_info.hpp>
 
 namespace boost { namespace pfr {
 
@@ -29,7 +29,7 @@ namespace boost { namespace pfr {
 ///     std::array<int, boost::pfr::tuple_size<my_structure>::value > a;
 /// \endcode
 template <class T>
-using tuple_size = detail::size_t_< boost::pfr::detail::fields_count<T>() >;
+using tuple_size = detail::size_t_< boost::pfr::detail::reflection_info<T>.fields_count >;
 
 
 /// \brief `tuple_size_v` is a template variable that contains fields count in a T and
@@ -0,0 +1,335 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_URING_RECORD_HPP
+#define BOOST_PFR_PRECISE_URING_RECORD_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/pfr/detail/uring.hpp>
+#include <boost/pfr/precise/core.hpp>
+#include <boost/pfr/precise/tuple_size.hpp>
+
+/// \file boost/pfr/precise/uring_record.hpp
+/// Contains boost::pfr::uring_record_writer and boost::pfr::uring_record_reader for files of packed binary records.
+///
+/// \b Requires: POSIX, C++17 or \flatpod{C++14 flat POD or C++14 with not disabled Loophole}. I/O is done with io_uring on
+/// Linux kernels that support it, with `pread`/`pwrite` otherwise.
+///
+/// \rcast14
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    ///////////////////// Packed binary records
+    //
+    // Fields are stored one after another in their in-memory representation without the padding between them.
+    template <class T, std::size_t... I>
+    constexpr std::size_t packed_record_size(std::index_sequence<I...>) noexcept {
+        const std::size_t sizes[] = {0, sizeof(::boost::pfr::tuple_element_t<I, T>)...};
+        std::size_t result = 0;
+        for (std::size_t s : sizes) {
+            result += s;
+        }
+        return result;
+    }
+
+    template <class T, std::size_t... I>
+    constexpr bool fields_trivially_copyable(std::index_sequence<I...>) noexcept {
+        const bool flags[] = {true, std::is_trivially_copyable<::boost::pfr::tuple_element_t<I, T>>::value...};
+        for (bool f : flags) {
+            if (!f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class T>
+    struct packed_record {
+        typedef std::make_index_sequence<::boost::pfr::tuple_size_v<T>> indexes_t;
+
+        static_assert(
+            detail::fields_trivially_copyable<T>(indexes_t{}),
+            "====================> Boost.PFR: Record files require aggregates with trivially copyable fields"
+        );
+
+        static constexpr std::size_t size = detail::packed_record_size<T>(indexes_t{});
+
+        template <std::size_t... I>
+        static void encode(const T& value, unsigned char* out, std::index_sequence<I...>) noexcept {
+            const int ignore[] = {0, (
+                std::memcpy(out, &::boost::pfr::get<I>(value), sizeof(::boost::pfr::tuple_element_t<I, T>)),
+                out += sizeof(::boost::pfr::tuple_element_t<I, T>),
+                0
+            )...};
+            (void)ignore;
+        }
+
+        template <std::size_t... I>
+        static void decode(const unsigned char* in, T& value, std::index_sequence<I...>) noexcept {
+            const int ignore[] = {0, (
+                std::memcpy(&::boost::pfr::get<I>(value), in, sizeof(::boost::pfr::tuple_element_t<I, T>)),
+                in += sizeof(::boost::pfr::tuple_element_t<I, T>),
+                0
+            )...};
+            (void)ignore;
+        }
+
+        static void encode(const T& value, unsigned char* out) noexcept {
+            encode(value, out, indexes_t{});
+        }
+
+        static void decode(const unsigned char* in, T& value) noexcept {
+            decode(in, value, indexes_t{});
+        }
+    };
+
+    template <class T>
+    constexpr std::size_t packed_record<T>::size;
+
+    /// Count of the buffers and count of the whole records in a buffer.
+    struct record_buffers {
+        std::vector<aligned_buffer> buffers;
+        std::size_t                 records_per_buffer;
+        std::size_t                 bytes_per_buffer;
+
+        record_buffers(std::size_t record_size, std::size_t buffer_size, unsigned depth)
+            : records_per_buffer(buffer_size / record_size ? buffer_size / record_size : 1)
+            , bytes_per_buffer(records_per_buffer * record_size)
+        {
+            if (depth == 0) {
+                throw std::invalid_argument("boost::pfr: depth of the record file must not be zero");
+            }
+            buffers.reserve(depth);
+            for (unsigned i = 0; i < depth; ++i) {
+                buffers.push_back(detail::make_aligned_buffer(bytes_per_buffer));
+            }
+        }
+
+        /// Waits for the requests of `io` to the buffers. The buffers are leaked if the kernel may still access them.
+        void release(uring_io& io) noexcept {
+            if (!io.quiesce()) {
+                for (aligned_buffer& b : buffers) {
+                    (void)b.release();
+                }
+            }
+        }
+    };
+
+} // namespace detail
+
+/// \brief Writes aggregates to a file of packed binary records, keeping several buffers of records in flight.
+///
+/// Records are encoded into one buffer while the previously filled buffers are being written by the kernel. Each record
+/// takes the sum of the sizes of its fields, fields are stored in their in-memory representation without padding. Files
+/// are not portable between platforms with different endianness or field sizes.
+///
+/// \b Requires: all the fields of `T` are trivially copyable.
+///
+/// \b Example:
+/// \code
+///     struct tick { std::uint32_t instrument; double price; std::int32_t qty; };
+///
+///     boost::pfr::uring_record_writer<tick> out("ticks.bin");
+///     for (const tick& t : ticks) {
+///         out.push(t);
+///     }
+///     out.close();    // waits for the data to be written, reports errors
+/// \endcode
+template <class T>
+class uring_record_writer {
+    typedef detail::packed_record<T> record_t;
+
+public:
+    /// Creates or truncates the file at `path`.
+    /// \param buffer_size Approximate size of each buffer in bytes, rounded down to whole records.
+    /// \param depth Count of buffers, `depth - 1` of them may be in flight while the next one is being filled.
+    /// \throws std::system_error if the file could not be opened.
+    explicit uring_record_writer(const char* path, std::size_t buffer_size = 1 << 20, unsigned depth = 4)
+        : file_(path, O_WRONLY | O_CREAT | O_TRUNC)
+        , buffers_(record_t::size, buffer_size, depth)
+        , io_(file_.get(), depth)
+    {}
+
+    uring_record_writer(const uring_record_writer&) = delete;
+    uring_record_writer& operator=(const uring_record_writer&) = delete;
+
+    /// Writes the remaining records, errors are ignored. Call close() to get them reported.
+    ~uring_record_writer() {
+        try {
+            close();
+        } catch (...) {}
+        buffers_.release(io_);
+    }
+
+    /// Appends `value` to the file. Blocks only if all the buffers are in flight.
+    /// \throws std::system_error if the previous writes of the buffer failed.
+    void push(const T& value) {
+        if (count_ == buffers_.records_per_buffer) {
+            submit_current();
+        }
+        record_t::encode(value, buffers_.buffers[current_].get() + count_ * record_t::size);
+        ++count_;
+        ++records_;
+    }
+
+    /// Writes all the pushed records and waits for the writes to finish. Does nothing if called again.
+    /// \throws std::system_error if any of the writes failed.
+    void close() {
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        if (count_) {
+            submit_current();
+        }
+        for (unsigned slot = 0; slot < buffers_.buffers.size(); ++slot) {
+            io_.wait(slot);
+        }
+    }
+
+    /// \return count of the records pushed so far.
+    std::uint64_t size() const noexcept {
+        return records_;
+    }
+
+    /// \return true if the writes are done asynchronously with io_uring.
+    bool is_async() const noexcept {
+        return io_.is_async();
+    }
+
+private:
+    void submit_current() {
+        const std::size_t bytes = count_ * record_t::size;
+        io_.submit(current_, true, buffers_.buffers[current_].get(), bytes, offset_);
+        offset_ += bytes;
+        count_ = 0;
+
+        current_ = (current_ + 1) % static_cast<unsigned>(buffers_.buffers.size());
+        io_.wait(current_);     // the buffer is reused only after its previous contents were written
+    }
+
+    detail::file_descriptor     file_;
+    detail::record_buffers      buffers_;
+    detail::uring_io            io_;
+    unsigned                    current_ = 0;
+    std::size_t                 count_ = 0;
+    std::uint64_t               offset_ = 0;
+    std::uint64_t               records_ = 0;
+    bool                        closed_ = false;
+};
+
+/// \brief Reads aggregates from a file written by boost::pfr::uring_record_writer<T>, keeping several buffers of records in flight.
+///
+/// Reads of the following parts of the file are submitted ahead, records of one buffer are decoded while the next ones
+/// are being read by the kernel.
+///
+/// \b Requires: all the fields of `T` are trivially copyable.
+///
+/// \b Example:
+/// \code
+///     boost::pfr::uring_record_reader<tick> in("ticks.bin");
+///     tick t;
+///     while (in.pop(t)) {
+///         process(t);
+///     }
+/// \endcode
+template <class T>
+class uring_record_reader {
+    typedef detail::packed_record<T> record_t;
+
+public:
+    /// Opens the file at `path` and starts reading it.
+    /// \param buffer_size Approximate size of each buffer in bytes, rounded down to whole records.
+    /// \param depth Count of buffers that are read ahead.
+    /// \throws std::system_error if the file could not be opened.
+    explicit uring_record_reader(const char* path, std::size_t buffer_size = 1 << 20, unsigned depth = 4)
+        : file_(path, O_RDONLY)
+        , buffers_(record_t::size, buffer_size, depth)
+        , io_(file_.get(), depth)
+    {
+        for (unsigned slot = 0; slot < depth; ++slot) {
+            submit(slot);
+        }
+    }
+
+    uring_record_reader(const uring_record_reader&) = delete;
+    uring_record_reader& operator=(const uring_record_reader&) = delete;
+
+    /// Waits for the reads ahead that are in flight.
+    ~uring_record_reader() {
+        buffers_.release(io_);
+    }
+
+    /// Decodes the next record into `value`.
+    /// \return false if there are no more records.
+    /// \throws std::system_error if a read failed, std::runtime_error if the file ends in the middle of a record.
+    bool pop(T& value) {
+        if (position_ == end_) {
+            if (!next_buffer()) {
+                return false;
+            }
+        }
+        record_t::decode(buffers_.buffers[current_].get() + position_, value);
+        position_ += record_t::size;
+        return true;
+    }
+
+    /// \return true if the reads are done asynchronously with io_uring.
+    bool is_async() const noexcept {
+        return io_.is_async();
+    }
+
+private:
+    void submit(unsigned slot) {
+        io_.submit(slot, false, buffers_.buffers[slot].get(), buffers_.bytes_per_buffer, offset_);
+        offset_ += buffers_.bytes_per_buffer;
+    }
+
+    bool next_buffer() {
+        if (eof_) {
+            return false;
+        }
+        if (started_) {
+            submit(current_);
+            current_ = (current_ + 1) % static_cast<unsigned>(buffers_.buffers.size());
+        }
+        started_ = true;
+
+        end_ = io_.wait(current_);
+        position_ = 0;
+        if (end_ % record_t::size) {
+            throw std::runtime_error("boost::pfr::uring_record_reader: file ends in the middle of a record");
+        }
+        if (end_ < buffers_.bytes_per_buffer) {
+            eof_ = true;
+        }
+        return end_ != 0;
+    }
+
+    detail::file_descriptor     file_;
+    detail::record_buffers      buffers_;
+    detail::uring_io            io_;
+    unsigned                    current_ = 0;
+    std::size_t                 position_ = 0;
+    std::size_t                 end_ = 0;
+    std::uint64_t               offset_ = 0;
+    bool                        started_ = false;
+    bool                        eof_ = false;
+};
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_URING_RECORD_HPP
@@ -0,0 +1,238 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_WRITE_FORMATTED_HPP
+#define BOOST_PFR_PRECISE_WRITE_FORMATTED_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#if !BOOST_PFR_USE_CPP17
+#   error C++17 is required for this header.
+#endif
+
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <boost/pfr/precise/core.hpp>
+#include <boost/pfr/precise/tuple_size.hpp>
+
+/// \file boost/pfr/precise/write_formatted.hpp
+/// Contains boost::pfr::write_formatted that writes aggregates with per field format specifications from boost::pfr::fmt.
+///
+/// \b Requires: C++17.
+namespace boost { namespace pfr {
+
+namespace detail {
+    enum class format_kind { as_is, dec, hex, fixed, scientific };
+
+    template <format_kind Kind, int Precision, unsigned Width, char Fill>
+    struct format_spec {};
+} // namespace detail
+
+/// Format specifications for boost::pfr::write_formatted. `Width` is the minimal width of the field, shorter values are
+/// right aligned and padded with `Fill`. If `Fill` is '0', zeros are inserted after the sign of negative values.
+namespace fmt {
+
+/// Shortest representation that round trips for arithmetic types, '1' or '0' for bool, the character for char, quoted
+/// strings and `operator<<` for other types.
+using as_is = detail::format_spec<detail::format_kind::as_is, -1, 0, ' '>;
+
+/// Decimal integers or shortest representation of floating point values, padded to `Width`. bool is written as '1' or '0'.
+template <unsigned Width = 0, char Fill = ' '>
+using dec = detail::format_spec<detail::format_kind::dec, -1, Width, Fill>;
+
+/// Hexadecimal integers in lower case without prefix, padded to `Width`. bool is written as '1' or '0'.
+template <unsigned Width = 0, char Fill = '0'>
+using hex = detail::format_spec<detail::format_kind::hex, -1, Width, Fill>;
+
+/// Floating point values in fixed notation with `Precision` digits after the decimal point.
+template <int Precision, unsigned Width = 0, char Fill = ' '>
+using fixed = detail::format_spec<detail::format_kind::fixed, Precision, Width, Fill>;
+
+/// Floating point values in scientific notation with `Precision` digits after the decimal point.
+template <int Precision, unsigned Width = 0, char Fill = ' '>
+using scientific = detail::format_spec<detail::format_kind::scientific, Precision, Width, Fill>;
+
+} // namespace fmt
+
+namespace detail {
+
+    ///////////////////// Sinks
+    template <class Sink>
+    void sink_put(Sink& out, const char* data, std::size_t size) {
+        if constexpr (std::is_base_of<std::ios_base, Sink>::value) {
+            out.write(data, static_cast<std::streamsize>(size));
+        } else if constexpr (std::is_same<Sink, std::string>::value) {
+            out.append(data, size);
+        } else {
+            out(data, size);
+        }
+    }
+
+    template <class Sink, class F>
+    void sink_put_streamed(Sink& out, const F& value) {
+        if constexpr (std::is_base_of<std::ios_base, Sink>::value) {
+            out << value;
+        } else {
+            std::ostringstream ss;
+            ss << value;
+            const std::string s = ss.str();
+            detail::sink_put(out, s.data(), s.size());
+        }
+    }
+
+    ///////////////////// Formatting of a single value
+    template <class F, format_kind Kind, int Precision>
+    constexpr std::size_t formatted_max_size() noexcept {
+        if constexpr (!std::is_floating_point<F>::value) {
+            return std::numeric_limits<F>::digits + 2;  // sign and binary digits are enough for any base
+        } else if constexpr (Kind == format_kind::fixed) {
+            // sign, integral digits, point, fraction digits
+            return 1 + std::numeric_limits<F>::max_exponent10 + 1 + 1 + Precision;
+        } else {
+            // sign, digit, point, fraction digits, exponent
+            return 1 + 1 + 1 + (Kind == format_kind::scientific ? Precision : std::numeric_limits<F>::max_digits10) + 7;
+        }
+    }
+
+    template <format_kind Kind, int Precision, class F>
+    std::to_chars_result formatted_to_chars(char* first, char* last, const F& value) {
+        if constexpr (std::is_same<F, bool>::value && (Kind == format_kind::dec || Kind == format_kind::hex)) {
+            // std::to_chars(bool) is deleted, bool is written as with fmt::as_is
+            *first = (value ? '1' : '0');
+            return {first + 1, std::errc{}};
+        } else if constexpr (Kind == format_kind::hex) {
+            static_assert(std::is_integral<F>::value, "====================> Boost.PFR: boost::pfr::fmt::hex requires integral field");
+            return std::to_chars(first, last, value, 16);
+        } else if constexpr (Kind == format_kind::fixed || Kind == format_kind::scientific) {
+            static_assert(
+                std::is_floating_point<F>::value,
+                "====================> Boost.PFR: boost::pfr::fmt::fixed and boost::pfr::fmt::scientific require floating point field"
+            );
+            static_assert(Precision >= 0, "====================> Boost.PFR: Precision must not be negative");
+            return std::to_chars(
+                first, last, value, (Kind == format_kind::fixed ? std::chars_format::fixed : std::chars_format::scientific), Precision
+            );
+        } else {
+            static_assert(std::is_arithmetic<F>::value, "====================> Boost.PFR: boost::pfr::fmt::dec requires arithmetic field");
+            return std::to_chars(first, last, value);
+        }
+    }
+
+    template <class Sink, class F, format_kind Kind, int Precision, unsigned Width, char Fill>
+    void write_formatted_field(Sink& out, const F& value, format_spec<Kind, Precision, Width, Fill>) {
+        // Digits are written after `Width` reserved chars, padding is written just before them
+        char buffer[Width + detail::formatted_max_size<F, Kind, Precision>()];
+        char* const digits = buffer + Width;
+        const auto res = detail::formatted_to_chars<Kind, Precision>(digits, buffer + sizeof(buffer), value);
+        const std::size_t length = static_cast<std::size_t>(res.ptr - digits);
+
+        char* first = digits;
+        if (length < Width) {
+            first = digits - (Width - length);
+            std::memset(first, Fill, Width - length);
+            if (Fill == '0' && *digits == '-') {
+                *first = '-';
+                *digits = '0';
+            }
+        }
+
+        detail::sink_put(out, first, static_cast<std::size_t>(res.ptr - first));
+    }
+
+    template <class Sink>
+    void write_quoted(Sink& out, std::string_view s) {
+        detail::sink_put(out, "\"", 1);
+        std::size_t begin = 0;
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == '"' || s[i] == '\\') {
+                detail::sink_put(out, s.data() + begin, i - begin);
+                detail::sink_put(out, "\\", 1);
+                begin = i;
+            }
+        }
+        detail::sink_put(out, s.data() + begin, s.size() - begin);
+        detail::sink_put(out, "\"", 1);
+    }
+
+    template <class Sink, class F>
+    void write_formatted_field(Sink& out, const F& value, ::boost::pfr::fmt::as_is) {
+        if constexpr (std::is_same<F, bool>::value) {
+            detail::sink_put(out, value ? "1" : "0", 1);
+        } else if constexpr (std::is_same<F, char>::value) {
+            detail::sink_put(out, &value, 1);
+        } else if constexpr (std::is_arithmetic<F>::value) {
+            detail::write_formatted_field(out, value, ::boost::pfr::fmt::dec<>{});
+        } else if constexpr (std::is_same<F, std::string>::value || std::is_same<F, std::string_view>::value) {
+            detail::write_quoted(out, value);
+        } else {
+            detail::sink_put_streamed(out, value);
+        }
+    }
+
+    template <class... Specs>
+    struct format_specs {};
+
+    template <std::size_t I, class... Specs>
+    auto format_spec_at(format_specs<Specs...>) noexcept {
+        if constexpr (I < sizeof...(Specs)) {
+            return std::tuple_element_t<I, std::tuple<Specs...>>{};
+        } else {
+            return ::boost::pfr::fmt::as_is{};
+        }
+    }
+
+    template <class Specs, class Sink, class T, std::size_t... I>
+    void write_formatted_impl(Sink& out, const T& value, std::index_sequence<I...>) {
+        const int ignore[] = {0, (
+            detail::sink_put(out, ", ", (I ? 2 : 0)),
+            detail::write_formatted_field(out, ::boost::pfr::get<I>(value), detail::format_spec_at<I>(Specs{})),
+            0
+        )...};
+        (void)ignore;
+    }
+
+} // namespace detail
+
+/// \brief Writes aggregate `value` to `sink` in the same form as boost::pfr::write, formatting the field `I` according to the
+/// `I`-th of the `Specs...`. Fields without specification are formatted as with boost::pfr::fmt::as_is.
+///
+/// Specifications are resolved at compile time into calls of `std::to_chars` with fixed arguments. Streams are written with
+/// `write()`, their formatting state is neither used nor changed.
+///
+/// \param sink `std::basic_ostream`, `std::string` to append to, or a functor callable with `(const char* data, std::size_t size)`.
+///
+/// \b Example:
+/// \code
+///     struct quote { unsigned id; double bid; double ask; std::string venue; };
+///     namespace fmt = boost::pfr::fmt;
+///
+///     std::string s;
+///     boost::pfr::write_formatted<fmt::dec<8, '0'>, fmt::fixed<4>, fmt::fixed<4>>(s, quote{42, 1.1, 1.10006, "LSE"});
+///     assert(s == "{00000042, 1.1000, 1.1001, \"LSE\"}");
+/// \endcode
+template <class... Specs, class Sink, class T>
+void write_formatted(Sink& sink, const T& value) {
+    constexpr std::size_t fields_count = ::boost::pfr::tuple_size_v<T>;
+    static_assert(sizeof...(Specs) <= fields_count, "====================> Boost.PFR: More format specifications than fields");
+
+    detail::sink_put(sink, "{", 1);
+    detail::write_formatted_impl<detail::format_specs<Specs...>>(sink, value, std::make_index_sequence<fields_count>{});
+    detail::sink_put(sink, "}", 1);
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_WRITE_FORMATTED_HPP
@@ -0,0 +1,237 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_PRECISE_WRITE_OPENMETRICS_HPP
+#define BOOST_PFR_PRECISE_WRITE_OPENMETRICS_HPP
+#pragma once
+
+#include <boost/pfr/detail/config.hpp>
+
+#if !BOOST_PFR_USE_CPP17
+#   error C++17 is required for this header.
+#endif
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <boost/pfr/precise/core.hpp>
+#include <boost/pfr/precise/tuple_size.hpp>
+#include <boost/pfr/precise/write_formatted.hpp>
+
+/// \file boost/pfr/precise/write_openmetrics.hpp
+/// Contains boost::pfr::write_openmetrics that writes numeric fields of aggregates in the Prometheus text exposition and
+/// OpenMetrics formats.
+///
+/// \b Requires: C++17.
+namespace boost { namespace pfr {
+
+namespace detail {
+
+    ///////////////////// Metric name suffixes
+    //
+    // Field names are not reflected, so the field with index `I` is named by its index: `prefix_I`. Fields of the nested
+    // aggregates are named by the path of indexes: `prefix_I_J`. Suffixes are rendered at compile time.
+    constexpr std::size_t decimal_digits(std::size_t x) noexcept {
+        std::size_t result = 1;
+        for (; x >= 10; x /= 10) {
+            ++result;
+        }
+        return result;
+    }
+
+    template <std::size_t... Path>
+    struct metric_suffix {
+        static constexpr std::size_t size = (std::size_t{0} + ... + (1 + detail::decimal_digits(Path)));
+
+        static constexpr std::array<char, size + 1> make() noexcept {
+            std::array<char, size + 1> result{};
+            const std::size_t path[] = {0, Path...};
+            std::size_t pos = 0;
+            for (std::size_t i = 1; i < sizeof(path) / sizeof(path[0]); ++i) {
+                std::size_t index = path[i];
+                const std::size_t digits = detail::decimal_digits(index);
+                result[pos] = '_';
+                for (std::size_t d = digits; d > 0; --d, index /= 10) {
+                    result[pos + d] = static_cast<char>('0' + index % 10);
+                }
+                pos += 1 + digits;
+            }
+            return result;
+        }
+
+        static constexpr std::array<char, size + 1> value = make();
+    };
+
+    ///////////////////// Buffered output
+    //
+    // Lines are accumulated on the stack, so functor sinks are called once per kilobyte rather than a few times per line.
+    template <class Sink>
+    class metrics_buffer {
+    public:
+        explicit metrics_buffer(Sink& sink) noexcept
+            : sink_(sink)
+        {}
+
+        metrics_buffer(const metrics_buffer&) = delete;
+        metrics_buffer& operator=(const metrics_buffer&) = delete;
+
+        void put(const char* data, std::size_t size) {
+            if (size > sizeof(data_) - size_) {
+                flush();
+                if (size > sizeof(data_)) {
+                    detail::sink_put(sink_, data, size);
+                    return;
+                }
+            }
+            std::memcpy(data_ + size_, data, size);
+            size_ += size;
+        }
+
+        /// \return buffer for at least `size` chars that are committed by the following call to commit().
+        char* reserve(std::size_t size) {
+            if (size > sizeof(data_) - size_) {
+                flush();
+            }
+            return data_ + size_;
+        }
+
+        void commit(char* end) noexcept {
+            size_ = static_cast<std::size_t>(end - data_);
+        }
+
+        void flush() {
+            if (size_) {
+                detail::sink_put(sink_, data_, size_);
+                size_ = 0;
+            }
+        }
+
+    private:
+        Sink&       sink_;
+        std::size_t size_ = 0;
+        char        data_[1024];
+    };
+
+    struct metrics_line {
+        std::string_view prefix;
+        std::string_view labels;
+    };
+
+    template <class F>
+    constexpr bool is_metric_value() noexcept {
+        return std::is_arithmetic<F>::value || std::is_enum<F>::value;
+    }
+
+    template <class Sink, class F>
+    void write_metric_value(metrics_buffer<Sink>& out, const F& value) {
+        constexpr std::size_t max_size = 32;    // enough for 64 bit integers and the shortest round trip doubles
+        char* const first = out.reserve(max_size);
+
+        if constexpr (std::is_enum<F>::value) {
+            out.commit(std::to_chars(first, first + max_size, static_cast<std::underlying_type_t<F>>(value)).ptr);
+        } else if constexpr (std::is_same<F, bool>::value) {
+            *first = (value ? '1' : '0');
+            out.commit(first + 1);
+        } else if constexpr (std::is_floating_point<F>::value) {
+            // Spelling of the special values is defined by the exposition formats. float and double are written in their
+            // own shortest round trip form, long double is narrowed to double as the exposition formats use doubles.
+            typedef std::conditional_t<std::is_same<F, long double>::value, double, F> value_t;
+            const value_t d = static_cast<value_t>(value);
+            if (d != d) {
+                out.put("NaN", 3);
+            } else if (d == std::numeric_limits<value_t>::infinity()) {
+                out.put("+Inf", 4);
+            } else if (d == -std::numeric_limits<value_t>::infinity()) {
+                out.put("-Inf", 4);
+            } else {
+                out.commit(std::to_chars(first, first + max_size, d).ptr);
+            }
+        } else {
+            out.commit(std::to_chars(first, first + max_size, value).ptr);
+        }
+    }
+
+    template <std::size_t... Path, class Sink, class T, std::size_t... I>
+    void write_metric_fields(metrics_buffer<Sink>& out, const metrics_line& line, const T& value, std::index_sequence<I...>);
+
+    template <std::size_t... Path, class Sink, class F>
+    void write_metric(metrics_buffer<Sink>& out, const metrics_line& line, const F& value) {
+        if constexpr (detail::is_metric_value<F>()) {
+            constexpr auto& suffix = metric_suffix<Path...>::value;
+            out.put(line.prefix.data(), line.prefix.size());
+            out.put(suffix.data(), suffix.size() - 1);
+            if (!line.labels.empty()) {
+                out.put("{", 1);
+                out.put(line.labels.data(), line.labels.size());
+                out.put("} ", 2);
+            } else {
+                out.put(" ", 1);
+            }
+            detail::write_metric_value(out, value);
+            out.put("\n", 1);
+        } else if constexpr (std::is_class<F>::value && std::is_aggregate<F>::value) {
+            detail::write_metric_fields<Path...>(out, line, value, std::make_index_sequence<::boost::pfr::tuple_size_v<F>>{});
+        }
+        // Strings, containers, pointers and other non numeric fields are skipped
+    }
+
+    template <std::size_t... Path, class Sink, class T, std::size_t... I>
+    void write_metric_fields(metrics_buffer<Sink>& out, const metrics_line& line, const T& value, std::index_sequence<I...>) {
+        (detail::write_metric<Path..., I>(out, line, ::boost::pfr::get<I>(value)), ...);
+    }
+
+} // namespace detail
+
+/// \brief Writes a line `prefix_I{labels} value` for each numeric field of `value` in the Prometheus text exposition format,
+/// that is also a valid OpenMetrics format without the metric family metadata.
+///
+/// Field `I` is named by its index, fields of nested aggregates by the path of indexes: `prefix_I_J`. Name suffixes are
+/// rendered at compile time. Arithmetic and enum fields are written, nested aggregates are written recursively, other
+/// fields are skipped. Numbers are formatted with `std::to_chars`, floating point special values as `NaN`, `+Inf` and
+/// `-Inf`.
+///
+/// Nothing is allocated: lines are composed in a buffer on the stack and passed to `sink` in blocks, so a `std::string`
+/// sink with reserved capacity or a functor sink never allocate.
+///
+/// \param sink `std::basic_ostream`, `std::string` to append to, or a functor callable with `(const char* data, std::size_t size)`.
+/// \param prefix valid metric name, e.g. `"http_server"`.
+/// \param labels rendered label pairs without the braces, e.g. `"method=\"get\",code=\"200\""`. Empty labels are omitted.
+///
+/// \b Example:
+/// \code
+///     struct latency { std::uint64_t count; double sum; };
+///     struct http_stats { std::uint64_t requests; latency get; latency post; };
+///
+///     std::string page;
+///     page.reserve(1 << 16);
+///     boost::pfr::write_openmetrics(page, "http", stats, "instance=\"a\"");
+///     page += "# EOF\n";      // required at the end of OpenMetrics exposition
+///
+///     // http_0{instance="a"} 42
+///     // http_1_0{instance="a"} 40
+///     // http_1_1{instance="a"} 0.5
+///     // ...
+/// \endcode
+template <class Sink, class T>
+void write_openmetrics(Sink& sink, std::string_view prefix, const T& value, std::string_view labels = {}) {
+    static_assert(
+        std::is_class<T>::value && std::is_aggregate<T>::value,
+        "====================> Boost.PFR: write_openmetrics requires an aggregate"
+    );
+
+    detail::metrics_buffer<Sink> out(sink);
+    detail::write_metric<>(out, detail::metrics_line{prefix, labels}, value);
+    out.flush();
+}
+
+}} // namespace boost::pfr
+
+#endif // BOOST_PFR_PRECISE_WRITE_OPENMETRICS_HPP
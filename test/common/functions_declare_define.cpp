@@ -0,0 +1,54 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Operators are only declared here, definitions are in functions_declare_define_impl.cpp
+#include "functions_declare_define.hpp"
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <sstream>
+#include <set>
+#include <string>
+
+#include <boost/functional/hash.hpp>
+#include <unordered_set>
+
+int main() {
+    using test_ns::declared_struct;
+
+    declared_struct s1 {0, 1, false, 6,7,8,9,10,11};
+    declared_struct s2 = s1;
+    declared_struct s3 {0, 1, false, 6,7,8,9,10,11111};
+    BOOST_TEST(s1 == s2);
+    BOOST_TEST(s1 <= s2);
+    BOOST_TEST(s1 >= s2);
+    BOOST_TEST(!(s1 != s2));
+    BOOST_TEST(!(s1 == s3));
+    BOOST_TEST(s1 != s3);
+    BOOST_TEST(s1 < s3);
+    BOOST_TEST(s3 > s2);
+    BOOST_TEST(s1 <= s3);
+    BOOST_TEST(s3 >= s2);
+
+    std::stringstream ss;
+    ss << s1;
+    BOOST_TEST_EQ(ss.str(), "{0, 1, 0, 6, 7, 8, 9, 10, 11}");
+    declared_struct s4 {};
+    ss >> s4;
+    BOOST_TEST(s1 == s4);
+
+    std::set<declared_struct> st;
+    st.insert(s1);
+    st.insert(s3);
+    BOOST_TEST_EQ(st.size(), 2u);
+
+    std::unordered_set<declared_struct, boost::hash<declared_struct>> us;
+    us.insert(s1);
+    us.insert(s2);
+    us.insert(s3);
+    BOOST_TEST_EQ(us.size(), 2u);
+
+    return boost::report_errors();
+}
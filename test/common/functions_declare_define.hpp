@@ -0,0 +1,31 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_PFR_TEST_FUNCTIONS_DECLARE_DEFINE_HPP
+#define BOOST_PFR_TEST_FUNCTIONS_DECLARE_DEFINE_HPP
+
+#ifdef BOOST_PFR_TEST_FLAT
+#include <boost/pfr/flat/functions_for.hpp>
+#define BOOST_PFR_TEST_FUNCTIONS_DECLARE BOOST_PFR_FLAT_FUNCTIONS_DECLARE
+#define BOOST_PFR_TEST_FUNCTIONS_DEFINE BOOST_PFR_FLAT_FUNCTIONS_DEFINE
+#endif
+
+#ifdef BOOST_PFR_TEST_PRECISE
+#include <boost/pfr/precise/functions_for.hpp>
+#define BOOST_PFR_TEST_FUNCTIONS_DECLARE BOOST_PFR_PRECISE_FUNCTIONS_DECLARE
+#define BOOST_PFR_TEST_FUNCTIONS_DEFINE BOOST_PFR_PRECISE_FUNCTIONS_DEFINE
+#endif
+
+namespace test_ns {
+
+struct declared_struct {
+    int i; short s; bool bl; int a,b,c,d,e,f;
+};
+
+BOOST_PFR_TEST_FUNCTIONS_DECLARE(declared_struct)
+
+} // namespace test_ns
+
+#endif // BOOST_PFR_TEST_FUNCTIONS_DECLARE_DEFINE_HPP
@@ -0,0 +1,12 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "functions_declare_define.hpp"
+
+namespace test_ns {
+
+BOOST_PFR_TEST_FUNCTIONS_DEFINE(declared_struct)
+
+} // namespace test_ns
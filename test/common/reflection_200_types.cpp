@@ -0,0 +1,49 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Compile time benchmark: reflection of 200 different types. Most of the time here is spent
+// on fields count detection and on overload resolution in the dispatch points.
+//
+// Measure with: time g++ -std=c++14 -I../../include -c reflection_200_types.cpp
+
+#include <boost/pfr/precise.hpp>
+#include <boost/pfr/flat.hpp>
+
+#include <utility>
+
+template <std::size_t N>
+struct stress_type {
+    int i;
+    short s;
+    char c;
+    unsigned u;
+    double d;
+    const char* p;
+};
+
+template <std::size_t N>
+std::size_t reflect_one() {
+    stress_type<N> v{};
+    std::size_t res = boost::pfr::tuple_size_v<stress_type<N>> + boost::pfr::flat_tuple_size_v<stress_type<N>>;
+    boost::pfr::for_each_field(v, [&res](const auto&, std::size_t i) { res += i; });
+    boost::pfr::flat_for_each_field(v, [&res](const auto&, auto i) { res += decltype(i)::value; });
+    res += boost::pfr::flat_less<stress_type<N>>{}(v, v);
+    res += boost::pfr::equal_to<stress_type<N>>{}(v, v);
+    return res;
+}
+
+template <std::size_t... I>
+std::size_t reflect_all(std::index_sequence<I...>) {
+    const std::size_t results[] = { reflect_one<I>()... };
+    std::size_t res = 0;
+    for (std::size_t v: results) {
+        res += v;
+    }
+    return res;
+}
+
+std::size_t reflect_200_types() {
+    return reflect_all(std::make_index_sequence<200>{});
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Compile time benchmark: 21 different Boost.PFR operations on the same 64 fields type.
+// All of them must share a single reflection of the type (see boost/pfr/detail/reflection_info.hpp),
+// so the compilation time of this file should be close to the compilation time of a single operation.
+//
+// Measure with: time g++ -std=c++14 -I../../include -c reflection_64_fields.cpp
+
+#include <boost/pfr/precise.hpp>
+#include <boost/pfr/flat.hpp>
+
+#include <sstream>
+
+struct fields64 {
+    unsigned f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59, f60, f61, f62, f63;
+};
+
+bool use_64_fields(fields64& a, const fields64& b) {
+    std::stringstream ss;
+    bool res = true;
+
+    // Precise
+    static_assert(boost::pfr::tuple_size_v<fields64> == 64, "");                             // 1
+    boost::pfr::get<63>(a) = 1;                                                              // 2
+    static_assert(std::is_same<boost::pfr::tuple_element_t<32, fields64>, unsigned>::value, ""); // 3
+    res = res && std::get<0>(boost::pfr::structure_to_tuple(b)) == b.f0;                     // 4
+    std::get<1>(boost::pfr::structure_tie(a)) = 2;                                           // 5
+    boost::pfr::for_each_field(a, [](auto& f) { ++f; });                                     // 6
+    res = res && boost::pfr::equal_to<fields64>{}(a, b);                                     // 7
+    res = res && boost::pfr::not_equal<fields64>{}(a, b);                                    // 8
+    res = res && boost::pfr::less<fields64>{}(a, b);                                         // 9
+    res = res && boost::pfr::greater_equal<fields64>{}(a, b);                                // 10
+    res = res && boost::pfr::hash<fields64>{}(a) != 0;                                       // 11
+    boost::pfr::write(ss, a);                                                                // 12
+    boost::pfr::read(ss, a);                                                                 // 13
+
+    // Flat
+    static_assert(boost::pfr::flat_tuple_size_v<fields64> == 64, "");                        // 14
+    boost::pfr::flat_get<62>(a) = 3;                                                         // 15
+    res = res && std::get<2>(boost::pfr::flat_structure_to_tuple(b)) == b.f2;                // 16
+    boost::pfr::flat_for_each_field(a, [](auto& f) { --f; });                                // 17
+    res = res && boost::pfr::flat_less<fields64>{}(a, b);                                    // 18
+    res = res && boost::pfr::flat_hash<fields64>{}(a) != 0;                                  // 19
+    boost::pfr::flat_write(ss, b);                                                           // 20
+    static_assert(std::is_same<boost::pfr::flat_tuple_element_t<40, fields64>, unsigned>::value, ""); // 21
+
+    return res;
+}
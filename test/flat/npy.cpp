@@ -0,0 +1,131 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+
+#if !defined(_WIN32)
+
+#include <boost/pfr/flat/npy.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+enum class side : std::uint8_t { buy, sell };
+
+struct price_level { double price; std::int32_t qty; };
+
+struct tick {
+    std::int64_t timestamp;
+    price_level level;
+    side s;
+    bool implied;
+    char venue[2];
+};
+
+struct compact { std::uint16_t a; std::int16_t b; float c; };
+
+const char* const path = "pfr_npy_test.npy";
+
+std::string read_file(const char* p) {
+    std::ifstream f(p, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+void write_file(const char* p, const std::string& data) {
+    std::ofstream f(p, std::ios::binary | std::ios::trunc);
+    f << data;
+}
+
+template <class T>
+bool map_throws(const char* p) {
+    try {
+        boost::pfr::map_npy<T>(p);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    BOOST_TEST_EQ(
+        boost::pfr::detail::npy_descr<tick>(),
+        "[('f0', '<i8'), ('f1', '<f8'), ('f2', '<i4'), ('', '|V4'), ('f3', '|u1'), ('f4', '|b1'), ('f5', '|S1'), ('f6', '|S1'), ('', '|V4')]"
+    );
+    BOOST_TEST_EQ(boost::pfr::detail::npy_descr<compact>(), "[('f0', '<u2'), ('f1', '<i2'), ('f2', '<f4')]");
+
+    std::vector<tick> ticks;
+    for (int i = 0; i < 1000; ++i) {
+        ticks.push_back(tick{1000000 + i, {100.0 + i * 0.5, i - 500}, (i % 2 ? side::sell : side::buy), i % 3 == 0, {'X', char('A' + i % 26)}});
+    }
+    boost::pfr::write_npy(path, ticks);
+
+    const std::string file = read_file(path);
+    BOOST_TEST_EQ(file.compare(0, 8, std::string("\x93NUMPY\x01\x00", 8)), 0);
+    const std::size_t header_size = 10 + static_cast<unsigned char>(file[8]) + 256 * static_cast<unsigned char>(file[9]);
+    BOOST_TEST_EQ(header_size % 64, 0u);
+    BOOST_TEST_EQ(file[header_size - 1], '\n');
+    BOOST_TEST_NE(file.find("'fortran_order': False, 'shape': (1000,), }"), std::string::npos);
+    BOOST_TEST_EQ(file.size(), header_size + ticks.size() * sizeof(tick));
+
+    {
+        const boost::pfr::mapped_npy<tick> mapped = boost::pfr::map_npy<tick>(path);
+        BOOST_TEST_EQ(mapped.size(), ticks.size());
+        for (std::size_t i = 0; i < ticks.size(); ++i) {
+            BOOST_TEST_EQ(mapped[i].timestamp, ticks[i].timestamp);
+            BOOST_TEST_EQ(mapped[i].level.price, ticks[i].level.price);
+            BOOST_TEST_EQ(mapped[i].level.qty, ticks[i].level.qty);
+            BOOST_TEST(mapped[i].s == ticks[i].s);
+            BOOST_TEST_EQ(mapped[i].implied, ticks[i].implied);
+            BOOST_TEST_EQ(mapped[i].venue[1], ticks[i].venue[1]);
+        }
+    }
+
+    // Field names are not checked, field formats are
+    std::string renamed = file;
+    renamed.replace(renamed.find("('f0'"), 5, "('ts'");
+    write_file(path, renamed);
+    BOOST_TEST_EQ(boost::pfr::map_npy<tick>(path).size(), 1000u);
+    BOOST_TEST(map_throws<compact>(path));
+
+    std::string wrong_shape = file;
+    wrong_shape.replace(wrong_shape.find("(1000,)"), 7, "(1001,)");
+    write_file(path, wrong_shape);
+    BOOST_TEST(map_throws<tick>(path));
+
+    write_file(path, file.substr(0, file.size() - 1));
+    BOOST_TEST(map_throws<tick>(path));
+
+    write_file(path, "not a numpy file");
+    BOOST_TEST(map_throws<tick>(path));
+
+    // Empty arrays and arrays from pointers
+    boost::pfr::write_npy(path, static_cast<const compact*>(nullptr), 0);
+    BOOST_TEST(boost::pfr::map_npy<compact>(path).empty());
+
+    const compact values[] = {{1, -1, 0.5f}, {65535, -32768, 1e10f}};
+    boost::pfr::write_npy(path, values, 2);
+    const auto mapped = boost::pfr::map_npy<compact>(path);
+    BOOST_TEST_EQ(mapped.size(), 2u);
+    BOOST_TEST_EQ(mapped[1].a, 65535);
+    BOOST_TEST_EQ(mapped[1].b, -32768);
+    BOOST_TEST_EQ(mapped[1].c, 1e10f);
+    BOOST_TEST_EQ(mapped.end() - mapped.begin(), 2);
+
+    std::remove(path);
+    return boost::report_errors();
+}
+
+#else
+
+int main() {
+    return boost::report_errors();
+}
+
+#endif
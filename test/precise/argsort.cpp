@@ -0,0 +1,152 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/argsort.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class side : unsigned char { buy, sell };
+
+struct trade {
+    std::uint32_t instrument;
+    side s;
+    std::int64_t timestamp;
+    double price;
+};
+
+struct big_record {
+    int key;
+    std::uint64_t a, b, c, d, e, f, g, h, i;  // wider than a cache line
+};
+
+struct named {
+    std::string name;
+    int id;
+};
+
+struct trades_soa {
+    std::vector<int> instrument;
+    std::vector<double> price;
+    std::vector<std::string> comment;
+};
+
+template <class T, class Less>
+void test_aos_sorted(const std::vector<T>& original, const std::vector<std::size_t>& p, Less less) {
+    BOOST_TEST_EQ(p.size(), original.size());
+
+    std::vector<T> expected = original;
+    std::stable_sort(expected.begin(), expected.end(), less);
+
+    std::vector<T> actual = original;
+    boost::pfr::apply_permutation(actual, p);
+    for (std::size_t i = 0; i < actual.size(); ++i) {
+        BOOST_TEST(!less(actual[i], expected[i]) && !less(expected[i], actual[i]));
+        BOOST_TEST_EQ(actual[i].price, expected[i].price);  // stability: the same record
+    }
+}
+
+void test_normalized_keys() {
+    std::vector<trade> v;
+    for (int i = 0; i < 1000; ++i) {
+        const std::uint32_t instrument = static_cast<std::uint32_t>((i * 7919) % 13) + (i % 2 ? 0x80000000u : 0u);
+        v.push_back(trade{instrument, static_cast<side>(i % 2), (i * 31) % 17 - 8, static_cast<double>(i)});
+    }
+
+    test_aos_sorted(v, boost::pfr::argsort_by<0, 2>(v), [](const trade& l, const trade& r) {
+        return l.instrument < r.instrument || (l.instrument == r.instrument && l.timestamp < r.timestamp);
+    });
+
+    test_aos_sorted(v, boost::pfr::argsort_by<1, 0>(v), [](const trade& l, const trade& r) {
+        return l.s < r.s || (l.s == r.s && l.instrument < r.instrument);
+    });
+
+    test_aos_sorted(v, boost::pfr::argsort_by<2>(v), [](const trade& l, const trade& r) {
+        return l.timestamp < r.timestamp;
+    });
+}
+
+void test_generic_keys() {
+    std::vector<named> v{{"delta", 0}, {"alpha", 1}, {"charlie", 2}, {"alpha", 3}, {"bravo", 4}, {"delta", 5}};
+    const auto p = boost::pfr::argsort_by<0>(v);
+
+    const std::vector<std::size_t> expected{1, 3, 4, 2, 0, 5};
+    BOOST_TEST(p == expected);
+
+    boost::pfr::apply_permutation(v, p);
+    BOOST_TEST_EQ(v[0].name, "alpha");
+    BOOST_TEST_EQ(v[0].id, 1);
+    BOOST_TEST_EQ(v[1].id, 3);
+    BOOST_TEST_EQ(v[2].name, "bravo");
+    BOOST_TEST_EQ(v[5].name, "delta");
+    BOOST_TEST_EQ(v[5].id, 5);
+
+    // Sorting by all the fields
+    std::vector<named> w{{"b", 2}, {"a", 9}, {"b", 1}};
+    BOOST_TEST((boost::pfr::argsort_by<>(w) == std::vector<std::size_t>{1, 2, 0}));
+}
+
+void test_cycle_following() {
+    std::vector<big_record> v;
+    for (int i = 0; i < 257; ++i) {
+        big_record r{};
+        r.key = (i * 101) % 257;
+        r.i = static_cast<std::uint64_t>(i);
+        v.push_back(r);
+    }
+
+    const auto p = boost::pfr::argsort_by<0>(v);
+    boost::pfr::apply_permutation(v, p);
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        BOOST_TEST_EQ(v[i].key, static_cast<int>(i));
+        BOOST_TEST_EQ(v[i].i, p[i]);
+    }
+
+    // Identity and empty permutations
+    std::vector<big_record> copy = v;
+    boost::pfr::apply_permutation(copy, boost::pfr::argsort_by<0>(copy));
+    BOOST_TEST_EQ(copy[100].key, 100);
+
+    std::vector<big_record> empty;
+    BOOST_TEST(boost::pfr::argsort_by<0>(empty).empty());
+    boost::pfr::apply_permutation(empty, std::vector<std::size_t>{});
+}
+
+void test_soa() {
+    trades_soa t{
+        {3, 1, 2, 1, 3},
+        {30.0, 10.0, 20.0, 11.0, 31.0},
+        {"c0", "a0", "b0", "a1", "c1"}
+    };
+
+    const auto p = boost::pfr::argsort_by<0>(t);
+    BOOST_TEST((p == std::vector<std::size_t>{1, 3, 2, 0, 4}));
+
+    boost::pfr::apply_permutation(t, p);
+    BOOST_TEST((t.instrument == std::vector<int>{1, 1, 2, 3, 3}));
+    BOOST_TEST((t.price == std::vector<double>{10.0, 11.0, 20.0, 30.0, 31.0}));
+    BOOST_TEST((t.comment == std::vector<std::string>{"a0", "a1", "b0", "c0", "c1"}));
+
+    // Reversing: the numeric columns are gathered, the strings are moved along the cycles
+    const std::vector<std::size_t> reverse{4, 3, 2, 1, 0};
+    boost::pfr::apply_permutation(t, reverse);
+    BOOST_TEST_EQ(t.comment.front(), "c1");
+    BOOST_TEST_EQ(t.price.front(), 31.0);
+
+    BOOST_TEST((boost::pfr::argsort_by<2>(t) == std::vector<std::size_t>{4, 3, 2, 1, 0}));
+    BOOST_TEST((boost::pfr::argsort_by<0, 1>(t) == std::vector<std::size_t>{4, 3, 2, 1, 0}));
+}
+
+int main() {
+    test_normalized_keys();
+    test_generic_keys();
+    test_cycle_following();
+    test_soa();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,197 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/btree_map.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+enum class side : unsigned char { buy, sell };
+
+struct order_key {      // normalized and searched with SIMD
+    std::int32_t instrument;
+    std::uint64_t timestamp;
+    side s;
+};
+
+struct price_key {      // compared field by field
+    double price;
+    int level;
+};
+
+template <class K>
+bool key_less(const K& lhs, const K& rhs) {
+    return boost::pfr::detail::key_fields<K>::compare(lhs, rhs) < 0;
+}
+
+template <class K>
+struct key_less_t {
+    bool operator()(const K& lhs, const K& rhs) const { return key_less(lhs, rhs); }
+};
+
+struct no_default_value {
+    explicit no_default_value(int v) : value(v) {}
+    int value;
+};
+
+struct throwing_value {
+    explicit throwing_value(int v) : value(v) {
+        if (v < 0) {
+            throw std::runtime_error("negative");
+        }
+    }
+    int value;
+};
+
+template <class Map, class Key>
+void check_equal(const Map& m, const std::map<Key, int, key_less_t<Key>>& expected) {
+    BOOST_TEST_EQ(m.size(), expected.size());
+    auto it = m.begin();
+    for (const auto& v : expected) {
+        BOOST_TEST(it != m.end());
+        if (it == m.end()) return;
+        BOOST_TEST(!key_less(it->first, v.first) && !key_less(v.first, it->first));
+        BOOST_TEST_EQ(it->second, v.second);
+        ++it;
+    }
+    BOOST_TEST(it == m.end());
+}
+
+template <std::size_t NodeSize, class Key, class MakeKey>
+void test_random(MakeKey make_key) {
+    boost::pfr::btree_map<Key, int, NodeSize> m;
+    std::map<Key, int, key_less_t<Key>> expected;
+
+    std::uint32_t seed = 42;
+    for (int i = 0; i < 3000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const Key key = make_key(seed >> 8);
+        const auto res = m.try_emplace(key, i);
+        const auto res_expected = expected.emplace(key, i);
+        BOOST_TEST_EQ(res.second, res_expected.second);
+        BOOST_TEST_EQ((*res.first).second, res_expected.first->second);
+    }
+    check_equal(m, expected);
+
+    for (std::uint32_t i = 0; i < 3000; ++i) {
+        const Key key = make_key(i * 2654435761u >> 7);
+        const auto lb = m.lower_bound(key);
+        const auto lb_expected = expected.lower_bound(key);
+        BOOST_TEST_EQ(lb == m.end(), lb_expected == expected.end());
+        if (lb != m.end() && lb_expected != expected.end()) {
+            BOOST_TEST_EQ(lb->second, lb_expected->second);
+        }
+
+        const auto ub = m.upper_bound(key);
+        const auto ub_expected = expected.upper_bound(key);
+        BOOST_TEST_EQ(ub == m.end(), ub_expected == expected.end());
+        if (ub != m.end() && ub_expected != expected.end()) {
+            BOOST_TEST_EQ(ub->second, ub_expected->second);
+        }
+
+        BOOST_TEST_EQ(m.count(key), expected.count(key));
+    }
+
+    // Bulk loading of all the sizes that produce one, two and three levels
+    for (std::size_t size = 0; size < 300; size += (size < 40 ? 1 : 37)) {
+        std::vector<std::pair<Key, int>> sorted(expected.begin(), expected.end());
+        sorted.resize(size);
+        std::map<Key, int, key_less_t<Key>> part(sorted.begin(), sorted.end());
+
+        boost::pfr::btree_map<Key, int, NodeSize> loaded(boost::pfr::sorted_unique, sorted.begin(), sorted.end());
+        check_equal(loaded, part);
+        for (const auto& v : sorted) {
+            BOOST_TEST_EQ(loaded.find(v.first)->second, v.second);
+        }
+
+        // Inserting into the bulk loaded tree with full nodes
+        for (const auto& v : expected) {
+            loaded.try_emplace(v.first, v.second);
+        }
+        check_equal(loaded, expected);
+    }
+
+    // Copy and move
+    boost::pfr::btree_map<Key, int, NodeSize> copy = m;
+    check_equal(copy, expected);
+    boost::pfr::btree_map<Key, int, NodeSize> moved = std::move(copy);
+    check_equal(moved, expected);
+    BOOST_TEST(copy.empty());
+    m.clear();
+    BOOST_TEST(m.empty());
+    BOOST_TEST(m.begin() == m.end());
+    m = moved;
+    check_equal(m, expected);
+}
+
+int main() {
+    static_assert(boost::pfr::detail::normalized_key<order_key>::value, "");
+    static_assert(boost::pfr::detail::normalized_key<int>::value, "");
+    static_assert(!boost::pfr::detail::normalized_key<price_key>::value, "");
+
+    test_random<4, order_key>([](std::uint32_t v) {
+        return order_key{static_cast<std::int32_t>(v % 7) - 3, (v / 7 % 50) * 0x100000000000ull, static_cast<side>(v / 350 % 2)};
+    });
+    test_random<32, order_key>([](std::uint32_t v) {
+        return order_key{static_cast<std::int32_t>(v % 7) - 3, (v / 7 % 50) * 0x100000000000ull, static_cast<side>(v / 350 % 2)};
+    });
+    test_random<8, int>([](std::uint32_t v) {
+        return static_cast<int>(v % 5000) - 2500;
+    });
+    test_random<4, price_key>([](std::uint32_t v) {
+        return price_key{(v % 100) * 0.5 - 10.0, static_cast<int>(v / 100 % 30)};
+    });
+    test_random<16, price_key>([](std::uint32_t v) {
+        return price_key{(v % 100) * 0.5 - 10.0, static_cast<int>(v / 100 % 30)};
+    });
+
+    // Interface
+    boost::pfr::btree_map<order_key, no_default_value> m;
+    BOOST_TEST(m.find(order_key{1, 2, side::sell}) == m.end());
+    BOOST_TEST(m.lower_bound(order_key{1, 2, side::sell}) == m.end());
+    BOOST_TEST(m.try_emplace(order_key{1, 2, side::sell}, 10).second);
+    BOOST_TEST(!m.try_emplace(order_key{1, 2, side::sell}, 20).second);
+    BOOST_TEST(m.insert(std::make_pair(order_key{1, 1, side::buy}, no_default_value{30})).second);
+    BOOST_TEST_EQ(m.find(order_key{1, 2, side::sell})->second.value, 10);
+    BOOST_TEST_EQ(m.begin()->second.value, 30);
+
+    const auto& cm = m;
+    boost::pfr::btree_map<order_key, no_default_value>::const_iterator it = m.begin();
+    BOOST_TEST(it == cm.begin());
+    BOOST_TEST(cm.find(order_key{1, 1, side::buy}) == it);
+
+    boost::pfr::btree_map<std::uint64_t, std::string> strings;
+    strings[~0ull] = "max";
+    strings[0] = "min";
+    strings[1ull << 63] = "middle";
+    BOOST_TEST_EQ(strings.begin()->second, "min");
+    BOOST_TEST_EQ(strings.lower_bound(1)->second, "middle");
+    BOOST_TEST_EQ(strings.upper_bound(1ull << 63)->second, "max");
+
+    // Throwing constructors of values leave the map unchanged
+    boost::pfr::btree_map<int, throwing_value, 4> t;
+    BOOST_TEST_THROWS(t.try_emplace(1, -1), std::runtime_error);
+    BOOST_TEST(t.empty());
+    BOOST_TEST(t.begin() == t.end());
+    BOOST_TEST(t.find(1) == t.end());
+    for (int i = 0; i < 10; ++i) {
+        BOOST_TEST(t.try_emplace(i, i).second);
+        BOOST_TEST_THROWS(t.try_emplace(i + 100, -1), std::runtime_error);
+    }
+    BOOST_TEST_EQ(t.size(), 10u);
+    int expected_value = 0;
+    for (const auto& v : t) {
+        BOOST_TEST_EQ(v.second.value, expected_value++);
+    }
+    BOOST_TEST_EQ(expected_value, 10);
+
+    return boost::report_errors();
+}
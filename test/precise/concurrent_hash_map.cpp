@@ -0,0 +1,280 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/concurrent_hash_map.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct order_id {
+    std::uint32_t session;
+    std::uint32_t seq;
+};
+
+struct named_key {
+    std::string name;
+    int id;
+};
+
+// No padding, but the field has its own equality that differs from the bitwise one
+struct ticker_char {
+    char c;
+
+    bool operator==(ticker_char other) const noexcept {
+        return (c | 0x20) == (other.c | 0x20);
+    }
+};
+
+struct ticker_key {
+    ticker_char first;
+    ticker_char second;
+};
+
+struct ticker_hash {
+    std::size_t operator()(const ticker_key& k) const noexcept {
+        return static_cast<std::size_t>((k.first.c | 0x20) * 131 + (k.second.c | 0x20));
+    }
+};
+
+// Input range of keys created on dereference: key `i` is {"alpha", 1} if i % 20 == 1, {"beta", 2} if i % 20 == 2
+struct generated_keys {
+    struct iterator {
+        int i;
+
+        named_key operator*() const {
+            return i % 20 == 1 ? named_key{"alpha", 1} : named_key{i % 20 == 2 ? "beta" : "none", i % 20};
+        }
+        iterator& operator++() { ++i; return *this; }
+        bool operator!=(const iterator& other) const { return i != other.i; }
+    };
+
+    int size;
+
+    iterator begin() const { return iterator{0}; }
+    iterator end() const { return iterator{size}; }
+};
+
+struct state {
+    std::uint64_t version;
+    std::uint64_t checksum;     // function of key and version, torn values would not match
+};
+
+std::uint64_t checksum_of(const order_id& k, std::uint64_t version) {
+    return (static_cast<std::uint64_t>(k.session) << 32 | k.seq) * 31 + version;
+}
+
+void test_single_thread() {
+    boost::pfr::concurrent_hash_map<order_id, int> m;
+    std::map<std::pair<std::uint32_t, std::uint32_t>, int> expected;
+    BOOST_TEST(m.empty());
+
+    for (std::uint32_t i = 0; i < 20000; ++i) {
+        const order_id k{i % 7, (i * 7919) % 5003};
+        const auto ek = std::make_pair(k.session, k.seq);
+        switch (i % 4) {
+        case 0:
+        case 1:
+            BOOST_TEST_EQ(m.insert(k, static_cast<int>(i)), expected.emplace(ek, static_cast<int>(i)).second);
+            break;
+        case 2: {
+            const bool inserted = (expected.find(ek) == expected.end());
+            expected[ek] = static_cast<int>(i);
+            BOOST_TEST_EQ(m.insert_or_assign(k, static_cast<int>(i)), inserted);
+            break;
+        }
+        default:
+            BOOST_TEST_EQ(m.erase(k), expected.erase(ek) == 1);
+        }
+    }
+
+    BOOST_TEST_EQ(m.size(), expected.size());
+    for (std::uint32_t session = 0; session < 7; ++session) {
+        for (std::uint32_t seq = 0; seq < 5003; ++seq) {
+            const auto it = expected.find(std::make_pair(session, seq));
+            int value = -1;
+            BOOST_TEST_EQ(m.find(order_id{session, seq}, value), it != expected.end());
+            if (it != expected.end()) {
+                BOOST_TEST_EQ(value, it->second);
+            }
+        }
+    }
+
+    m.clear();
+    BOOST_TEST(m.empty());
+    BOOST_TEST(!m.contains(order_id{0, 0}));
+    BOOST_TEST(m.insert(order_id{0, 0}, 1));
+    BOOST_TEST(m.contains(order_id{0, 0}));
+}
+
+void test_non_bitwise_key() {
+    boost::pfr::concurrent_hash_map<named_key, std::string> m;
+    BOOST_TEST(m.insert(named_key{"alpha", 1}, "a1"));
+    BOOST_TEST(m.insert(named_key{"alpha", 2}, "a2"));
+    BOOST_TEST(!m.insert(named_key{"alpha", 1}, "other"));
+
+    std::string value;
+    BOOST_TEST(m.find(named_key{"alpha", 1}, value));
+    BOOST_TEST_EQ(value, "a1");
+    BOOST_TEST(!m.find(named_key{"beta", 1}, value));
+
+    BOOST_TEST(!m.insert_or_assign(named_key{"alpha", 2}, "b2"));
+    BOOST_TEST(m.visit(named_key{"alpha", 2}, [](const std::string& v) { BOOST_TEST_EQ(v, "b2"); }));
+    BOOST_TEST(m.erase(named_key{"alpha", 2}));
+    BOOST_TEST(!m.erase(named_key{"alpha", 2}));
+    BOOST_TEST_EQ(m.size(), 1u);
+
+    // boost::pfr::equal_to uses the equality of the fields even if the key could be compared bitwise
+    boost::pfr::concurrent_hash_map<ticker_key, int, ticker_hash> tickers;
+    BOOST_TEST(tickers.insert(ticker_key{{'A'}, {'b'}}, 1));
+    BOOST_TEST(!tickers.insert(ticker_key{{'a'}, {'B'}}, 2));
+    BOOST_TEST(tickers.contains(ticker_key{{'a'}, {'b'}}));
+}
+
+void test_batch() {
+    boost::pfr::concurrent_hash_map<order_id, int> m;
+    for (std::uint32_t i = 0; i < 5000; i += 2) {
+        m.insert(order_id{i % 3, i}, static_cast<int>(i));
+    }
+
+    std::vector<order_id> keys;
+    for (std::uint32_t i = 0; i < 1003; ++i) {
+        keys.push_back(order_id{i % 3, i * 5});
+    }
+
+    std::vector<std::pair<bool, int>> results;
+    m.lookup_batch(keys, std::back_inserter(results));
+    BOOST_TEST_EQ(results.size(), keys.size());
+
+    std::size_t expected_found = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        int value = -1;
+        const bool found = m.find(keys[i], value);
+        expected_found += found;
+        BOOST_TEST_EQ(results[i].first, found);
+        BOOST_TEST_EQ(results[i].second, found ? value : 0);
+    }
+
+    std::vector<int> visited(keys.size(), -1);
+    BOOST_TEST_EQ(m.visit_batch(keys, [&visited](std::size_t i, int v) { visited[i] = v; }), expected_found);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        BOOST_TEST_EQ(visited[i], results[i].first ? results[i].second : -1);
+    }
+
+    BOOST_TEST_EQ(m.visit_batch(std::vector<order_id>{}, [](std::size_t, int) { BOOST_TEST(false); }), 0u);
+
+    boost::pfr::concurrent_hash_map<named_key, std::string> names;
+    names.insert(named_key{"alpha", 1}, "a1");
+    names.insert(named_key{"beta", 2}, "b2");
+    const named_key lookups[] = {{"beta", 2}, {"gamma", 3}, {"alpha", 1}};
+    std::vector<std::pair<bool, std::string>> found_names;
+    names.lookup_batch(lookups, std::back_inserter(found_names));
+    BOOST_TEST_EQ(found_names.size(), 3u);
+    BOOST_TEST(found_names[0] == std::make_pair(true, std::string("b2")));
+    BOOST_TEST(found_names[1] == std::make_pair(false, std::string()));
+    BOOST_TEST(found_names[2] == std::make_pair(true, std::string("a1")));
+
+    // Range that produces temporary keys
+    std::vector<int> visited_names;
+    BOOST_TEST_EQ(names.visit_batch(generated_keys{40}, [&visited_names](std::size_t i, const std::string&) {
+        visited_names.push_back(static_cast<int>(i));
+    }), 4u);
+    std::sort(visited_names.begin(), visited_names.end());
+    BOOST_TEST(visited_names == std::vector<int>({1, 2, 21, 22}));
+}
+
+void test_concurrent() {
+    constexpr std::uint32_t keys = 2000;
+    constexpr int writers = 2;
+    constexpr int readers = 2;
+
+    boost::pfr::concurrent_hash_map<order_id, state> m;
+    std::atomic<bool> stop{false};
+    std::atomic<std::size_t> errors{0};
+    std::atomic<std::size_t> found{0};
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&m, w]() {
+            for (std::uint64_t version = 1; version <= 20; ++version) {
+                for (std::uint32_t i = static_cast<std::uint32_t>(w); i < keys; i += writers) {
+                    const order_id k{i % 3, i};
+                    if ((i + version) % 5 == 0) {
+                        m.erase(k);
+                    } else {
+                        m.insert_or_assign(k, state{version, checksum_of(k, version)});
+                    }
+                }
+            }
+        });
+    }
+
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            std::vector<order_id> batch;
+            for (std::uint32_t i = 0; i < keys; ++i) {
+                batch.push_back(order_id{i % 3, i});
+            }
+
+            while (!stop.load()) {
+                if (r % 2) {
+                    m.visit_batch(batch, [&](std::size_t i, const state& s) {
+                        found.fetch_add(1, std::memory_order_relaxed);
+                        if (s.checksum != checksum_of(batch[i], s.version)) {
+                            errors.fetch_add(1);
+                        }
+                    });
+                    continue;
+                }
+
+                for (std::uint32_t i = 0; i < keys; ++i) {
+                    const order_id k{i % 3, i};
+                    state s{};
+                    if (m.find(k, s)) {
+                        found.fetch_add(1, std::memory_order_relaxed);
+                        if (s.checksum != checksum_of(k, s.version)) {
+                            errors.fetch_add(1);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    for (int w = 0; w < writers; ++w) {
+        threads[static_cast<std::size_t>(w)].join();
+    }
+    stop.store(true);
+    for (std::size_t t = writers; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    BOOST_TEST_EQ(errors.load(), 0u);
+
+    // Final state is deterministic: the last version of each key
+    for (std::uint32_t i = 0; i < keys; ++i) {
+        const order_id k{i % 3, i};
+        state s{};
+        BOOST_TEST_EQ(m.find(k, s), (i + 20) % 5 != 0);
+        if ((i + 20) % 5 != 0) {
+            BOOST_TEST_EQ(s.version, 20u);
+        }
+    }
+}
+
+int main() {
+    test_single_thread();
+    test_non_bitwise_key();
+    test_batch();
+    test_concurrent();
+
+    return boost::report_errors();
+}
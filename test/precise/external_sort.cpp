@@ -0,0 +1,140 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+
+#if !defined(_WIN32)
+
+#include <boost/pfr/precise/external_sort.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+struct trade {
+    std::uint32_t symbol;
+    std::int64_t ts;
+    double price;
+    std::uint32_t seq;      // position in the input, checks stability
+};
+
+const char* const in_path = "pfr_external_sort_in.bin";
+const char* const out_path = "pfr_external_sort_out.bin";
+
+template <class T>
+void write_records(const char* p, const std::vector<T>& records) {
+    std::ofstream f(p, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(T)));
+}
+
+template <class T>
+std::vector<T> read_records(const char* p) {
+    std::ifstream f(p, std::ios::binary);
+    const std::string data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    std::vector<T> records(data.size() / sizeof(T));
+    std::copy(data.begin(), data.end(), reinterpret_cast<char*>(records.data()));
+    return records;
+}
+
+template <class Less>
+void test_sorted(const std::vector<trade>& input, Less less) {
+    std::vector<trade> expected = input;
+    std::stable_sort(expected.begin(), expected.end(), less);
+
+    const std::vector<trade> sorted = read_records<trade>(out_path);
+    BOOST_TEST_EQ(sorted.size(), expected.size());
+    BOOST_TEST(std::equal(sorted.begin(), sorted.end(), expected.begin(), expected.end(), [](const trade& x, const trade& y) {
+        return x.seq == y.seq;
+    }));
+}
+
+bool sort_throws(const char* p) {
+    try {
+        boost::pfr::external_sort<trade, 0, 1>(p, out_path, 1 << 20);
+    } catch (const std::exception&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    std::mt19937 gen(42);
+    std::vector<trade> trades(50000);
+    for (std::size_t i = 0; i < trades.size(); ++i) {
+        trades[i] = trade{
+            static_cast<std::uint32_t>(gen() % 50),
+            static_cast<std::int64_t>(gen() % 1000) - 500,
+            (gen() % 2000) * 0.25,
+            static_cast<std::uint32_t>(i)
+        };
+    }
+    write_records(in_path, trades);
+
+    const auto by_symbol_ts = [](const trade& x, const trade& y) {
+        return x.symbol < y.symbol || (x.symbol == y.symbol && x.ts < y.ts);
+    };
+    const auto by_price = [](const trade& x, const trade& y) { return x.price < y.price; };
+
+    // Files of the user near the output are not touched
+    const std::string neighbour_path = std::string(out_path) + ".runs";
+    std::ofstream(neighbour_path) << "user data";
+
+    // Normalized keys, 1 run and many runs
+    boost::pfr::external_sort<trade, 0, 1>(in_path, out_path, std::size_t(1) << 24);
+    test_sorted(trades, by_symbol_ts);
+    boost::pfr::external_sort<trade, 0, 1>(in_path, out_path, 64 * 1024);
+    test_sorted(trades, by_symbol_ts);
+    boost::pfr::external_sort<trade, 0, 1>(in_path, out_path, 1000);
+    test_sorted(trades, by_symbol_ts);
+
+    // Floating point key is compared through the reflection
+    boost::pfr::external_sort<trade, 2>(in_path, out_path, 100 * 1024);
+    test_sorted(trades, by_price);
+
+    // All the fields
+    boost::pfr::external_sort<trade>(in_path, out_path, 100 * 1024);
+    test_sorted(trades, [](const trade& x, const trade& y) {
+        return std::tie(x.symbol, x.ts, x.price, x.seq) < std::tie(y.symbol, y.ts, y.price, y.seq);
+    });
+
+    std::string neighbour;
+    std::getline(std::ifstream(neighbour_path), neighbour);
+    BOOST_TEST_EQ(neighbour, "user data");
+    std::remove(neighbour_path.c_str());
+
+    // In place
+    boost::pfr::external_sort<trade, 1>(in_path, in_path, 64 * 1024);
+    std::rename(in_path, out_path);
+    test_sorted(trades, [](const trade& x, const trade& y) { return x.ts < y.ts; });
+
+    // Empty and broken inputs
+    write_records(in_path, std::vector<trade>());
+    boost::pfr::external_sort<trade, 0, 1>(in_path, out_path, 1000);
+    BOOST_TEST(read_records<trade>(out_path).empty());
+
+    std::ofstream(in_path, std::ios::binary | std::ios::trunc) << "not a multiple of the record size";
+    BOOST_TEST(sort_throws(in_path));
+    BOOST_TEST(sort_throws("pfr_external_sort_missing.bin"));
+
+    std::remove(in_path);
+    std::remove(out_path);
+
+    return boost::report_errors();
+}
+
+#else
+
+int main() {
+    return boost::report_errors();
+}
+
+#endif
@@ -0,0 +1,93 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/eytzinger_index.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+struct instrument {
+    int id;
+    short venue;
+    double price;
+};
+
+template <class Index>
+void test_against_lower_bound(const std::vector<instrument>& sorted, const Index& index) {
+    BOOST_TEST_EQ(index.size(), sorted.size());
+
+    for (int id = -1; id < static_cast<int>(sorted.size() * 2 + 2); ++id) {
+        const auto it = std::lower_bound(sorted.begin(), sorted.end(), id, [](const instrument& v, int key) {
+            return v.id < key;
+        });
+        const instrument* p = index.lower_bound(id);
+
+        if (it == sorted.end()) {
+            BOOST_TEST(!p);
+            BOOST_TEST(!index.find(id));
+            continue;
+        }
+
+        BOOST_TEST(p);
+        if (!p) continue;
+        BOOST_TEST_EQ(p->id, it->id);
+        BOOST_TEST_EQ(p->venue, it->venue);  // first of the equal keys
+        BOOST_TEST_EQ(!!index.find(id), it->id == id);
+    }
+}
+
+template <class KeyStorage>
+void test_sizes() {
+    for (std::size_t size = 0; size < 70; ++size) {
+        std::vector<instrument> sorted;
+        for (std::size_t i = 0; i < size; ++i) {
+            // Every third id is duplicated, odd ids are missing
+            sorted.push_back(instrument{static_cast<int>(i / 3 * 2 * 3 + i % 3 / 2 * 2), static_cast<short>(i), i * 0.5});
+        }
+
+        // Shuffle, keeping the relative order of the values with equal ids
+        std::vector<instrument> input = sorted;
+        std::stable_sort(input.begin(), input.end(), [](const instrument& lhs, const instrument& rhs) {
+            return lhs.id % 7 < rhs.id % 7;
+        });
+
+        boost::pfr::basic_eytzinger_index<instrument, KeyStorage, 0> index(input.begin(), input.end());
+        test_against_lower_bound(sorted, index);
+    }
+}
+
+int main() {
+    test_sizes<boost::pfr::extracted_keys>();
+    test_sizes<boost::pfr::inline_keys>();
+
+    // Composite key and the whole structure as key
+    std::vector<instrument> v {
+        {3, 1, 1.0}, {1, 2, 5.0}, {3, 0, 2.0}, {2, 7, 0.5}, {1, 2, 4.0}
+    };
+
+    boost::pfr::eytzinger_index<instrument, 0, 1> by_id_venue(v.begin(), v.end());
+    static_assert(std::is_same<decltype(by_id_venue)::key_type, std::tuple<int, short>>::value, "");
+    BOOST_TEST_EQ(by_id_venue.find(3, short{0})->price, 2.0);
+    BOOST_TEST_EQ(by_id_venue.find(std::make_tuple(3, short{1}))->price, 1.0);
+    BOOST_TEST_EQ(by_id_venue.find(1, short{2})->price, 5.0);     // first of the equal keys in input order
+    BOOST_TEST(!by_id_venue.find(2, short{0}));
+    BOOST_TEST_EQ(by_id_venue.lower_bound(2, short{0})->venue, 7);
+    BOOST_TEST(!by_id_venue.lower_bound(3, short{2}));
+
+    boost::pfr::basic_eytzinger_index<instrument, boost::pfr::inline_keys> by_all{std::vector<instrument>(v)};
+    BOOST_TEST_EQ(by_all.size(), 5u);
+    BOOST_TEST_EQ(by_all.find(1, short{2}, 4.0)->price, 4.0);
+    BOOST_TEST(!by_all.find(1, short{2}, 4.5));
+    BOOST_TEST_EQ(by_all.lower_bound(1, short{2}, 4.5)->price, 5.0);
+
+    boost::pfr::eytzinger_index<instrument, 2> empty;
+    BOOST_TEST(empty.empty());
+    BOOST_TEST(!empty.lower_bound(0.0));
+    BOOST_TEST(!empty.find(0.0));
+
+    return boost::report_errors();
+}
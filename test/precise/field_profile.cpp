@@ -0,0 +1,179 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#define BOOST_PFR_FIELD_PROFILE 1
+
+#include <boost/pfr/field_profile.hpp>
+#include <boost/pfr/precise/core.hpp>
+#include <boost/pfr/flat/core.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <typeindex>
+#include <vector>
+
+struct order {
+    int id;
+    double price;
+    unsigned qty;
+    long long padding_candidate;
+};
+
+struct point {
+    int x, y, z;
+};
+
+#if BOOST_PFR_USE_CPP17 && defined(BOOST_PFR_DETAIL_IS_CONSTANT_EVALUATED)
+// Profiling keeps get() usable in constant expressions
+constexpr point constexpr_point{1, 2, 3};
+static_assert(boost::pfr::get<0>(constexpr_point) == 1, "");
+static_assert(boost::pfr::get<2>(constexpr_point) == 3, "");
+#endif
+
+const boost::pfr::field_profile_entry* find_entry(const std::vector<boost::pfr::field_profile_entry>& profile, std::type_index type, bool flat) {
+    for (const auto& e : profile) {
+        if (e.type == type && e.flat == flat) {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+void test_get() {
+    boost::pfr::field_profile_reset();
+
+    std::vector<order> orders(100, order{1, 2.0, 3, 4});
+    double total = 0;
+    for (const order& o : orders) {
+        total += boost::pfr::get<1>(o) * boost::pfr::get<2>(o);
+    }
+    for (std::size_t i = 0; i < orders.size(); i += 10) {
+        total += boost::pfr::get<0>(orders[i]);
+        boost::pfr::get<1>(orders[i]) = 0;     // non-const access
+    }
+    BOOST_TEST_EQ(total, 610.0);
+
+    const auto profile = boost::pfr::field_profile();
+    const auto* e = find_entry(profile, typeid(order), false);
+    BOOST_TEST(e != nullptr);
+    if (!e) {
+        return;
+    }
+
+    BOOST_TEST_EQ(e->accesses.size(), 4u);
+    BOOST_TEST_EQ(e->accesses[0], 10u);
+    BOOST_TEST_EQ(e->accesses[1], 110u);
+    BOOST_TEST_EQ(e->accesses[2], 100u);
+    BOOST_TEST_EQ(e->accesses[3], 0u);
+    BOOST_TEST_EQ(e->visits, 110u);
+    BOOST_TEST_EQ(e->co_accesses[1][2], 100u);
+    BOOST_TEST_EQ(e->co_accesses[2][1], 100u);
+    BOOST_TEST_EQ(e->co_accesses[0][1], 10u);
+    BOOST_TEST_EQ(e->co_accesses[0][2], 0u);
+    BOOST_TEST_EQ(e->co_accesses[1][1], 110u);
+    BOOST_TEST(e->co_accesses[0][3] == 0u);
+}
+
+void test_for_each_field_and_flat() {
+    boost::pfr::field_profile_reset();
+
+    point p{1, 2, 3};
+    int sum = 0;
+    boost::pfr::for_each_field(p, [&sum](int v) { sum += v; });
+    boost::pfr::flat_for_each_field(p, [&sum](int v) { sum += v; });
+    sum += boost::pfr::flat_get<2>(p);
+    BOOST_TEST_EQ(sum, 15);
+
+    const auto profile = boost::pfr::field_profile();
+    const auto* precise = find_entry(profile, typeid(point), false);
+    const auto* flat = find_entry(profile, typeid(point), true);
+    BOOST_TEST(precise && flat);
+    if (!precise || !flat) {
+        return;
+    }
+
+    BOOST_TEST_EQ(precise->visits, 1u);
+    BOOST_TEST_EQ(precise->accesses[0], 1u);
+    BOOST_TEST_EQ(precise->co_accesses[0][2], 1u);
+    BOOST_TEST_EQ(flat->visits, 1u);       // flat_get continues the visit of flat_for_each_field
+    BOOST_TEST_EQ(flat->accesses[2], 2u);
+    BOOST_TEST_EQ(flat->co_accesses[1][2], 1u);
+}
+
+void test_threads_and_report() {
+    boost::pfr::field_profile_reset();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([]() {
+            const order o{1, 2.0, 3, 4};
+            long long s = 0;
+            for (int i = 0; i < 1000; ++i) {
+                s += boost::pfr::get<3>(o);
+            }
+            BOOST_TEST_EQ(s, 4000);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    const auto profile = boost::pfr::field_profile();
+    const auto* e = find_entry(profile, typeid(order), false);
+    BOOST_TEST(e != nullptr);
+    if (e) {
+        BOOST_TEST_EQ(e->accesses[3], 3000u);
+        BOOST_TEST_EQ(e->visits, 3u);
+    }
+
+    std::ostringstream report;
+    boost::pfr::field_profile_report(report);
+    const std::string s = report.str();
+    BOOST_TEST(s.find("order (precise): 3 visits, 3000 accesses") != std::string::npos);
+    BOOST_TEST(s.find("      #3       3000  100.0%  100.0%") != std::string::npos);
+}
+
+void test_finished_threads() {
+    boost::pfr::field_profile_reset();
+
+    const auto tables_count = []() {
+        auto& registry = boost::pfr::detail::field_profile_registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        return registry.tables.size();
+    };
+
+    // Warms up the table of this thread, the object is not at the address of any object of the other tests
+    static const point p{1, 2, 3};
+    BOOST_TEST_EQ(boost::pfr::get<1>(p), 2);
+    const std::size_t before = tables_count();
+
+    for (int t = 0; t < 50; ++t) {
+        std::thread([]() {
+            BOOST_TEST_EQ(boost::pfr::get<1>(p), 2);
+            BOOST_TEST_EQ(boost::pfr::get<1>(p), 2);
+        }).join();
+    }
+    BOOST_TEST_EQ(tables_count(), before + 1);   // all the threads used the same table one after another
+
+    const auto profile = boost::pfr::field_profile();
+    const auto* e = find_entry(profile, typeid(point), false);
+    BOOST_TEST(e != nullptr);
+    if (e) {
+        BOOST_TEST_EQ(e->accesses[1], 101u);
+        BOOST_TEST_EQ(e->visits, 51u);            // next thread starts a new visit of the same object
+    }
+}
+
+int main() {
+    test_get();
+    test_for_each_field_and_flat();
+    test_threads_and_report();
+    test_finished_threads();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/detail/config.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#if BOOST_PFR_USE_CPP17
+
+#include <boost/pfr/precise/fix.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+enum class side : char { buy = '1', sell = '2' };
+enum class ord_type : int { market = 1, limit = 2 };
+
+struct new_order {
+    char msg_type;
+    std::string_view cl_ord_id;
+    std::string_view symbol;
+    side s;
+    double price;
+    std::int64_t qty;
+    ord_type type;
+    bool locate_reqd;
+    int internal_id;    // not sent
+};
+
+template <> struct boost::pfr::fix_tags<new_order> : boost::pfr::fix_tag_list<35, 11, 55, 54, 44, 38, 40, 114, 0> {};
+
+struct many_tags {
+    int f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19;
+    std::string text;
+};
+
+template <> struct boost::pfr::fix_tags<many_tags> : boost::pfr::fix_tag_list<
+    1, 6, 11, 14, 15, 17, 31, 32, 37, 38, 39, 40, 44, 54, 55, 59, 60, 99, 150, 151, 58
+> {};
+
+std::string with_checksum(std::string body) {
+    unsigned sum = 0;
+    for (char c : body) {
+        sum += static_cast<unsigned char>(c);
+    }
+    const unsigned checksum = sum % 256;
+    body += "10=";
+    body += static_cast<char>('0' + checksum / 100);
+    body += static_cast<char>('0' + checksum / 10 % 10);
+    body += static_cast<char>('0' + checksum % 10);
+    body += '\x01';
+    return body;
+}
+
+void test_decode() {
+    const std::string msg = with_checksum(
+        "8=FIX.4.4\x01" "9=70\x01" "35=D\x01" "49=SENDER\x01" "11=order-1\x01" "55=EURUSD\x01" "54=2\x01"
+        "44=1.0825\x01" "38=1000000\x01" "40=2\x01" "114=Y\x01"
+    );
+
+    const std::optional<new_order> o = boost::pfr::fix_decode<new_order>(msg);
+    BOOST_TEST(o.has_value());
+    BOOST_TEST_EQ(o->msg_type, 'D');
+    BOOST_TEST_EQ(o->cl_ord_id, "order-1");
+    BOOST_TEST_EQ(o->symbol, "EURUSD");
+    BOOST_TEST(o->s == side::sell);
+    BOOST_TEST_EQ(o->price, 1.0825);
+    BOOST_TEST_EQ(o->qty, 1000000);
+    BOOST_TEST(o->type == ord_type::limit);
+    BOOST_TEST(o->locate_reqd);
+    BOOST_TEST_EQ(o->internal_id, 0);
+
+    // Missing fields are value initialized, there may be no checksum
+    const std::optional<new_order> partial = boost::pfr::fix_decode<new_order>("55=USDJPY\x01" "38=5\x01");
+    BOOST_TEST(partial.has_value());
+    BOOST_TEST_EQ(partial->symbol, "USDJPY");
+    BOOST_TEST_EQ(partial->qty, 5);
+    BOOST_TEST_EQ(partial->msg_type, '\0');
+
+    // Malformed messages
+    BOOST_TEST(!boost::pfr::fix_decode<new_order>("38=5"));                 // no SOH
+    BOOST_TEST(!boost::pfr::fix_decode<new_order>("38=5x\x01"));            // not a number
+    BOOST_TEST(!boost::pfr::fix_decode<new_order>("=5\x01"));               // no tag
+    BOOST_TEST(!boost::pfr::fix_decode<new_order>("38\x01"));               // no '='
+    BOOST_TEST(!boost::pfr::fix_decode<new_order>("114=X\x01"));            // not a bool
+    BOOST_TEST(!boost::pfr::fix_decode<new_order>("35=DD\x01"));            // not a char
+    BOOST_TEST(!boost::pfr::fix_decode<new_order>("38=5\x01" "10=000\x01"));   // wrong checksum
+    BOOST_TEST(!boost::pfr::fix_decode<new_order>(with_checksum("38=5\x01") + "55=A\x01"));   // checksum is not the last
+}
+
+void test_roundtrip() {
+    const new_order o{'D', "cl-42", "GBPUSD", side::buy, 1.25, 300, ord_type::market, false, 17};
+
+    char buffer[256];
+    const std::string_view msg = boost::pfr::fix_encode(o, buffer, sizeof(buffer));
+    BOOST_TEST_EQ(
+        msg,
+        with_checksum("8=FIX.4.4\x01" "9=55\x01" "35=D\x01" "11=cl-42\x01" "55=GBPUSD\x01" "54=1\x01" "44=1.25\x01" "38=300\x01" "40=1\x01" "114=N\x01")
+    );
+
+    const std::optional<new_order> decoded = boost::pfr::fix_decode<new_order>(msg);
+    BOOST_TEST(decoded.has_value());
+    BOOST_TEST_EQ(decoded->cl_ord_id, o.cl_ord_id);
+    BOOST_TEST_EQ(decoded->symbol, o.symbol);
+    BOOST_TEST(decoded->s == o.s);
+    BOOST_TEST_EQ(decoded->price, o.price);
+    BOOST_TEST_EQ(decoded->qty, o.qty);
+    BOOST_TEST(decoded->type == o.type);
+    BOOST_TEST_EQ(decoded->locate_reqd, o.locate_reqd);
+
+    // Other begin string, empty strings are not written
+    const new_order empty_symbol{'F', "cl-43", "", side::sell, 0.5, 1, ord_type::limit, true, 0};
+    BOOST_TEST_EQ(
+        boost::pfr::fix_encode(empty_symbol, buffer, sizeof(buffer), "FIXT.1.1"),
+        with_checksum("8=FIXT.1.1\x01" "9=42\x01" "35=F\x01" "11=cl-43\x01" "54=2\x01" "44=0.5\x01" "38=1\x01" "40=2\x01" "114=Y\x01")
+    );
+
+    // Buffer is too small
+    for (std::size_t size = 0; size < msg.size(); size += 7) {
+        BOOST_TEST(boost::pfr::fix_encode(o, buffer, size).empty());
+    }
+    BOOST_TEST_EQ(boost::pfr::fix_encode(o, buffer, msg.size() + 8).size(), msg.size());
+}
+
+void test_many_tags() {
+    many_tags m{};
+    int i = 0;
+    boost::pfr::for_each_field(m, [&i](auto& f) {
+        if constexpr (std::is_same<std::remove_reference_t<decltype(f)>, int>::value) {
+            f = 1000 - (i++) * 37;
+        }
+    });
+    m.text = std::string(100, 'x');   // longer than SIMD block
+
+    char buffer[512];
+    const std::optional<many_tags> decoded = boost::pfr::fix_decode<many_tags>(boost::pfr::fix_encode(m, buffer, sizeof(buffer)));
+    BOOST_TEST(decoded.has_value());
+    BOOST_TEST_EQ(decoded->f0, m.f0);
+    BOOST_TEST_EQ(decoded->f7, m.f7);
+    BOOST_TEST_EQ(decoded->f19, m.f19);
+    BOOST_TEST_EQ(decoded->text, m.text);
+}
+
+int main() {
+    test_decode();
+    test_roundtrip();
+    test_many_tags();
+
+    return boost::report_errors();
+}
+
+#else // #if BOOST_PFR_USE_CPP17
+
+int main() {
+    return boost::report_errors();
+}
+
+#endif
@@ -0,0 +1,101 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/hashed.hpp>
+#include <boost/pfr/precise/concurrent_hash_map.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+struct order_key {
+    std::string symbol;
+    std::int32_t account;
+};
+
+static int hash_calls = 0;
+
+struct counting_hash {
+    std::size_t operator()(const order_key& k) const {
+        ++hash_calls;
+        return boost::pfr::hash<order_key>{}(k);
+    }
+};
+
+struct colliding_hash {
+    std::size_t operator()(const order_key&) const noexcept {
+        return 42;
+    }
+};
+
+int main() {
+    typedef boost::pfr::hashed<order_key, counting_hash> key_t;
+
+    // Hash is computed once
+    const key_t a(order_key{"MSFT", 1});
+    BOOST_TEST_EQ(hash_calls, 1);
+    const key_t b = a;
+    BOOST_TEST_EQ(hash_calls, 1);
+    BOOST_TEST(a == b);
+    BOOST_TEST_EQ(a.hash(), boost::pfr::hash<order_key>{}(order_key{"MSFT", 1}));
+    BOOST_TEST_EQ(std::hash<key_t>{}(a), a.hash());
+    BOOST_TEST_EQ(boost::pfr::hash<key_t>{}(a), a.hash());
+    BOOST_TEST_EQ(hash_calls, 1);
+    BOOST_TEST_EQ(a->symbol, "MSFT");
+    BOOST_TEST_EQ((*a).account, 1);
+
+    // Modification rehashes
+    key_t c = a;
+    c.modify([](order_key& k) { k.account = 2; });
+    BOOST_TEST_EQ(hash_calls, 2);
+    BOOST_TEST_EQ(c.value().account, 2);
+    BOOST_TEST_EQ(c.hash(), boost::pfr::hash<order_key>{}(order_key{"MSFT", 2}));
+    BOOST_TEST(a != c);
+    BOOST_TEST(!boost::pfr::equal_to<key_t>{}(a, c));
+
+    try {
+        c.modify([](order_key& k) { k.account = 1; throw std::runtime_error("failure"); });
+        BOOST_TEST(false);
+    } catch (const std::runtime_error&) {}
+    BOOST_TEST(a == c);
+
+    c = order_key{"AAPL", 1};
+    BOOST_TEST_EQ(c.hash(), boost::pfr::hash<order_key>{}(order_key{"AAPL", 1}));
+
+    // Equal hashes fall back to the fields
+    typedef boost::pfr::hashed<order_key, colliding_hash> colliding_t;
+    BOOST_TEST(colliding_t(order_key{"MSFT", 1}) == colliding_t(order_key{"MSFT", 1}));
+    BOOST_TEST(colliding_t(order_key{"MSFT", 1}) != colliding_t(order_key{"MSFT", 2}));
+
+    // Standard containers
+    hash_calls = 0;
+    std::unordered_map<key_t, int> positions;
+    std::unordered_set<key_t> seen;
+    for (int i = 0; i < 100; ++i) {
+        const key_t k(order_key{"SYM" + std::to_string(i % 10), i % 7});
+        positions[k] += i;
+        seen.insert(k);
+    }
+    BOOST_TEST_EQ(hash_calls, 100);
+    BOOST_TEST_EQ(positions.size(), 70u);
+    BOOST_TEST_EQ(seen.size(), 70u);
+    BOOST_TEST_EQ(positions.count(key_t(order_key{"SYM3", 3})), 1u);
+    BOOST_TEST_EQ(positions.count(key_t(order_key{"SYM3", 7})), 0u);
+
+    // Library containers
+    const auto k = boost::pfr::make_hashed(order_key{"IBM", 7});
+    boost::pfr::concurrent_hash_map<boost::pfr::hashed<order_key>, double> limits;
+    BOOST_TEST(limits.insert(k, 1.5));
+    BOOST_TEST(!limits.insert(boost::pfr::make_hashed(order_key{"IBM", 7}), 2.5));
+    double limit = 0;
+    BOOST_TEST(limits.find(k, limit));
+    BOOST_TEST_EQ(limit, 1.5);
+    BOOST_TEST(!limits.contains(boost::pfr::make_hashed(order_key{"IBM", 8})));
+
+    return boost::report_errors();
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/inline_record.hpp>
+#include <boost/pfr/flat/functors.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct fill {
+    double price;
+    unsigned qty;
+};
+
+struct leg {
+    std::string symbol;
+    int ratio;
+};
+
+struct order {
+    std::string symbol;
+    double price;
+    std::vector<fill> fills;
+    std::string venue;
+    unsigned qty;
+    leg hedge;
+};
+
+typedef boost::pfr::inline_record<order, 8> inline_order;
+
+static_assert(std::is_trivially_copyable<inline_order>::value, "");
+static_assert(std::is_same<decltype(std::declval<inline_order&>().get<0>()), boost::pfr::inline_string<8>&>::value, "");
+static_assert(std::is_same<decltype(std::declval<inline_order&>().get<1>()), double&>::value, "");
+static_assert(std::is_same<decltype(std::declval<inline_order&>().get<2>()), boost::pfr::inline_vector<fill, 8>&>::value, "");
+static_assert(std::is_same<decltype(std::declval<inline_order&>().get<5>()), boost::pfr::inline_record<leg, 8>&>::value, "");
+
+order make_order() {
+    return order{"AAPL", 189.5, {{189.5, 100}, {189.52, 50}}, "XNAS", 150, {"QQQ", -2}};
+}
+
+void test_round_trip() {
+    const order o = make_order();
+    const inline_order r = inline_order::from(o);
+    BOOST_TEST_EQ(r.get<0>().str(), "AAPL");
+    BOOST_TEST_EQ(r.get<0>().size(), 4u);
+    BOOST_TEST_EQ(r.get<1>(), 189.5);
+    BOOST_TEST_EQ(r.get<2>().size(), 2u);
+    BOOST_TEST_EQ(r.get<2>()[1].qty, 50u);
+    BOOST_TEST_EQ(r.get<3>().str(), "XNAS");
+    BOOST_TEST_EQ(r.get<4>(), 150u);
+    BOOST_TEST_EQ(r.get<5>().get<0>().str(), "QQQ");
+
+    const order back = r.to_value();
+    BOOST_TEST_EQ(back.symbol, o.symbol);
+    BOOST_TEST_EQ(back.price, o.price);
+    BOOST_TEST_EQ(back.fills.size(), 2u);
+    BOOST_TEST_EQ(back.fills[0].price, 189.5);
+    BOOST_TEST_EQ(back.fills[1].qty, 50u);
+    BOOST_TEST_EQ(back.venue, o.venue);
+    BOOST_TEST_EQ(back.qty, o.qty);
+    BOOST_TEST_EQ(back.hedge.symbol, "QQQ");
+    BOOST_TEST_EQ(back.hedge.ratio, -2);
+
+    // Capacity is used up to the last char
+    order full = o;
+    full.symbol = "12345678";
+    BOOST_TEST_EQ(inline_order::from(full).to_value().symbol, "12345678");
+}
+
+void test_memcpy() {
+    std::vector<inline_order> records;
+    for (unsigned i = 0; i < 10; ++i) {
+        order o = make_order();
+        o.qty = i;
+        o.fills.resize(i % 3);
+        records.push_back(inline_order::from(o));
+    }
+
+    std::vector<unsigned char> bytes(records.size() * sizeof(inline_order));
+    std::memcpy(bytes.data(), records.data(), bytes.size());
+
+    std::vector<inline_order> copy(records.size());
+    std::memcpy(copy.data(), bytes.data(), bytes.size());
+    for (unsigned i = 0; i < 10; ++i) {
+        const order o = copy[i].to_value();
+        BOOST_TEST_EQ(o.qty, i);
+        BOOST_TEST_EQ(o.fills.size(), i % 3);
+        BOOST_TEST_EQ(o.venue, "XNAS");
+    }
+
+    BOOST_TEST(std::memcmp(&records[1], &copy[1], sizeof(inline_order)) == 0);
+}
+
+struct quote {
+    std::string symbol;
+    int bid;
+    int ask;
+};
+
+void test_flat_functors() {
+    typedef boost::pfr::inline_record<quote, 7> inline_quote;
+    const inline_quote a = inline_quote::from(quote{"MSFT", 1, 2});
+    const inline_quote b = inline_quote::from(quote{"MSFT", 1, 2});
+    const inline_quote c = inline_quote::from(quote{"MSFX", 1, 2});
+
+    BOOST_TEST(boost::pfr::flat_equal_to<inline_quote>{}(a, b));
+    BOOST_TEST(!boost::pfr::flat_equal_to<inline_quote>{}(a, c));
+    BOOST_TEST(boost::pfr::flat_less<inline_quote>{}(a, c));
+    BOOST_TEST_EQ(boost::pfr::flat_hash<inline_quote>{}(a), boost::pfr::flat_hash<inline_quote>{}(b));
+
+    // Records without padding in the field values are bitwise equal
+    BOOST_TEST(std::memcmp(&a, &b, sizeof(inline_quote)) == 0);
+}
+
+void test_length_errors() {
+    order o = make_order();
+    o.venue = "123456789";
+    BOOST_TEST_THROWS(inline_order::from(o), std::length_error);
+
+    o = make_order();
+    o.fills.resize(9);
+    BOOST_TEST_THROWS(inline_order::from(o), std::length_error);
+
+    o = make_order();
+    o.hedge.symbol = "too long symbol";
+    BOOST_TEST_THROWS(inline_order::from(o), std::length_error);
+}
+
+int main() {
+    test_round_trip();
+    test_memcpy();
+    test_flat_functors();
+    test_length_errors();
+
+    return boost::report_errors();
+}
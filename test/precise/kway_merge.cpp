@@ -0,0 +1,139 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/kway_merge.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+struct tick {
+    std::int64_t ts;
+    std::uint32_t venue;
+    std::uint32_t seq;      // position in the venue feed
+};
+
+struct quote {
+    std::string symbol;
+    double price;
+};
+
+// Single pass range that generates `count` ticks of a venue
+class tick_generator {
+public:
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef tick value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const tick* pointer;
+        typedef const tick& reference;
+
+        iterator() = default;
+        explicit iterator(std::uint32_t venue) : current_{0, venue, 0} {}
+
+        const tick& operator*() const noexcept { return current_; }
+        iterator& operator++() noexcept {
+            current_.ts += current_.venue + 1;
+            ++current_.seq;
+            return *this;
+        }
+
+        bool operator==(const iterator& x) const noexcept { return current_.seq == x.current_.seq; }
+        bool operator!=(const iterator& x) const noexcept { return !(*this == x); }
+
+    private:
+        friend class tick_generator;
+        tick current_{};
+    };
+
+    tick_generator(std::uint32_t venue, std::uint32_t count)
+        : venue_(venue), count_(count)
+    {}
+
+    iterator begin() const { return iterator(venue_); }
+    iterator end() const {
+        iterator it;
+        it.current_.seq = count_;
+        return it;
+    }
+
+private:
+    std::uint32_t venue_;
+    std::uint32_t count_;
+};
+
+template <class Streams>
+std::vector<tick> merge_ticks(Streams& streams) {
+    std::vector<tick> result;
+    boost::pfr::kway_merge_by<0>(streams, [&result](const tick& t) { result.push_back(t); });
+    return result;
+}
+
+bool tick_less(const tick& x, const tick& y) {
+    return x.ts < y.ts;
+}
+
+int main() {
+    std::mt19937 gen(7);
+
+    // Streams of different sizes, empty streams and duplicate timestamps
+    for (std::uint32_t k : {0u, 1u, 2u, 3u, 7u, 37u}) {
+        std::vector<std::vector<tick>> feeds(k);
+        std::vector<tick> expected;
+        for (std::uint32_t v = 0; v < k; ++v) {
+            const std::uint32_t n = (v % 5 == 3 ? 0 : gen() % 300);
+            std::int64_t ts = 0;
+            for (std::uint32_t i = 0; i < n; ++i) {
+                ts += gen() % 3;
+                feeds[v].push_back(tick{ts, v, i});
+            }
+            expected.insert(expected.end(), feeds[v].begin(), feeds[v].end());
+        }
+        std::stable_sort(expected.begin(), expected.end(), tick_less);   // venues in order for equal timestamps
+
+        const std::vector<tick> merged = merge_ticks(feeds);
+        BOOST_TEST_EQ(merged.size(), expected.size());
+        BOOST_TEST(std::equal(merged.begin(), merged.end(), expected.begin(), expected.end(), [](const tick& x, const tick& y) {
+            return x.ts == y.ts && x.venue == y.venue && x.seq == y.seq;
+        }));
+    }
+
+    // Input ranges
+    std::vector<tick_generator> generators;
+    for (std::uint32_t v = 0; v < 5; ++v) {
+        generators.emplace_back(v, 1000);
+    }
+    const std::vector<tick> generated = merge_ticks(generators);
+    BOOST_TEST_EQ(generated.size(), 5000u);
+    BOOST_TEST(std::is_sorted(generated.begin(), generated.end(), tick_less));
+
+    // Keys compared through the reflection
+    std::vector<std::vector<quote>> books = {
+        {{"AAPL", 1.0}, {"IBM", 2.0}, {"MSFT", 3.0}},
+        {},
+        {{"AAPL", 0.5}, {"GOOG", 1.0}, {"MSFT", 2.0}, {"MSFT", 4.0}},
+        {{"IBM", 1.0}}
+    };
+    std::vector<std::string> symbols;
+    std::vector<double> prices;
+    boost::pfr::kway_merge_by<0>(books, [&](const quote& q) {
+        symbols.push_back(q.symbol);
+        prices.push_back(q.price);
+    });
+    BOOST_TEST((symbols == std::vector<std::string>{"AAPL", "AAPL", "GOOG", "IBM", "IBM", "MSFT", "MSFT", "MSFT"}));
+    BOOST_TEST((prices == std::vector<double>{1.0, 0.5, 1.0, 2.0, 1.0, 3.0, 2.0, 4.0}));
+
+    // All the fields
+    prices.clear();
+    boost::pfr::kway_merge_by<>(books, [&](const quote& q) { prices.push_back(q.price); });
+    BOOST_TEST((prices == std::vector<double>{0.5, 1.0, 1.0, 1.0, 2.0, 2.0, 3.0, 4.0}));
+
+    return boost::report_errors();
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/merge_join.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+struct our_order {
+    int account;
+    long order_id;
+    double price;
+};
+
+struct exchange_order {
+    long order_id;
+    int account;
+    double price;
+};
+
+// Single pass iterator that returns values by copy, like an iterator over a stream or a file would do
+template <class T>
+class generating_iterator {
+    const std::vector<T>* values_ = nullptr;
+    std::size_t index_ = 0;
+
+public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef T reference;
+
+    generating_iterator() = default;
+    generating_iterator(const std::vector<T>& values, std::size_t index) : values_(&values), index_(index) {}
+
+    T operator*() const { return (*values_)[index_]; }
+    generating_iterator& operator++() { ++index_; return *this; }
+    bool operator==(const generating_iterator& other) const { return index_ == other.index_; }
+    bool operator!=(const generating_iterator& other) const { return index_ != other.index_; }
+};
+
+int main() {
+    const std::vector<our_order> ours {
+        {1, 10, 1.0},
+        {1, 11, 2.0},
+        {1, 11, 2.5},   // duplicate, matched with the second duplicate on the right
+        {1, 11, 2.75},  // duplicate without a pair
+        {2, 5, 3.0},
+        {3, 1, 4.0},
+    };
+    const std::vector<exchange_order> theirs {
+        {11, 1, 2.0},
+        {11, 1, 2.5},
+        {1, 2, 9.0},
+        {5, 2, 3.0},
+        {1, 3, 4.5},
+        {2, 3, 5.0},
+    };
+
+    std::string log;
+    const auto on_match = [&log](const our_order& l, const exchange_order& r) {
+        log += "m" + std::to_string(l.order_id) + "," + std::to_string(static_cast<int>(r.price * 100)) + " ";
+    };
+    const auto on_left_only = [&log](const our_order& l) {
+        log += "l" + std::to_string(l.order_id) + " ";
+    };
+    const auto on_right_only = [&log](const exchange_order& r) {
+        log += "r" + std::to_string(r.order_id) + " ";
+    };
+
+    const std::string expected = "l10 m11,200 m11,250 l11 r1 m5,300 m1,450 r2 ";
+
+    boost::pfr::merge_join<boost::pfr::fields<0, 1>, boost::pfr::fields<1, 0>>(
+        ours.begin(), ours.end(), theirs.begin(), theirs.end(), on_match, on_left_only, on_right_only
+    );
+    BOOST_TEST_EQ(log, expected);
+
+    log.clear();
+    boost::pfr::merge_join<boost::pfr::fields<0, 1>, boost::pfr::fields<1, 0>>(
+        generating_iterator<our_order>(ours, 0), generating_iterator<our_order>(ours, ours.size()),
+        generating_iterator<exchange_order>(theirs, 0), generating_iterator<exchange_order>(theirs, theirs.size()),
+        on_match, on_left_only, on_right_only
+    );
+    BOOST_TEST_EQ(log, expected);
+
+    // Ranges, one of them is empty
+    log.clear();
+    boost::pfr::merge_join<boost::pfr::fields<0, 1>, boost::pfr::fields<1, 0>>(
+        ours, std::vector<exchange_order>{}, on_match, on_left_only, on_right_only
+    );
+    BOOST_TEST_EQ(log, "l10 l11 l11 l11 l5 l1 ");
+
+    // Whole structures as keys
+    struct wrapped { int v; };
+    const std::vector<wrapped> right {{2}, {3}, {4}};
+    int matches = 0, left_only = 0, right_only = 0;
+    boost::pfr::merge_join<boost::pfr::fields<>, boost::pfr::fields<>>(
+        right, right,
+        [&](const wrapped&, const wrapped&) { ++matches; },
+        [&](const wrapped&) { ++left_only; },
+        [&](const wrapped&) { ++right_only; }
+    );
+    BOOST_TEST_EQ(matches, 3);
+    BOOST_TEST_EQ(left_only + right_only, 0);
+
+    return boost::report_errors();
+}
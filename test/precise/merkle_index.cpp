@@ -0,0 +1,138 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/merkle_index.hpp>
+#include <boost/pfr/precise/functors.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstdint>
+#include <vector>
+
+struct position {
+    std::uint64_t account;
+    std::int64_t qty;
+    double price;
+};
+
+typedef boost::pfr::merkle_index<position, 16> index_t;
+
+std::vector<position> make_table(std::size_t n) {
+    std::vector<position> result;
+    for (std::size_t i = 0; i < n; ++i) {
+        result.push_back({i, static_cast<std::int64_t>(i % 7) - 3, 0.5 * static_cast<double>(i)});
+    }
+    return result;
+}
+
+bool same_levels(const index_t& a, const index_t& b) {
+    if (a.levels_count() != b.levels_count() || a.root_hash() != b.root_hash()) {
+        return false;
+    }
+    for (std::size_t l = 0; l < a.levels_count(); ++l) {
+        if (a.level(l) != b.level(l)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool diff_is(const index_t& a, const index_t& b, std::vector<boost::pfr::merkle_range> expected) {
+    const auto actual = a.diff(b);
+    const auto reverse = b.diff(a);
+    if (actual.size() != expected.size() || reverse.size() != expected.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        if (actual[i].first != expected[i].first || actual[i].last != expected[i].last
+            || reverse[i].first != expected[i].first || reverse[i].last != expected[i].last)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::vector<position> primary = make_table(1000);   // 63 blocks, the last one is partial
+    std::vector<position> replica = primary;
+    index_t primary_index(primary.begin(), primary.end());
+    index_t replica_index(replica.begin(), replica.end());
+
+    BOOST_TEST_EQ(primary_index.size(), 1000u);
+    BOOST_TEST_EQ(primary_index.level(0).size(), 63u);
+    BOOST_TEST_EQ(primary_index.levels_count(), 7u);
+    BOOST_TEST_EQ(primary_index.level(6).size(), 1u);
+    BOOST_TEST(same_levels(primary_index, replica_index));
+    BOOST_TEST(primary_index.diff(replica_index).empty());
+
+    // Incremental updates give the same hashes as indexing from scratch
+    const position changed[] = {{5, 1, 2.0}, {900, 0, -1.0}, {999, 4, 3.5}, {20, 1, 2.0}};
+    const std::size_t positions[] = {5, 900, 999, 20};
+    for (std::size_t i = 0; i < 4; ++i) {
+        primary_index.update(positions[i], primary[positions[i]], changed[i]);
+        primary[positions[i]] = changed[i];
+    }
+    BOOST_TEST(same_levels(primary_index, index_t(primary.begin(), primary.end())));
+    BOOST_TEST(primary_index.root_hash() != replica_index.root_hash());
+    BOOST_TEST(diff_is(primary_index, replica_index, {{0, 32}, {896, 912}, {992, 1000}}));
+
+    // Resynchronization
+    for (boost::pfr::merkle_range r : primary_index.diff(replica_index)) {
+        for (std::size_t i = r.first; i < r.last; ++i) {
+            replica_index.update(i, replica[i], primary[i]);
+            replica[i] = primary[i];
+        }
+    }
+    BOOST_TEST(same_levels(primary_index, replica_index));
+
+    // Reverting the change restores the hashes
+    primary_index.update(5, primary[5], make_table(6)[5]);
+    primary[5] = make_table(6)[5];
+    primary_index.update(5, primary[5], changed[0]);
+    primary[5] = changed[0];
+    BOOST_TEST(same_levels(primary_index, replica_index));
+
+    // Swapping records changes the hashes
+    std::vector<position> swapped = primary;
+    std::swap(swapped[100], swapped[101]);
+    BOOST_TEST(diff_is(index_t(swapped.begin(), swapped.end()), primary_index, {{96, 112}}));
+
+    // Appending grows the tree
+    for (std::size_t i = 1000; i < 1100; ++i) {
+        primary.push_back({i, 0, 0.0});
+        primary_index.push_back(primary.back());
+    }
+    BOOST_TEST_EQ(primary_index.size(), 1100u);
+    BOOST_TEST_EQ(primary_index.levels_count(), 8u);
+    BOOST_TEST(same_levels(primary_index, index_t(primary.begin(), primary.end())));
+    BOOST_TEST(diff_is(primary_index, replica_index, {{992, 1100}}));
+
+    // Tables of different sizes and empty tables
+    const index_t empty;
+    BOOST_TEST_EQ(empty.root_hash(), 0u);
+    BOOST_TEST(empty.diff(index_t()).empty());
+    BOOST_TEST(diff_is(empty, primary_index, {{0, 1100}}));
+
+    const std::vector<position> small(primary.begin(), primary.begin() + 20);
+    BOOST_TEST(diff_is(index_t(small.begin(), small.end()), primary_index, {{16, 1100}}));
+
+    index_t grown;
+    for (const position& p : small) {
+        grown.push_back(p);
+    }
+    BOOST_TEST(same_levels(grown, index_t(small.begin(), small.end())));
+
+    // Custom hash
+    typedef boost::pfr::merkle_index<position, 64, boost::pfr::hash<position>> fast_index_t;
+    fast_index_t fast(primary.begin(), primary.end());
+    fast_index_t fast_replica(primary.begin(), primary.end());
+    fast_replica.update(700, primary[700], position{});
+    const auto fast_diff = fast.diff(fast_replica);
+    BOOST_TEST_EQ(fast_diff.size(), 1u);
+    BOOST_TEST_EQ(fast_diff[0].first, 640u);
+    BOOST_TEST_EQ(fast_diff[0].last, 704u);
+
+    return boost::report_errors();
+}
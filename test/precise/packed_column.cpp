@@ -0,0 +1,121 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/packed_column.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <vector>
+
+struct trade {
+    std::int64_t timestamp;
+    std::uint32_t qty;
+    double price;
+    std::int16_t side;
+};
+
+template <class Int>
+void check_column(const std::vector<Int>& values, Int low, Int high) {
+    const boost::pfr::packed_column<Int> column(values.begin(), values.end());
+    BOOST_TEST_EQ(column.size(), values.size());
+
+    std::vector<Int> decoded;
+    column.decode(std::back_inserter(decoded));
+    BOOST_TEST(decoded == values);
+    for (std::size_t i = 0; i < values.size(); i += 7) {
+        BOOST_TEST_EQ(column[i], values[i]);
+    }
+
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (low <= values[i] && values[i] <= high) {
+            expected.push_back(i);
+        }
+    }
+    std::vector<std::size_t> selected;
+    column.select_between(low, high, std::back_inserter(selected));
+    BOOST_TEST(selected == expected);
+    BOOST_TEST_EQ(column.count_between(low, high), expected.size());
+}
+
+void test_widths() {
+    std::mt19937_64 gen(42);
+    for (unsigned bits = 0; bits <= 64; ++bits) {
+        const std::uint64_t mask = (bits == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1);
+        std::vector<std::uint64_t> values(1000);
+        for (auto& v : values) {
+            v = 1000000 + (gen() & mask);   // wraps around for 64 bits
+        }
+        const std::uint64_t low = 1000000 + (mask >> 2);
+        const std::uint64_t high = 1000000 + (mask >> 1);
+        check_column(values, low, high);
+    }
+}
+
+void test_signed() {
+    std::vector<std::int64_t> values;
+    for (std::int64_t i = -3000; i < 3000; i += 3) {
+        values.push_back(i * (i % 5 ? 1 : -1));
+    }
+    values.push_back((std::numeric_limits<std::int64_t>::min)());
+    values.push_back((std::numeric_limits<std::int64_t>::max)());
+    check_column(values, std::int64_t(-100), std::int64_t(250));
+    check_column(values, (std::numeric_limits<std::int64_t>::min)(), std::int64_t(0));
+
+    const std::vector<std::int8_t> small = {-128, 127, 0, -1, 1, 5, -5};
+    check_column(small, std::int8_t(-5), std::int8_t(5));
+}
+
+void test_sorted_timestamps() {
+    std::vector<trade> trades;
+    std::int64_t ts = 1500000000000000000;
+    for (std::uint32_t i = 0; i < 100000; ++i) {
+        ts += 1 + (i * 7919) % 1000;
+        trades.push_back(trade{ts, 100 + i % 50, 1.5, static_cast<std::int16_t>(i % 2 ? 1 : -1)});
+    }
+
+    const auto timestamps = boost::pfr::pack_field<0>(trades);
+    const auto quantities = boost::pfr::pack_field<1>(trades);
+    const auto sides = boost::pfr::pack_field<3>(trades);
+    BOOST_TEST_EQ(timestamps.size(), trades.size());
+    BOOST_TEST_EQ(timestamps[12345], trades[12345].timestamp);
+    BOOST_TEST_EQ(quantities[99999], trades[99999].qty);
+    BOOST_TEST_EQ(sides[3], 1);
+
+    // 17 bits per delta instead of 64, 6 bits instead of 32
+    BOOST_TEST(timestamps.memory_usage() * 3 < trades.size() * sizeof(std::int64_t));
+    BOOST_TEST(quantities.memory_usage() * 4 < trades.size() * sizeof(std::uint32_t));
+
+    const std::int64_t from = trades[5000].timestamp;
+    const std::int64_t to = trades[7000].timestamp;
+    BOOST_TEST_EQ(timestamps.count_between(from, to), 2001u);
+    BOOST_TEST_EQ(quantities.count_between(100, 109), 20000u);
+    BOOST_TEST_EQ(timestamps.count_between(to, from), 0u);
+
+    std::vector<std::size_t> selected;
+    timestamps.select_between(from, from, std::back_inserter(selected));
+    BOOST_TEST_EQ(selected.size(), 1u);
+    BOOST_TEST_EQ(selected.at(0), 5000u);
+}
+
+void test_empty() {
+    const std::vector<unsigned> values;
+    const boost::pfr::packed_column<unsigned> column(values.begin(), values.end());
+    BOOST_TEST(column.empty());
+    BOOST_TEST_EQ(column.count_between(0u, 100u), 0u);
+    check_column(std::vector<unsigned>{7u}, 0u, 10u);
+}
+
+int main() {
+    test_widths();
+    test_signed();
+    test_sorted_timestamps();
+    test_empty();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,169 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/partition_by_hash.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct trade {
+    int account;
+    int instrument;
+    double volume;
+};
+
+struct named {
+    std::string name;
+    int id;
+};
+
+struct unlucky_key {
+    int value;
+};
+
+namespace std {
+    template <> struct hash<unlucky_key> {
+        std::size_t operator()(unlucky_key k) const {
+            if (k.value == 13) {
+                throw std::runtime_error("unlucky key");
+            }
+            return static_cast<std::size_t>(k.value);
+        }
+    };
+}
+
+struct unlucky_record {
+    unlucky_key key;
+    int payload;
+};
+
+// Checks that `partitioned` is a permutation of `original`, that records with equal keys are in the same partition
+// and that records keep their order within a partition.
+template <class T, class Key, class Id>
+void check_partitions(const std::vector<T>& original, const std::vector<T>& partitioned, const std::vector<std::size_t>& offsets,
+                      std::size_t partitions, Key key, Id id)
+{
+    BOOST_TEST_EQ(offsets.size(), partitions + 1);
+    BOOST_TEST_EQ(offsets.front(), 0u);
+    BOOST_TEST_EQ(offsets.back(), original.size());
+
+    std::map<decltype(key(original[0])), std::size_t> partition_of_key;
+    std::vector<bool> seen(original.size());
+    for (std::size_t p = 0; p < partitions; ++p) {
+        BOOST_TEST(offsets[p] <= offsets[p + 1]);
+        for (std::size_t i = offsets[p]; i < offsets[p + 1]; ++i) {
+            const auto it = partition_of_key.emplace(key(partitioned[i]), p).first;
+            BOOST_TEST_EQ(it->second, p);
+
+            const std::size_t original_index = id(partitioned[i]);
+            BOOST_TEST(!seen[original_index]);
+            seen[original_index] = true;
+            if (i > offsets[p]) {
+                BOOST_TEST(id(partitioned[i - 1]) < original_index);
+            }
+        }
+    }
+}
+
+void test_trivially_copyable() {
+    std::vector<trade> trades;
+    for (int i = 0; i < 20000; ++i) {
+        trades.push_back(trade{(i * 7919) % 1000, i % 7, static_cast<double>(i)});
+    }
+    const auto key = [](const trade& t) { return t.account; };
+    const auto id = [](const trade& t) { return static_cast<std::size_t>(t.volume); };
+
+    for (std::size_t partitions : {1u, 2u, 7u, 64u, 1000u}) {
+        std::vector<trade> partitioned(trades.size());
+        const auto offsets = boost::pfr::partition_by_hash<0>(trades, partitions, partitioned.data());
+        check_partitions(trades, partitioned, offsets, partitions, key, id);
+
+        std::vector<trade> partitioned_mt(trades.size());
+        const auto offsets_mt = boost::pfr::partition_by_hash<0>(trades, partitions, partitioned_mt.data(), 4);
+        BOOST_TEST(offsets_mt == offsets);
+        for (std::size_t i = 0; i < trades.size(); ++i) {
+            BOOST_TEST_EQ(partitioned_mt[i].volume, partitioned[i].volume);
+        }
+
+        // Not a pointer: records are scattered without write combining
+        std::vector<trade> partitioned_it(trades.size());
+        const auto offsets_it = boost::pfr::partition_by_hash<0>(trades, partitions, partitioned_it.begin());
+        BOOST_TEST(offsets_it == offsets);
+        BOOST_TEST_EQ(partitioned_it.back().volume, partitioned.back().volume);
+    }
+
+    // Output that does not start on a cache line boundary
+    std::vector<trade> shifted(trades.size() + 1);
+    const auto offsets_shifted = boost::pfr::partition_by_hash<0>(trades, 64, shifted.data() + 1, 2);
+    BOOST_TEST(offsets_shifted == boost::pfr::partition_by_hash<0>(trades, 64, shifted.data()));
+    check_partitions(trades, std::vector<trade>(shifted.begin(), shifted.end() - 1), offsets_shifted, 64, key, id);
+
+    BOOST_TEST_THROWS(boost::pfr::partition_by_hash<0>(trades, 0, shifted.data()), std::invalid_argument);
+
+    // Partitioning by several fields
+    std::vector<trade> partitioned(trades.size());
+    const auto offsets = boost::pfr::partition_by_hash<0, 1>(trades, 16, partitioned.data(), 3);
+    check_partitions(trades, partitioned, offsets, 16, [](const trade& t) { return std::make_pair(t.account, t.instrument); }, id);
+}
+
+void test_generic() {
+    std::vector<named> v;
+    for (int i = 0; i < 500; ++i) {
+        v.push_back(named{"name" + std::to_string(i % 37), i});
+    }
+
+    std::vector<named> partitioned(v.size());
+    const auto offsets = boost::pfr::partition_by_hash<0>(v, 8, partitioned.data());
+    check_partitions(v, partitioned, offsets, 8,
+        [](const named& n) { return n.name; },
+        [](const named& n) { return static_cast<std::size_t>(n.id); }
+    );
+
+    std::vector<named> empty, empty_out;
+    const auto empty_offsets = boost::pfr::partition_by_hash<0>(empty, 4, empty_out.data(), 4);
+    BOOST_TEST((empty_offsets == std::vector<std::size_t>(5, 0)));
+}
+
+void test_lines_alignment() {
+    boost::pfr::detail::partition_lines lines(3);
+    for (std::size_t i = 0; i < 3; ++i) {
+        BOOST_TEST_EQ(reinterpret_cast<std::uintptr_t>(lines[i].bytes) % boost::pfr::detail::cache_line_size, 0u);
+    }
+
+    alignas(64) unsigned char buffer[128];
+    static_assert(sizeof(trade) == 16, "");
+    BOOST_TEST_EQ(boost::pfr::detail::records_to_line_boundary(buffer + 16, sizeof(trade), 8), 3u);
+    BOOST_TEST_EQ(boost::pfr::detail::records_to_line_boundary(buffer + 64, sizeof(trade), 8), 8u);
+    BOOST_TEST_EQ(boost::pfr::detail::records_to_line_boundary(buffer + 8, sizeof(trade), 8), 8u);
+}
+
+void test_exceptions() {
+    std::vector<unlucky_record> v;
+    for (int i = 0; i < 20000; ++i) {
+        v.push_back(unlucky_record{{i % 12}, i});
+    }
+    v[15000].key.value = 13;    // hashed by the last of the threads
+
+    std::vector<unlucky_record> partitioned(v.size());
+    BOOST_TEST_THROWS(boost::pfr::partition_by_hash<0>(v, 8, partitioned.data()), std::runtime_error);
+    BOOST_TEST_THROWS(boost::pfr::partition_by_hash<0>(v, 8, partitioned.data(), 4), std::runtime_error);
+
+    v[15000].key.value = 1;
+    const auto offsets = boost::pfr::partition_by_hash<0>(v, 8, partitioned.data(), 4);
+    BOOST_TEST_EQ(offsets.back(), v.size());
+}
+
+int main() {
+    test_trivially_copyable();
+    test_generic();
+    test_lines_alignment();
+    test_exceptions();
+
+    return boost::report_errors();
+}
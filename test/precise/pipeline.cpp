@@ -0,0 +1,174 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/pipeline.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#   include <boost/pfr/precise/uring_record.hpp>
+#endif
+
+struct raw_tick {
+    std::uint32_t instrument;
+    std::int64_t price_e2;
+    std::int32_t qty;
+};
+
+struct tick {
+    std::uint32_t instrument;
+    double notional;
+};
+
+struct point {
+    int x;
+    int y;
+};
+
+tick to_tick(const raw_tick& r) {
+    return tick{r.instrument, static_cast<double>(r.price_e2) / 100 * r.qty};
+}
+
+class counting_source {
+public:
+    explicit counting_source(std::uint32_t count) : count_(count) {}
+
+    bool operator()(raw_tick& r) {
+        if (i_ == count_) {
+            return false;
+        }
+        r = raw_tick{i_, static_cast<std::int64_t>(i_) * 25, static_cast<std::int32_t>(i_ % 7)};
+        ++i_;
+        return true;
+    }
+
+private:
+    std::uint32_t count_;
+    std::uint32_t i_ = 0;
+};
+
+template <class Sink>
+bool pipeline_throws(std::uint32_t count, Sink sink, std::uint32_t bad_instrument) {
+    try {
+        boost::pfr::pipeline<raw_tick, tick>(counting_source(count), [bad_instrument](const raw_tick& r) {
+            if (r.instrument == bad_instrument) {
+                throw std::runtime_error("bad record");
+            }
+            return to_tick(r);
+        }, sink, boost::pfr::pipeline_options{64, 2, 4});
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    // Order is kept with many small batches and several workers
+    for (unsigned workers : {1u, 3u}) {
+        std::vector<tick> out;
+        boost::pfr::pipeline_options options;
+        options.batch_size = 100;
+        options.workers = workers;
+        const boost::pfr::pipeline_stats stats = boost::pfr::pipeline<raw_tick, tick>(
+            counting_source(100050), to_tick, [&out](const tick& t) { out.push_back(t); }, options
+        );
+
+        BOOST_TEST_EQ(out.size(), 100050u);
+        bool ordered = true;
+        for (std::uint32_t i = 0; i < out.size(); ++i) {
+            const tick expected = to_tick(raw_tick{i, static_cast<std::int64_t>(i) * 25, static_cast<std::int32_t>(i % 7)});
+            ordered = ordered && out[i].instrument == i && out[i].notional == expected.notional;
+        }
+        BOOST_TEST(ordered);
+
+        BOOST_TEST_EQ(stats.read.records, 100050u);
+        BOOST_TEST_EQ(stats.transform.records, 100050u);
+        BOOST_TEST_EQ(stats.write.records, 100050u);
+        BOOST_TEST_EQ(stats.read.batches, 1001u);
+        BOOST_TEST_EQ(stats.write.batches, 1001u);
+        BOOST_TEST(stats.read.records_per_second() > 0);
+    }
+
+    // Empty source
+    std::size_t written = 0;
+    const auto empty = boost::pfr::pipeline<point>([](point&) { return false; }, [](const point& p) { return p; }, [&written](const point&) { ++written; });
+    BOOST_TEST_EQ(written, 0u);
+    BOOST_TEST_EQ(empty.read.records, 0u);
+    BOOST_TEST_EQ(empty.write.records_per_second(), 0.0);
+
+    // Text streams
+    std::istringstream text_in("{1, 2}\n{3, 4}\n{5, 6}\n");
+    std::ostringstream text_out;
+    boost::pfr::pipeline<point>(text_in, [](const point& p) { return point{p.y, p.x * 10}; }, text_out);
+    BOOST_TEST_EQ(text_out.str(), "{2, 10}\n{4, 30}\n{6, 50}\n");
+
+    // Malformed records are errors rather than the end of the input
+    std::istringstream broken_in("{1, 2}\n{3; 4}\n{5, 6}\n");
+    std::ostringstream broken_out;
+    BOOST_TEST_THROWS(
+        boost::pfr::pipeline<point>(broken_in, [](const point& p) { return p; }, broken_out),
+        std::runtime_error
+    );
+
+    // Errors of any stage stop the pipeline
+    BOOST_TEST(pipeline_throws(100000, [](const tick&) {}, 5000));
+    BOOST_TEST(pipeline_throws(100000, [](const tick& t) { if (t.instrument == 777) throw std::runtime_error("sink"); }, 0xFFFFFFFF));
+    BOOST_TEST(!pipeline_throws(1000, [](const tick&) {}, 0xFFFFFFFF));
+
+    std::uint32_t produced = 0;
+    bool source_throws = false;
+    try {
+        boost::pfr::pipeline<point>([&produced](point& p) {
+            if (++produced == 500) {
+                throw std::runtime_error("source");
+            }
+            p = point{1, 2};
+            return true;
+        }, [](const point& p) { return p; }, [](const point&) {});
+    } catch (const std::runtime_error&) {
+        source_throws = true;
+    }
+    BOOST_TEST(source_throws);
+
+#if !defined(_WIN32)
+    // Record files
+    const char* const raw_path = "pfr_pipeline_raw.bin";
+    const char* const ticks_path = "pfr_pipeline_ticks.bin";
+    {
+        boost::pfr::uring_record_writer<raw_tick> raw(raw_path);
+        counting_source source(20000);
+        for (raw_tick r; source(r);) {
+            raw.push(r);
+        }
+    }
+    {
+        boost::pfr::uring_record_reader<raw_tick> in(raw_path);
+        boost::pfr::uring_record_writer<tick> out(ticks_path);
+        boost::pfr::pipeline<raw_tick, tick>(in, to_tick, out);
+        out.close();
+        BOOST_TEST_EQ(out.size(), 20000u);
+    }
+    {
+        boost::pfr::uring_record_reader<tick> in(ticks_path);
+        std::uint32_t i = 0;
+        bool ordered = true;
+        for (tick t; in.pop(t); ++i) {
+            ordered = ordered && t.instrument == i;
+        }
+        BOOST_TEST_EQ(i, 20000u);
+        BOOST_TEST(ordered);
+    }
+    std::remove(raw_path);
+    std::remove(ticks_path);
+#endif
+
+    return boost::report_errors();
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/rolling.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+struct tick {
+    std::int64_t timestamp;
+    int price;
+    int volume;
+    long long turnover;
+    char flag;
+};
+
+std::vector<tick> make_ticks() {
+    std::vector<tick> ticks;
+    std::int64_t ts = 0;
+    for (int i = 0; i < 2000; ++i) {
+        ts += (i * 37) % 5;     // repeating and increasing timestamps
+        const int price = 1000 + (i * 7919) % 101 - 50;
+        ticks.push_back(tick{ts, price, (i * 31) % 17 + 1, static_cast<long long>(price) * 3, static_cast<char>('a' + i % 26)});
+    }
+    return ticks;
+}
+
+// Recomputes the aggregations over ticks [first, last) from scratch
+void check_snapshot(const tick& s, const std::vector<tick>& ticks, std::size_t first, std::size_t last) {
+    int min_price = ticks[first].price;
+    int max_volume = ticks[first].volume;
+    long long turnover = 0;
+    for (std::size_t i = first; i < last; ++i) {
+        min_price = (std::min)(min_price, ticks[i].price);
+        max_volume = (std::max)(max_volume, ticks[i].volume);
+        turnover += ticks[i].turnover;
+    }
+
+    BOOST_TEST_EQ(s.timestamp, ticks[last - 1].timestamp);
+    BOOST_TEST_EQ(s.price, min_price);
+    BOOST_TEST_EQ(s.volume, max_volume);
+    BOOST_TEST_EQ(s.turnover, turnover);
+    BOOST_TEST_EQ(s.flag, ticks[last - 1].flag);
+}
+
+void test_tick_window() {
+    const std::vector<tick> ticks = make_ticks();
+
+    for (std::size_t n : {1u, 2u, 10u, 100u}) {
+        boost::pfr::rolling<tick, boost::pfr::tick_window, boost::pfr::rolling_min<1>, boost::pfr::rolling_max<2>, boost::pfr::rolling_sum<3>>
+            r{{n}};
+        BOOST_TEST(r.empty());
+
+        for (std::size_t i = 0; i < ticks.size(); ++i) {
+            r.push(ticks[i]);
+            const std::size_t first = (i + 1 > n ? i + 1 - n : 0);
+            BOOST_TEST_EQ(r.size(), i + 1 - first);
+            check_snapshot(r.snapshot(), ticks, first, i + 1);
+        }
+
+        r.clear();
+        BOOST_TEST(r.empty());
+        r.push(ticks[5]);
+        check_snapshot(r.snapshot(), ticks, 5, 6);
+    }
+}
+
+void test_time_window() {
+    const std::vector<tick> ticks = make_ticks();
+
+    for (std::int64_t length : {1, 3, 50}) {
+        boost::pfr::rolling<tick, boost::pfr::time_window<0, std::int64_t>, boost::pfr::rolling_sum<3>, boost::pfr::rolling_min<1>, boost::pfr::rolling_max<2>>
+            r{{length}};
+
+        std::size_t first = 0;
+        for (std::size_t i = 0; i < ticks.size(); ++i) {
+            r.push(ticks[i]);
+            while (ticks[first].timestamp + length <= ticks[i].timestamp) {
+                ++first;
+            }
+            BOOST_TEST_EQ(r.size(), i + 1 - first);
+            check_snapshot(r.snapshot(), ticks, first, i + 1);
+        }
+    }
+}
+
+struct sample {
+    double value;
+    int id;
+};
+
+void test_mean() {
+    boost::pfr::rolling<sample, boost::pfr::tick_window, boost::pfr::rolling_mean<0>> r{{3}};
+
+    r.push(sample{1.0, 1});
+    BOOST_TEST_EQ(r.snapshot().value, 1.0);
+    r.push(sample{2.0, 2});
+    BOOST_TEST_EQ(r.snapshot().value, 1.5);
+    r.push(sample{6.0, 3});
+    BOOST_TEST_EQ(r.snapshot().value, 3.0);
+    r.push(sample{7.0, 4});
+    BOOST_TEST_EQ(r.snapshot().value, 5.0);
+    BOOST_TEST_EQ(r.snapshot().id, 4);
+}
+
+int main() {
+    test_tick_window();
+    test_time_window();
+    test_mean();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/precise/stable_hash.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Test vectors are XXH64 of the canonical encoding, they must not change between releases and platforms.
+// Encodings are listed as little endian 64 bit words, `"..."` are string bytes padded with zeros to 8 bytes.
+
+enum class color : std::uint8_t { red, blue, green };
+
+struct quote {
+    double price;
+    std::string symbol;
+};
+
+struct order {
+    std::int64_t timestamp;
+    quote q;
+    std::uint8_t flags;
+    short delta;
+};
+
+struct order_wide {     // same values in wider integer types
+    long long timestamp;
+    quote q;
+    unsigned flags;
+    std::int64_t delta;
+};
+
+int main() {
+    using boost::pfr::stable_hash;
+
+    // 0
+    BOOST_TEST_EQ(stable_hash(std::int32_t{0}), 0x34c96acdcadb1bbbull);
+    BOOST_TEST_EQ(stable_hash(std::uint64_t{0}), 0x34c96acdcadb1bbbull);
+    BOOST_TEST_EQ(stable_hash(false), 0x34c96acdcadb1bbbull);
+    BOOST_TEST_EQ(stable_hash(0.0), 0x34c96acdcadb1bbbull);
+    BOOST_TEST_EQ(stable_hash(-0.0), 0x34c96acdcadb1bbbull);
+    BOOST_TEST_EQ(stable_hash(std::string()), 0x34c96acdcadb1bbbull);
+
+    // 0xFFFFFFFFFFFFFFFF
+    BOOST_TEST_EQ(stable_hash(std::int8_t{-1}), 0x85d136adb773c6c9ull);
+    BOOST_TEST_EQ(stable_hash(std::int64_t{-1}), 0x85d136adb773c6c9ull);
+    BOOST_TEST_EQ(stable_hash((std::numeric_limits<std::uint64_t>::max)()), 0x85d136adb773c6c9ull);
+
+    // 65535
+    BOOST_TEST_EQ(stable_hash(std::uint16_t{65535}), 0xf0b963dbae8c736eull);
+
+    // 1
+    BOOST_TEST_EQ(stable_hash(true), 0x9f29cb17a2a49995ull);
+
+    // 65
+    BOOST_TEST_EQ(stable_hash('A'), 0xce764cf88f0ea6b8ull);
+
+    // 233, `char` is not sign extended even if it is signed on the platform
+    BOOST_TEST_EQ(stable_hash(static_cast<char>(0xE9)), stable_hash(static_cast<unsigned char>(0xE9)));
+    BOOST_TEST_EQ(stable_hash(static_cast<unsigned char>(0xE9)), 0x2245aaccef1d5e78ull);
+
+    // 2
+    BOOST_TEST_EQ(stable_hash(color::green), 0xeac73e4044e82db0ull);
+
+    // 0x3FF8000000000000
+    BOOST_TEST_EQ(stable_hash(1.5), 0x49f7b96b6b5ccaf9ull);
+    BOOST_TEST_EQ(stable_hash(1.5f), 0x49f7b96b6b5ccaf9ull);
+
+    // 0x7FF8000000000000
+    BOOST_TEST_EQ(stable_hash(std::numeric_limits<double>::quiet_NaN()), 0xe9adb09fee122aacull);
+    BOOST_TEST_EQ(stable_hash(-std::numeric_limits<float>::quiet_NaN()), 0xe9adb09fee122aacull);
+
+    // 12 "hello, world"
+    BOOST_TEST_EQ(stable_hash(std::string("hello, world")), 0xab785d520945de4bull);
+
+    // 33 "abcdefghijklmnopqrstuvwxyz0123456"
+    BOOST_TEST_EQ(stable_hash(std::string("abcdefghijklmnopqrstuvwxyz0123456")), 0x69238669735661d3ull);
+
+    // 3 1 2 3
+    const int array[3] = {1, 2, 3};
+    BOOST_TEST_EQ(stable_hash(array), 0xc6960f7869d1b997ull);
+    BOOST_TEST_EQ(stable_hash(std::array<std::uint8_t, 3>{{1, 2, 3}}), 0xc6960f7869d1b997ull);
+    BOOST_TEST_EQ(stable_hash(std::vector<long>{1, 2, 3}), 0xc6960f7869d1b997ull);
+
+    // 2 1 "a" 2 "bc"
+    BOOST_TEST_EQ(stable_hash(std::vector<std::string>{"a", "bc"}), 0x9961f89b4aad30b7ull);
+
+    // 1700000000000000000 0x40595000_00000000 4 "MSFT" 255 -7
+    const order o{1700000000000000000, {101.25, "MSFT"}, 0xFF, -7};
+    BOOST_TEST_EQ(stable_hash(o), 0x3c88f4b2d5fbeaf9ull);
+    BOOST_TEST_EQ(stable_hash(order_wide{1700000000000000000, {101.25, "MSFT"}, 0xFF, -7}), 0x3c88f4b2d5fbeaf9ull);
+
+    // Seeds
+    BOOST_TEST_EQ(stable_hash(0, 1), 0x22c76afd15f0110full);
+    BOOST_TEST_EQ(stable_hash(o, 0x9E3779B97F4A7C15ull), 0x17fbbbec4f80e99cull);
+
+    // Fields are not commutative
+    BOOST_TEST_NE(stable_hash(order{1, {2.0, "x"}, 3, 4}), stable_hash(order{1, {2.0, "x"}, 4, 3}));
+
+    return boost::report_errors();
+}
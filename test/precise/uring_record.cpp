@@ -0,0 +1,125 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/core/lightweight_test.hpp>
+
+#if !defined(_WIN32)
+
+#include <boost/pfr/precise/uring_record.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+struct tick {
+    std::uint32_t instrument;
+    double price;
+    std::int16_t qty;
+    char side;
+};
+
+tick make_tick(std::uint32_t i) {
+    return tick{i, i * 0.25, static_cast<std::int16_t>(i % 1000 - 500), (i % 2 ? 'B' : 'S')};
+}
+
+const char* const path = "pfr_uring_record_test.bin";
+
+std::uintmax_t file_size(const char* p) {
+    std::ifstream f(p, std::ios::binary | std::ios::ate);
+    return static_cast<std::uintmax_t>(f.tellg());
+}
+
+void test_round_trip(std::uint32_t count, std::size_t buffer_size, unsigned depth) {
+    static_assert(boost::pfr::detail::packed_record<tick>::size == 4 + 8 + 2 + 1, "");
+
+    {
+        boost::pfr::uring_record_writer<tick> out(path, buffer_size, depth);
+        for (std::uint32_t i = 0; i < count; ++i) {
+            out.push(make_tick(i));
+        }
+        BOOST_TEST_EQ(out.size(), count);
+        out.close();
+    }
+    BOOST_TEST_EQ(file_size(path), count * 15u);
+
+    boost::pfr::uring_record_reader<tick> in(path, buffer_size, depth);
+    tick t{};
+    std::uint32_t read = 0;
+    while (in.pop(t)) {
+        const tick expected = make_tick(read);
+        BOOST_TEST_EQ(t.instrument, expected.instrument);
+        BOOST_TEST_EQ(t.price, expected.price);
+        BOOST_TEST_EQ(t.qty, expected.qty);
+        BOOST_TEST_EQ(t.side, expected.side);
+        ++read;
+    }
+    BOOST_TEST_EQ(read, count);
+    BOOST_TEST(!in.pop(t));
+}
+
+void test_destructor_flushes() {
+    {
+        boost::pfr::uring_record_writer<tick> out(path, 100, 2);
+        for (std::uint32_t i = 0; i < 10; ++i) {
+            out.push(make_tick(i));
+        }
+    }
+
+    boost::pfr::uring_record_reader<tick> in(path);
+    tick t{};
+    std::uint32_t read = 0;
+    while (in.pop(t)) {
+        BOOST_TEST_EQ(t.instrument, read);
+        ++read;
+    }
+    BOOST_TEST_EQ(read, 10u);
+}
+
+void test_errors() {
+    bool thrown = false;
+    try {
+        boost::pfr::uring_record_reader<tick> in("pfr_uring_record_test_missing_dir/none.bin");
+    } catch (const std::system_error&) {
+        thrown = true;
+    }
+    BOOST_TEST(thrown);
+
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f.write("0123456789abcdef0123", 20);    // one record and a part of the next one
+    }
+    boost::pfr::uring_record_reader<tick> in(path);
+    tick t{};
+    thrown = false;
+    try {
+        while (in.pop(t)) {}
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    BOOST_TEST(thrown);
+}
+
+int main() {
+    test_round_trip(0, 4096, 3);
+    test_round_trip(1, 4096, 3);
+    test_round_trip(100000, 4096, 3);       // buffer of 273 records, the last one is partially filled
+    test_round_trip(273 * 8, 4096, 1);
+    test_round_trip(1000, 1, 4);            // one record per buffer
+    test_destructor_flushes();
+    test_errors();
+
+    std::remove(path);
+    return boost::report_errors();
+}
+
+#else // #if !defined(_WIN32)
+
+int main() {
+    return boost::report_errors();
+}
+
+#endif
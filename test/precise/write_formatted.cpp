@@ -0,0 +1,121 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/detail/config.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#if BOOST_PFR_USE_CPP17
+
+#include <boost/pfr/precise/write_formatted.hpp>
+
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+struct quote {
+    unsigned id;
+    double bid;
+    double ask;
+    std::string venue;
+};
+
+struct flags {
+    std::uint32_t mask;
+    int offset;
+    double ratio;
+    bool active;
+    char code;
+};
+
+struct point {
+    int x, y;
+};
+
+std::ostream& operator<<(std::ostream& os, const point& p) {
+    return os << '(' << p.x << ';' << p.y << ')';
+}
+
+struct with_point {
+    point p;
+    float f;
+};
+
+namespace fmt = boost::pfr::fmt;
+
+void test_string_sink() {
+    std::string s;
+    boost::pfr::write_formatted<fmt::dec<8, '0'>, fmt::fixed<4>, fmt::fixed<4>>(s, quote{42, 1.1, 1.10006, "LSE"});
+    BOOST_TEST_EQ(s, "{00000042, 1.1000, 1.1001, \"LSE\"}");
+
+    s.clear();
+    boost::pfr::write_formatted<fmt::hex<8>, fmt::dec<5, '0'>, fmt::scientific<2, 10>>(s, flags{0xbeef, -42, 12345.678, true, 'Z'});
+    BOOST_TEST_EQ(s, "{0000beef, -0042,   1.23e+04, 1, Z}");
+
+    s.clear();
+    boost::pfr::write_formatted<fmt::hex<>, fmt::dec<4>, fmt::fixed<0>>(s, flags{0, 7, 2.5, false, 'a'});
+    BOOST_TEST_EQ(s, "{0,    7, 2, 0, a}");
+
+    // bool is padded as a number
+    s.clear();
+    boost::pfr::write_formatted<fmt::as_is, fmt::as_is, fmt::as_is, fmt::dec<3>>(s, flags{1, 2, 0.5, true, 'b'});
+    BOOST_TEST_EQ(s, "{1, 2, 0.5,   1, b}");
+
+    s.clear();
+    boost::pfr::write_formatted<fmt::as_is, fmt::as_is, fmt::as_is, fmt::hex<2>>(s, flags{1, 2, 0.5, false, 'b'});
+    BOOST_TEST_EQ(s, "{1, 2, 0.5, 00, b}");
+
+    // Values wider than `Width` are not truncated
+    s.clear();
+    boost::pfr::write_formatted<fmt::dec<2>>(s, quote{123456, 0.5, 0.25, "say \"hi\""});
+    BOOST_TEST_EQ(s, "{123456, 0.5, 0.25, \"say \\\"hi\\\"\"}");
+
+    // Huge values in fixed notation
+    s.clear();
+    boost::pfr::write_formatted<fmt::as_is, fmt::fixed<1>>(s, quote{1, -1e300, 0, ""});
+    BOOST_TEST_EQ(s.size(), std::string("{1, -").size() + 301 + 2 + std::string(", 0, \"\"}").size());
+}
+
+void test_stream_sink() {
+    std::ostringstream ss;
+    ss << std::hex << std::setprecision(2) << std::showpos;
+    const auto flags_before = ss.flags();
+
+    boost::pfr::write_formatted<fmt::dec<>, fmt::fixed<3>>(ss, quote{255, 3.14159, 2.0, "X"});
+    BOOST_TEST_EQ(ss.str(), "{255, 3.142, 2, \"X\"}");
+    BOOST_TEST(ss.flags() == flags_before);
+
+    // Types without format specification use operator<< of the stream
+    std::ostringstream ss2;
+    boost::pfr::write_formatted(ss2, with_point{{1, -2}, 0.5f});
+    BOOST_TEST_EQ(ss2.str(), "{(1;-2), 0.5}");
+
+    std::string s;
+    boost::pfr::write_formatted(s, with_point{{3, 4}, 1.25f});
+    BOOST_TEST_EQ(s, "{(3;4), 1.25}");
+}
+
+void test_functor_sink() {
+    std::string s;
+    auto sink = [&s](const char* data, std::size_t size) { s.append(data, size); };
+    boost::pfr::write_formatted<fmt::dec<3, '*'>>(sink, point{7, 8});
+    BOOST_TEST_EQ(s, "{**7, 8}");
+}
+
+int main() {
+    test_string_sink();
+    test_stream_sink();
+    test_functor_sink();
+
+    return boost::report_errors();
+}
+
+#else // #if BOOST_PFR_USE_CPP17
+
+int main() {
+    return boost::report_errors();
+}
+
+#endif
@@ -0,0 +1,99 @@
+// Copyright (c) 2016-2017 Antony Polukhin
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/pfr/detail/config.hpp>
+#include <boost/core/lightweight_test.hpp>
+
+#if BOOST_PFR_USE_CPP17
+
+#include <boost/pfr/precise/write_openmetrics.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+enum class health : int { down = 0, up = 1 };
+
+struct latency {
+    std::uint64_t count;
+    double sum;
+};
+
+struct http_stats {
+    std::uint64_t requests;
+    latency get;
+    latency post;
+    std::string name;       // skipped
+    health state;
+    bool ready;
+    std::int32_t inflight;
+    float ratio;
+};
+
+struct wide {
+    char c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11;
+};
+
+int main() {
+    const http_stats stats{42, {40, 0.5}, {2, 1.25}, "server", health::up, true, -3, 0.1f};
+
+    std::string page;
+    boost::pfr::write_openmetrics(page, "http", stats, "instance=\"a\",zone=\"eu\"");
+    BOOST_TEST_EQ(page,
+        "http_0{instance=\"a\",zone=\"eu\"} 42\n"
+        "http_1_0{instance=\"a\",zone=\"eu\"} 40\n"
+        "http_1_1{instance=\"a\",zone=\"eu\"} 0.5\n"
+        "http_2_0{instance=\"a\",zone=\"eu\"} 2\n"
+        "http_2_1{instance=\"a\",zone=\"eu\"} 1.25\n"
+        "http_4{instance=\"a\",zone=\"eu\"} 1\n"
+        "http_5{instance=\"a\",zone=\"eu\"} 1\n"
+        "http_6{instance=\"a\",zone=\"eu\"} -3\n"
+        "http_7{instance=\"a\",zone=\"eu\"} 0.1\n"     // shortest form of the float, not of the double
+    );
+
+    // Appends, labels are optional
+    boost::pfr::write_openmetrics(page, "lat", latency{7, std::numeric_limits<double>::quiet_NaN()});
+    boost::pfr::write_openmetrics(page, "lat", latency{8, std::numeric_limits<double>::infinity()});
+    boost::pfr::write_openmetrics(page, "lat", latency{9, -std::numeric_limits<double>::infinity()});
+    BOOST_TEST_EQ(page.substr(page.find("lat_")),
+        "lat_0 7\nlat_1 NaN\n"
+        "lat_0 8\nlat_1 +Inf\n"
+        "lat_0 9\nlat_1 -Inf\n"
+    );
+
+    // Streams and functors get the same output, indexes with two digits
+    std::ostringstream ss;
+    boost::pfr::write_openmetrics(ss, "w", wide{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+    BOOST_TEST_EQ(ss.str().substr(ss.str().find("w_10")), "w_10 11\nw_11 12\n");
+
+    std::string from_functor;
+    std::size_t calls = 0;
+    auto sink = [&](const char* data, std::size_t size) {
+        ++calls;
+        from_functor.append(data, size);
+    };
+    for (int i = 0; i < 100; ++i) {
+        boost::pfr::write_openmetrics(sink, "http", stats, "instance=\"a\",zone=\"eu\"");
+    }
+    BOOST_TEST_EQ(from_functor.size(), 100 * page.find("lat_"));
+    BOOST_TEST_EQ(calls, 100u);     // one flush per call for short outputs
+
+    // Labels longer than the buffer
+    const std::string long_label = "l=\"" + std::string(3000, 'x') + "\"";
+    std::string long_page;
+    boost::pfr::write_openmetrics(long_page, "lat", latency{1, 2.0}, long_label);
+    BOOST_TEST_EQ(long_page, "lat_0{" + long_label + "} 1\nlat_1{" + long_label + "} 2\n");
+
+    return boost::report_errors();
+}
+
+#else
+
+int main() {
+    return boost::report_errors();
+}
+
+#endif